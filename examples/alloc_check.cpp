@@ -0,0 +1,501 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "../include/Methods/des_autoswitch.hpp"
+#include "../include/Methods/des_bdf.hpp"
+#include "../include/Methods/des_dopri54.hpp"
+#include "../include/Methods/des_dopri87.hpp"
+#include "../include/Methods/des_lowstorage.hpp"
+#include "../include/Methods/des_radau5.hpp"
+#include "../include/Methods/des_rossenbrock.hpp"
+#include "../include/Methods/des_tsit5.hpp"
+#include "../include/Methods/des_vern9.hpp"
+#include "../include/des_output.hpp"
+
+// ---------------------------------------------------------------------------
+// Allocation harness
+//
+// Replaces every form of the global operator new/delete with counting
+// versions.  Each scenario below lets the solver warm up for a number of
+// accepted steps, then counts every heap allocation until the solve
+// returns.  Any allocation in that window fails the run.
+//
+// Fixed-size Eigen types never touch the heap, so with
+// options.reserve_steps covering the whole run the accepted-step path of
+// solve() must be allocation-free.
+// ---------------------------------------------------------------------------
+
+namespace {
+
+std::atomic<bool> g_counting{false};
+std::atomic<long> g_allocations{0};
+
+}  // namespace
+
+void *operator new(std::size_t size)
+{
+    if (g_counting.load(std::memory_order_relaxed))
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void *p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t align)
+{
+    if (g_counting.load(std::memory_order_relaxed))
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    // aligned_alloc wants a size that is a multiple of the alignment
+    const auto a = static_cast<std::size_t>(align);
+    if (void *p = std::aligned_alloc(a, (std::max<std::size_t>(size, 1) + a - 1) / a * a))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// Every other form forwards to the two above, so each pointer is released
+// by the deallocation function that matches its allocation
+
+void *operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void *operator new[](std::size_t size, std::align_val_t align)
+{
+    return ::operator new(size, align);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t & /*tag*/) noexcept
+{
+    try
+    {
+        return ::operator new(size);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t & /*tag*/) noexcept
+{
+    return ::operator new(size, std::nothrow);
+}
+
+// GCC 12 inlines these into `delete` expressions and then reports the
+// free() of memory from operator new as -Wmismatched-new-delete, although
+// the replacement operator new above got it from malloc / aligned_alloc
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t /*align*/) noexcept
+{
+    std::free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+void operator delete(void *p, std::size_t /*size*/) noexcept
+{
+    ::operator delete(p);
+}
+
+void operator delete(void *p, std::size_t /*size*/, std::align_val_t align) noexcept
+{
+    ::operator delete(p, align);
+}
+
+void operator delete(void *p, const std::nothrow_t & /*tag*/) noexcept
+{
+    ::operator delete(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    ::operator delete(p);
+}
+
+void operator delete[](void *p, std::align_val_t align) noexcept
+{
+    ::operator delete(p, align);
+}
+
+void operator delete[](void *p, std::size_t /*size*/) noexcept
+{
+    ::operator delete(p);
+}
+
+void operator delete[](void *p, std::size_t /*size*/, std::align_val_t align) noexcept
+{
+    ::operator delete(p, align);
+}
+
+void operator delete[](void *p, const std::nothrow_t & /*tag*/) noexcept
+{
+    ::operator delete(p);
+}
+
+// ---------------------------------------------------------------------------
+// Systems
+// ---------------------------------------------------------------------------
+
+struct LorenzSystem {
+    double sigma = 10.0;
+    double rho = 28.0;
+    double beta = 8.0 / 3.0;
+
+    void operator()(double /*t*/, const DES::Vec<3> &y, DES::Vec<3> &dydt) const
+    {
+        dydt[0] = sigma * (y[1] - y[0]);
+        dydt[1] = y[0] * (rho - y[2]) - y[1];
+        dydt[2] = y[0] * y[1] - beta * y[2];
+    }
+};
+
+struct VanDerPol {
+    double mu = 10.0;
+
+    void operator()(double /*t*/, const DES::Vec<2> &y, DES::Vec<2> &dydt) const
+    {
+        dydt[0] = y[1];
+        dydt[1] = mu * (1.0 - y[0] * y[0]) * y[1] - y[0];
+    }
+};
+
+// Same system with the RHS templated over the state type, so Rosenbrock4
+// takes its Jacobian by forward-mode autodiff
+struct VanDerPolGeneric {
+    double mu = 10.0;
+
+    template <typename Vector>
+    void operator()(double /*t*/, const Vector &y, Vector &dydt) const
+    {
+        dydt[0] = y[1];
+        dydt[1] = mu * (1.0 - y[0] * y[0]) * y[1] - y[0];
+    }
+};
+
+// Method-of-lines reaction–diffusion on a 1-D grid: tridiagonal Jacobian
+struct ReactionDiffusion1D {
+    static constexpr int n = 32;
+    double d = 1.0e3;
+    double k = 5.0;
+
+    void operator()(double t, const DES::Vec<n> &y, DES::Vec<n> &dydt) const
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            const double left = (i > 0) ? y[i - 1] : std::sin(t);
+            const double right = (i < n - 1) ? y[i + 1] : 0.0;
+            dydt[i] = d * (left - 2.0 * y[i] + right) - k * y[i] * y[i] * y[i];
+        }
+    }
+
+    DES::Bandwidth jacobian_bandwidth() const
+    {
+        return {1, 1};
+    }
+};
+
+struct DelayedLogistic {
+    double r = 1.4;
+    double tau = 1.0;
+
+    void operator()(double t, const DES::Vec<1> &y, const DES::DelayHistoryView<1> &hist, DES::Vec<1> &dydt) const
+    {
+        dydt[0] = r * y[0] * (1.0 - hist(0, t - tau));
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Observer that switches counting on after `warmup` callbacks
+// ---------------------------------------------------------------------------
+
+struct WarmupObserver {
+    long warmup = 200;
+    long seen = 0;
+
+    template <typename State>
+    void operator()(double /*t*/, const State & /*y*/, const State & /*err*/)
+    {
+        if (++seen == warmup)
+        {
+            g_allocations.store(0, std::memory_order_relaxed);
+            g_counting.store(true, std::memory_order_relaxed);
+        }
+    }
+};
+
+template <typename Run>
+[[nodiscard]] bool check(const char *name, Run &&run)
+{
+    WarmupObserver obs;
+    const DES::SolveResult result = run(obs);
+    g_counting.store(false, std::memory_order_relaxed);
+
+    const long allocs = g_allocations.load(std::memory_order_relaxed);
+    const bool counted = obs.seen >= obs.warmup;
+    const bool pass = result.ok() && counted && allocs == 0;
+
+    std::cout << (pass ? "PASS " : "FAIL ") << name << ": " << obs.seen << " callbacks, " << allocs << " allocations after warm-up";
+    if (!result.ok())
+    {
+        std::cout << " (solve status " << static_cast<int>(result.status) << ')';
+    }
+    else if (!counted)
+    {
+        std::cout << " (run too short for warm-up)";
+    }
+    std::cout << '\n';
+    return pass;
+}
+
+// ---------------------------------------------------------------------------
+// main
+// ---------------------------------------------------------------------------
+
+int main()
+{
+    constexpr long reserve = 200'000;
+    bool ok = true;
+
+    ok &= check("DoPri54 Lorenz, step-wise output", [&](WarmupObserver &obs) {
+        DES::DoPri54<3> solver;
+        solver.options.rtol = 1.0e-8;
+        solver.options.atol = 1.0e-10;
+        solver.options.reserve_steps = reserve;
+        DES::Vec<3> y(1.0, 1.0, 1.0);
+        LorenzSystem sys;
+        return solver.solve(y, 0.0, 40.0, sys, obs);
+    });
+
+    ok &= check("DoPri54 Lorenz, uniform output + events", [&](WarmupObserver &obs) {
+        DES::DoPri54<3> solver;
+        solver.options.rtol = 1.0e-8;
+        solver.options.atol = 1.0e-10;
+        solver.options.reserve_steps = reserve;
+        solver.options.uniform_output = true;
+        solver.options.output_points = 20'000;
+
+        DES::DoPri54<3>::EventSpec crossing;
+        crossing.func = [](double /*t*/, const DES::Vec<3> &y) { return y[0]; };
+        crossing.terminal = false;
+        solver.options.events.push_back(crossing);
+
+        DES::Vec<3> y(1.0, 1.0, 1.0);
+        LorenzSystem sys;
+        return solver.solve(y, 0.0, 40.0, sys, obs);
+    });
+
+    ok &= check("DoPri54 Lorenz, ring-buffer sink", [&](WarmupObserver &obs) {
+        DES::RingSink<3> ring(512);
+        DES::DoPri54<3> solver;
+        solver.options.rtol = 1.0e-8;
+        solver.options.atol = 1.0e-10;
+        solver.options.reserve_steps = reserve;
+        solver.options.sink = &ring;
+        DES::Vec<3> y(1.0, 1.0, 1.0);
+        LorenzSystem sys;
+        return solver.solve(y, 0.0, 40.0, sys, obs);
+    });
+
+    ok &= check("Tsit5 Lorenz, uniform output", [&](WarmupObserver &obs) {
+        DES::Tsit5<3> solver;
+        solver.options.rtol = 1.0e-8;
+        solver.options.atol = 1.0e-10;
+        solver.options.reserve_steps = reserve;
+        solver.options.uniform_output = true;
+        solver.options.output_points = 20'000;
+        DES::Vec<3> y(1.0, 1.0, 1.0);
+        LorenzSystem sys;
+        return solver.solve(y, 0.0, 40.0, sys, obs);
+    });
+
+    ok &= check("LowStorage43 Lorenz, uniform output + events", [&](WarmupObserver &obs) {
+        DES::LowStorage43<3> solver;
+        solver.options.rtol = 1.0e-8;
+        solver.options.atol = 1.0e-10;
+        solver.options.reserve_steps = reserve;
+        solver.options.uniform_output = true;
+        solver.options.output_points = 20'000;
+
+        DES::LowStorage43<3>::EventSpec crossing;
+        crossing.func = [](double /*t*/, const DES::Vec<3> &y) { return y[0]; };
+        crossing.terminal = false;
+        solver.options.events.push_back(crossing);
+
+        DES::Vec<3> y(1.0, 1.0, 1.0);
+        LorenzSystem sys;
+        return solver.solve(y, 0.0, 40.0, sys, obs);
+    });
+
+    ok &= check("DoPri87 Lorenz", [&](WarmupObserver &obs) {
+        DES::DoPri87<3> solver;
+        solver.options.rtol = 1.0e-9;
+        solver.options.atol = 1.0e-11;
+        solver.options.reserve_steps = reserve;
+        DES::Vec<3> y(1.0, 1.0, 1.0);
+        LorenzSystem sys;
+        return solver.solve(y, 0.0, 40.0, sys, obs);
+    });
+
+    ok &= check("DoPri87 Lorenz, 7th-order dense uniform output + events", [&](WarmupObserver &obs) {
+        using Solver = DES::DoPri87<3, 500, DES::DenseMode::HighOrder>;
+        Solver solver;
+        solver.options.rtol = 1.0e-9;
+        solver.options.atol = 1.0e-11;
+        solver.options.reserve_steps = reserve;
+        solver.options.uniform_output = true;
+        solver.options.output_points = 20'000;
+
+        Solver::EventSpec crossing;
+        crossing.func = [](double /*t*/, const DES::Vec<3> &y) { return y[0]; };
+        crossing.terminal = false;
+        solver.options.events.push_back(crossing);
+
+        DES::Vec<3> y(1.0, 1.0, 1.0);
+        LorenzSystem sys;
+        return solver.solve(y, 0.0, 40.0, sys, obs);
+    });
+
+    ok &= check("Vern9 Lorenz, 9th-order dense uniform output + events", [&](WarmupObserver &obs) {
+        using Solver = DES::Vern9<3>;
+        Solver solver;
+        solver.options.rtol = 1.0e-11;
+        solver.options.atol = 1.0e-12;
+        solver.options.reserve_steps = reserve;
+        solver.options.uniform_output = true;
+        solver.options.output_points = 20'000;
+
+        Solver::EventSpec crossing;
+        crossing.func = [](double /*t*/, const DES::Vec<3> &y) { return y[0]; };
+        crossing.terminal = false;
+        solver.options.events.push_back(crossing);
+
+        DES::Vec<3> y(1.0, 1.0, 1.0);
+        LorenzSystem sys;
+        return solver.solve(y, 0.0, 40.0, sys, obs);
+    });
+
+    ok &= check("Rosenbrock4 van der Pol", [&](WarmupObserver &obs) {
+        DES::Rosenbrock4<2> solver;
+        solver.options.rtol = 1.0e-6;
+        solver.options.atol = 1.0e-8;
+        solver.options.h_init = 1.0e-4;
+        solver.options.reserve_steps = reserve;
+        DES::Vec<2> y(2.0, 0.0);
+        VanDerPol sys;
+        return solver.solve(y, 0.0, 20.0, sys, obs);
+    });
+
+    ok &= check("Rosenbrock4 van der Pol, Jacobian reuse (W-method)", [&](WarmupObserver &obs) {
+        DES::Rosenbrock4<2, 1000, DES::JacobianPolicy::Reuse> solver;
+        solver.options.rtol = 1.0e-6;
+        solver.options.atol = 1.0e-8;
+        solver.options.h_init = 1.0e-4;
+        solver.options.reserve_steps = reserve;
+        DES::Vec<2> y(2.0, 0.0);
+        VanDerPol sys;
+        return solver.solve(y, 0.0, 20.0, sys, obs);
+    });
+
+    ok &= check("Rosenbrock4 van der Pol, autodiff Jacobian", [&](WarmupObserver &obs) {
+        DES::Rosenbrock4<2> solver;
+        solver.options.rtol = 1.0e-6;
+        solver.options.atol = 1.0e-8;
+        solver.options.h_init = 1.0e-4;
+        solver.options.reserve_steps = reserve;
+        DES::Vec<2> y(2.0, 0.0);
+        VanDerPolGeneric sys;
+        return solver.solve(y, 0.0, 20.0, sys, obs);
+    });
+
+    ok &= check("Radau5 van der Pol", [&](WarmupObserver &obs) {
+        DES::Radau5<2> solver;
+        solver.options.rtol = 1.0e-6;
+        solver.options.atol = 1.0e-8;
+        solver.options.h_init = 1.0e-4;
+        solver.options.reserve_steps = reserve;
+        DES::Vec<2> y(2.0, 0.0);
+        VanDerPol sys;
+        return solver.solve(y, 0.0, 20.0, sys, obs);
+    });
+
+    ok &= check("BDF van der Pol", [&](WarmupObserver &obs) {
+        DES::BDF<2> solver;
+        solver.options.rtol = 1.0e-6;
+        solver.options.atol = 1.0e-8;
+        solver.options.h_init = 1.0e-4;
+        solver.options.reserve_steps = reserve;
+        DES::Vec<2> y(2.0, 0.0);
+        VanDerPol sys;
+        return solver.solve(y, 0.0, 20.0, sys, obs);
+    });
+
+    ok &= check("AutoSwitch van der Pol (mu = 1000), stiffness switching", [&](WarmupObserver &obs) {
+        DES::AutoSwitch<2> solver;
+        solver.options.rtol = 1.0e-6;
+        solver.options.atol = 1.0e-8;
+        solver.options.reserve_steps = reserve;
+        DES::Vec<2> y(2.0, 0.0);
+        VanDerPol sys;
+        sys.mu = 1000.0;
+        return solver.solve(y, 0.0, 3000.0, sys, obs);
+    });
+
+    ok &= check("Rosenbrock4 reaction-diffusion, banded Jacobian", [&](WarmupObserver &obs) {
+        DES::Rosenbrock4<ReactionDiffusion1D::n> solver;
+        solver.options.rtol = 1.0e-6;
+        solver.options.atol = 1.0e-8;
+        solver.options.h_init = 1.0e-4;
+        solver.options.reserve_steps = reserve;
+        DES::Vec<ReactionDiffusion1D::n> y = DES::Vec<ReactionDiffusion1D::n>::Zero();
+        ReactionDiffusion1D sys;
+        return solver.solve(y, 0.0, 60.0, sys, obs);
+    });
+
+    ok &= check("DoPri54 delayed logistic (DDE)", [&](WarmupObserver &obs) {
+        DES::DoPri54<1> solver;
+        solver.options.rtol = 1.0e-8;
+        solver.options.atol = 1.0e-10;
+        solver.options.h_max = 0.05;
+        solver.options.reserve_steps = reserve;
+
+        DelayedLogistic sys;
+        solver.options.min_delay = sys.tau;
+        solver.options.declared_delays = {sys.tau};
+
+        const std::vector<double> max_delays = {sys.tau};
+        const std::vector<double> init_conds = {0.5};
+        const std::vector<std::function<double(double)>> prehistory = {[](double /*t*/) { return 0.5; }};
+        DES::History<double, double> hist(1, 0.0, 0.0, max_delays, init_conds, prehistory);
+
+        DES::Vec<1> y(0.5);
+        return solver.solve(y, 0.0, 60.0, sys, hist, obs);
+    });
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,466 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/Methods/des_dopri54.hpp"
+#include "../include/des_batch.hpp"
+#include "../include/des_ensemble.hpp"
+#include "../include/des_vmath.hpp"
+
+// ---------------------------------------------------------------------------
+// Batch consistency check
+//
+// BatchDoPri54 must advance every lane exactly as a scalar DoPri54 with
+// the same options advances that trajectory on its own.  Each lane of a
+// parameter sweep is solved both ways and compared accepted step by
+// accepted step: the accepted and rejected step counts must match and
+// every accepted (t, y) must agree.  Both evaluate their stage sums in the
+// same order; tol leaves room for the last-ulp difference between Eigen's
+// packet pow in the lane controller and std::pow in the scalar one.
+//
+// The vmath check runs exp, log and pow over LaneArray<Lanes> blocks and
+// over one long run (whole SIMD packets plus a tail), and measures each
+// result against std:: on long double.  The error must stay within
+// eigen_ulp.  Where long double is no wider than double, the reference
+// itself may be off by 1 ULP and the bound widens by that much.
+//
+// The second half checks Ensemble::run: per-task results against
+// sequential solves, work stealing, an empty run and exception rethrow.
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr int Lanes = 4;
+constexpr double tol = 1.0e-10;
+constexpr double eigen_ulp = 2.0;
+
+// Van der Pol oscillator, one μ per lane
+struct VanDerPolBatch {
+    DES::LaneArray<Lanes> mu;
+
+    void operator()(const DES::LaneArray<Lanes> & /*t*/, const DES::BatchState<2, Lanes> &y, DES::BatchState<2, Lanes> &dydt) const
+    {
+        dydt.col(0) = y.col(1);
+        dydt.col(1) = mu * (1.0 - y.col(0).square()) * y.col(1) - y.col(0);
+    }
+};
+
+struct VanDerPol {
+    double mu = 1.0;
+
+    void operator()(double /*t*/, const DES::Vec<2> &y, DES::Vec<2> &dydt) const
+    {
+        dydt[0] = y[1];
+        dydt[1] = mu * (1.0 - y[0] * y[0]) * y[1] - y[0];
+    }
+};
+
+struct AcceptedPoint {
+    double t = 0.0;
+    DES::Vec<2> y = DES::Vec<2>::Zero();
+};
+
+[[nodiscard]] double rel_diff(double a, double b)
+{
+    return std::abs(a - b) / std::max(1.0, std::max(std::abs(a), std::abs(b)));
+}
+
+[[nodiscard]] bool report(const std::string &name, bool pass)
+{
+    std::cout << (pass ? "PASS " : "FAIL ") << name << '\n';
+    return pass;
+}
+
+// ---------------------------------------------------------------------------
+// BatchDoPri54 lanes against scalar DoPri54
+// ---------------------------------------------------------------------------
+
+[[nodiscard]] bool check_batch_lanes()
+{
+    const double t0 = 0.0;
+    const double t1 = 20.0;
+
+    VanDerPolBatch batch_sys;
+    batch_sys.mu << 0.5, 1.0, 3.0, 8.0;
+
+    DES::BatchState<2, Lanes> yb;
+    yb.col(0) << 2.0, 1.0, 0.5, 2.0;
+    yb.col(1) << 0.0, 0.5, -1.0, 0.0;
+    const DES::BatchState<2, Lanes> y0 = yb;
+
+    DES::BatchDoPri54<2, Lanes> batch;
+    batch.options.rtol = 1.0e-8;
+    batch.options.atol = 1.0e-10;
+
+    std::vector<std::vector<AcceptedPoint>> lane_steps(Lanes);
+    auto obs = [&](const DES::LaneArray<Lanes> &t, const DES::BatchState<2, Lanes> &y, const DES::LaneMask<Lanes> &accepted) {
+        for (int l = 0; l < Lanes; ++l)
+        {
+            if (accepted[l])
+            {
+                lane_steps[static_cast<std::size_t>(l)].push_back({t[l], DES::Vec<2>(y(l, 0), y(l, 1))});
+            }
+        }
+    };
+    const auto batch_res = batch.solve(yb, t0, t1, batch_sys, obs);
+
+    bool ok = true;
+    for (int l = 0; l < Lanes; ++l)
+    {
+        const auto lane = static_cast<std::size_t>(l);
+
+        DES::DoPri54<2> scalar;
+        scalar.options.rtol = batch.options.rtol;
+        scalar.options.atol = batch.options.atol;
+        scalar.options.controller = batch.options.controller;
+
+        VanDerPol sys;
+        sys.mu = batch_sys.mu[l];
+        DES::Vec<2> y(y0(l, 0), y0(l, 1));
+        const DES::SolveResult res = scalar.solve(y, t0, t1, sys);
+
+        // history() holds t0 followed by one point per accepted step
+        const auto &hist = scalar.history();
+        const std::vector<AcceptedPoint> &steps = lane_steps[lane];
+        const DES::SolverStats &bs = batch.lane_stats(l);
+
+        bool pass = res.ok() && batch_res[lane].ok() && bs.accepts == scalar.stats().accepts && bs.rejects == scalar.stats().rejects && steps.size() + 1 == hist.size();
+        double max_t = 0.0;
+        double max_y = 0.0;
+        for (std::size_t j = 0; pass && j < steps.size(); ++j)
+        {
+            const DES::Vec<2> ys = hist.state(j + 1);
+            max_t = std::max(max_t, rel_diff(steps[j].t, hist.t[j + 1]));
+            max_y = std::max({max_y, rel_diff(steps[j].y[0], ys[0]), rel_diff(steps[j].y[1], ys[1])});
+        }
+        pass = pass && max_t <= tol && max_y <= tol && rel_diff(yb(l, 0), y[0]) <= tol && rel_diff(yb(l, 1), y[1]) <= tol;
+
+        std::cout << (pass ? "PASS " : "FAIL ") << "BatchDoPri54 lane " << l << " (mu = " << sys.mu << ") vs DoPri54: " << bs.accepts << '/' << scalar.stats().accepts << " accepted, " << bs.rejects << '/' << scalar.stats().rejects << " rejected, max rel. diff t " << max_t << ", y " << max_y << '\n';
+        ok &= pass;
+    }
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// vmath against std:: on LaneArray blocks and a long run
+// ---------------------------------------------------------------------------
+
+// |y − ref| in units of the double spacing at ref
+[[nodiscard]] double ulp_error(double y, long double ref)
+{
+    const double r = static_cast<double>(ref);
+    if (std::isnan(y) || std::isnan(r))
+    {
+        return (std::isnan(y) && std::isnan(r)) ? 0.0 : std::numeric_limits<double>::infinity();
+    }
+    if (std::isinf(r))
+    {
+        return (y == r) ? 0.0 : std::numeric_limits<double>::infinity();
+    }
+    const long double ulp = static_cast<long double>(std::nextafter(std::abs(r), std::numeric_limits<double>::infinity())) - std::abs(r);
+    return static_cast<double>(std::abs(static_cast<long double>(y) - ref) / ulp);
+}
+
+// Points of [lo, hi] in a low-discrepancy order, so neighbouring lanes and
+// packet elements get unrelated arguments
+[[nodiscard]] std::vector<double> sweep(std::size_t n, double lo, double hi)
+{
+    std::vector<double> v(n);
+    double u = 0.5;
+    for (double &x : v)
+    {
+        u += 0.6180339887498949;
+        u -= std::floor(u);
+        x = lo + (hi - lo) * u;
+    }
+    return v;
+}
+
+struct UlpResult {
+    double worst = 0.0;
+    double at = 0.0;
+
+    void add(double err, double x)
+    {
+        if (!(err <= worst))
+        {
+            worst = err;
+            at = x;
+        }
+    }
+};
+
+[[nodiscard]] bool check_vmath_lanes()
+{
+    using Lane = DES::LaneArray<Lanes>;
+    constexpr std::size_t n = 4 * 257 + 3;  // whole packets at every width, and a tail
+    constexpr bool wide_reference = std::numeric_limits<long double>::digits > std::numeric_limits<double>::digits;
+    const double slack = wide_reference ? 0.0 : 1.0;
+    const double bound = eigen_ulp + slack;
+
+    const std::vector<double> xe = sweep(n, -700.0, 700.0);
+    std::vector<double> xl = sweep(n, -690.0, 690.0);
+    std::vector<double> xp = sweep(n, -16.0 * std::log(10.0), 4.0 * std::log(10.0));
+    const std::vector<double> ep = sweep(n, -3.0, 3.0);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        xl[i] = std::exp(xl[i]);
+        xp[i] = std::exp(xp[i]);
+    }
+    constexpr double e_ctl = -1.0 / 5.0;  // the lane controller's 1/(q + 1)
+
+    UlpResult exp_err, log_err, pow_err, pows_err;
+
+    // Lane blocks through the array overloads, as the batch RHS and controller call them
+    for (std::size_t b = 0; b + Lanes <= n; b += Lanes)
+    {
+        const Lane e = Eigen::Map<const Lane>(xe.data() + b);
+        const Lane l = Eigen::Map<const Lane>(xl.data() + b);
+        const Lane p = Eigen::Map<const Lane>(xp.data() + b);
+        const Lane q = Eigen::Map<const Lane>(ep.data() + b);
+
+        const Lane r_exp = DES::vmath::exp(e);
+        const Lane r_log = DES::vmath::log(l);
+        const Lane r_pow = DES::vmath::pow(p, q);
+        const Lane r_pows = DES::vmath::pow(p, e_ctl);
+        for (int j = 0; j < Lanes; ++j)
+        {
+            exp_err.add(ulp_error(r_exp[j], std::exp(static_cast<long double>(e[j]))), e[j]);
+            log_err.add(ulp_error(r_log[j], std::log(static_cast<long double>(l[j]))), l[j]);
+            pow_err.add(ulp_error(r_pow[j], std::pow(static_cast<long double>(p[j]), static_cast<long double>(q[j]))), p[j]);
+            pows_err.add(ulp_error(r_pows[j], std::pow(static_cast<long double>(p[j]), static_cast<long double>(e_ctl))), p[j]);
+        }
+    }
+
+    // One long run through the pointer kernels
+    std::vector<double> out(n);
+    DES::vmath::exp(xe.data(), out.data(), n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        exp_err.add(ulp_error(out[i], std::exp(static_cast<long double>(xe[i]))), xe[i]);
+    }
+    DES::vmath::log(xl.data(), out.data(), n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        log_err.add(ulp_error(out[i], std::log(static_cast<long double>(xl[i]))), xl[i]);
+    }
+    DES::vmath::pow(xp.data(), ep.data(), out.data(), n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        pow_err.add(ulp_error(out[i], std::pow(static_cast<long double>(xp[i]), static_cast<long double>(ep[i]))), xp[i]);
+    }
+    DES::vmath::pow(xp.data(), e_ctl, out.data(), n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        pows_err.add(ulp_error(out[i], std::pow(static_cast<long double>(xp[i]), static_cast<long double>(e_ctl))), xp[i]);
+    }
+
+    bool ok = true;
+    auto verdict = [&ok](const char *name, const UlpResult &r, double bound) {
+        std::ostringstream os;
+        os << "vmath " << name << " within " << bound << " ULP (max " << r.worst << " at " << r.at << ")";
+        ok &= report(os.str(), r.worst <= bound);
+    };
+    verdict("exp", exp_err, bound);
+    verdict("log", log_err, bound);
+    verdict("pow(x, e[i])", pow_err, bound);
+    verdict("pow(x, -1/5)", pows_err, bound);
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Ensemble::run
+// ---------------------------------------------------------------------------
+
+using Solver = DES::DoPri54<2>;
+
+[[nodiscard]] Solver ensemble_prototype()
+{
+    Solver proto;
+    proto.options.rtol = 1.0e-8;
+    proto.options.atol = 1.0e-10;
+    proto.options.save_history = false;
+    return proto;
+}
+
+[[nodiscard]] double task_mu(std::size_t i)
+{
+    return 0.5 + 0.25 * static_cast<double>(i);
+}
+
+// Every task result (status, counters, final state) must equal the same
+// solve run sequentially on a fresh solver, whichever worker ran it and
+// whatever that worker's solver held from earlier tasks
+[[nodiscard]] bool check_ensemble_results()
+{
+    constexpr std::size_t count = 24;
+    const Solver proto = ensemble_prototype();
+    DES::Ensemble<Solver> ens(proto, 3);
+
+    std::vector<DES::Vec<2>> y(count, DES::Vec<2>(2.0, 0.0));
+    const auto out = ens.run(count, [&](std::size_t i, Solver &s) {
+        VanDerPol sys;
+        sys.mu = task_mu(i);
+        return s.solve(y[i], 0.0, 20.0, sys);
+    });
+
+    bool pass = out.size() == count;
+    for (std::size_t i = 0; pass && i < count; ++i)
+    {
+        Solver s = proto;
+        VanDerPol sys;
+        sys.mu = task_mu(i);
+        DES::Vec<2> ys(2.0, 0.0);
+        const DES::SolveResult r = s.solve(ys, 0.0, 20.0, sys);
+
+        const DES::EnsembleResult &e = out[i];
+        pass = e.result.status == r.status && e.result.t_final == r.t_final && e.stats.accepts == s.stats().accepts && e.stats.rejects == s.stats().rejects && e.stats.rhs_evals == s.stats().rhs_evals && y[i] == ys;
+    }
+    return report("Ensemble::run per-task results match sequential DoPri54 (" + std::to_string(count) + " tasks, " + std::to_string(ens.workers()) + " workers)", pass);
+}
+
+// Two workers own [0, 4) and [4, 8).  Tasks 4–7 wait until task 0 has
+// started, so worker 1 cannot reach worker 0's range before worker 0 has
+// popped index 0.  Task 0 then holds worker 0 until tasks 1–3 are done,
+// which only happens if worker 1 steals them after draining [4, 8).  The
+// deadline only keeps a broken scheduler from hanging the check.
+[[nodiscard]] bool check_ensemble_stealing()
+{
+    constexpr std::size_t count = 8;
+    constexpr std::size_t half = count / 2;
+    DES::Ensemble<Solver> ens(ensemble_prototype(), 2);
+
+    std::vector<std::atomic<const Solver *>> ran_on(count);
+    for (auto &p : ran_on)
+    {
+        p.store(nullptr);
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    std::atomic<bool> started{false};
+    std::atomic<std::size_t> rest_done{0};
+    std::atomic<bool> timed_out{false};
+    const auto wait_for = [&](auto &&ready) {
+        while (!ready())
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                timed_out.store(true);
+                return;
+            }
+            std::this_thread::yield();
+        }
+    };
+
+    const auto out = ens.run(count, [&](std::size_t i, Solver &s) {
+        ran_on[i].store(&s);
+        if (i == 0)
+        {
+            started.store(true);
+            wait_for([&] { return rest_done.load() == half - 1; });
+        }
+        else if (i >= half)
+        {
+            wait_for([&] { return started.load(); });
+        }
+
+        VanDerPol sys;
+        sys.mu = task_mu(i);
+        DES::Vec<2> y(2.0, 0.0);
+        const DES::SolveResult r = s.solve(y, 0.0, 5.0, sys);
+        if (i > 0 && i < half)
+        {
+            ++rest_done;
+        }
+        return r;
+    });
+
+    bool pass = !timed_out.load();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        pass = pass && out[i].result.ok();
+        // Worker 1 ran its own range and every index it stole from worker 0
+        pass = pass && ran_on[i].load() != nullptr && (i == 0) == (ran_on[i].load() == ran_on[0].load());
+    }
+    return report("Ensemble::run work stealing: worker 1 took tasks from worker 0's range", pass);
+}
+
+[[nodiscard]] bool check_ensemble_empty()
+{
+    DES::Ensemble<Solver> ens(ensemble_prototype(), 2);
+    std::atomic<int> calls{0};
+    auto task = [&](std::size_t /*i*/, Solver & /*s*/) {
+        ++calls;
+        return DES::SolveResult{};
+    };
+
+    const auto out = ens.run(0, task);
+    std::vector<DES::EnsembleResult> buffer(5);
+    ens.run(0, task, buffer);
+
+    return report("Ensemble::run with count = 0 returns no results and runs no task", out.empty() && buffer.empty() && calls.load() == 0);
+}
+
+// The first exception thrown by a task is rethrown by run(), and the pool
+// stays usable afterwards
+[[nodiscard]] bool check_ensemble_exception()
+{
+    constexpr std::size_t count = 16;
+    DES::Ensemble<Solver> ens(ensemble_prototype(), 3);
+
+    bool rethrown = false;
+    try
+    {
+        (void)ens.run(count, [&](std::size_t i, Solver &s) {
+            if (i == 5)
+            {
+                throw std::runtime_error("task 5 failed");
+            }
+            VanDerPol sys;
+            sys.mu = task_mu(i);
+            DES::Vec<2> y(2.0, 0.0);
+            return s.solve(y, 0.0, 5.0, sys);
+        });
+    }
+    catch (const std::runtime_error &e)
+    {
+        rethrown = std::string(e.what()) == "task 5 failed";
+    }
+
+    const auto out = ens.run(count, [&](std::size_t i, Solver &s) {
+        VanDerPol sys;
+        sys.mu = task_mu(i);
+        DES::Vec<2> y(2.0, 0.0);
+        return s.solve(y, 0.0, 5.0, sys);
+    });
+    const bool reusable = out.size() == count && std::all_of(out.begin(), out.end(), [](const DES::EnsembleResult &e) { return e.result.ok(); });
+
+    return report("Ensemble::run rethrows a task exception and runs again afterwards", rethrown && reusable);
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// main
+// ---------------------------------------------------------------------------
+
+int main()
+{
+    bool ok = true;
+    ok &= check_batch_lanes();
+    ok &= check_vmath_lanes();
+    ok &= check_ensemble_results();
+    ok &= check_ensemble_stealing();
+    ok &= check_ensemble_empty();
+    ok &= check_ensemble_exception();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
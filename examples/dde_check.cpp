@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "../include/Methods/des_dopri54.hpp"
+#include "../include/Methods/des_radau5.hpp"
+#include "../include/history.hpp"
+
+// ---------------------------------------------------------------------------
+// DDE history check
+//
+// The first half drives DES::History directly.  Knots of y = sin t are
+// saved at irregular spacing, and after every save the window
+// [t − τ, t] is queried.  Eviction must keep the knot to the left of
+// t − τ, so every query interpolates between two stored knots and stays
+// within the Hermite cubic's error bound; a query past the oldest knot
+// would extrapolate.  The ring buffers must also stop growing once they
+// cover the window.
+//
+// The second half solves y'(t) = −y(t − 1), y = 1 on t ≤ 0, whose exact
+// solution is a piecewise polynomial (method of steps), with the default
+// initial step selection.  That path evaluates f(t₀, y₀) before the step
+// loop, which must still seed the history's slope at t₀: on [0, 1] the
+// solution is linear, so the stored history must reproduce it exactly.
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// ── History window ──────────────────────────────────────────────────────────
+
+[[nodiscard]] bool check_history_window()
+{
+    constexpr double tau = 1.0;
+    constexpr double t_end = 40.0;
+    const std::vector<double> spacing = {0.11, 0.37, 0.05, 0.23, 0.31, 0.07, 0.19};
+
+    DES::History<double, double> hist(1, 0.0, 0.0, {tau}, {std::sin(0.0)}, {[](double t) { return std::sin(t); }});
+    hist.set_initial_derivatives(std::vector<double>{std::cos(0.0)});
+
+    // Hermite cubic on [a, a + h]: |error| ≤ h⁴/384 · max|y⁗| = h⁴/384
+    const double h_max = *std::max_element(spacing.begin(), spacing.end());
+    const double bound = 1.5 * std::pow(h_max, 4) / 384.0;
+
+    double t = 0.0;
+    double worst = 0.0;
+    double worst_t = 0.0;
+    std::size_t knots_at_half = 0;
+    std::size_t knots = 0;
+    for (std::size_t step = 0; t < t_end; ++step)
+    {
+        t += spacing[step % spacing.size()];
+        hist.save(t, std::vector<double>{std::sin(t)}, std::vector<double>{std::cos(t)});
+
+        for (int j = 0; j <= 8; ++j)
+        {
+            const double q = t - tau + (tau * j) / 8.0;
+            if (q < 0.0)
+            {
+                continue;
+            }
+            const double e = std::abs(hist.at_time(q, 0) - std::sin(q));
+            if (e > worst)
+            {
+                worst = e;
+                worst_t = q;
+            }
+        }
+
+        knots = hist._history[0].size();
+        if (knots_at_half == 0 && t >= 0.5 * t_end)
+        {
+            knots_at_half = knots;
+        }
+    }
+
+    bool ok = true;
+    if (!(worst <= bound))
+    {
+        std::cerr << "history: error " << worst << " at t = " << worst_t << " exceeds the Hermite bound " << bound << '\n';
+        ok = false;
+    }
+    // The spacing repeats, so the window holds the same number of knots
+    // (± one at either end) in the second half as in the first
+    if (knots > knots_at_half + 2)
+    {
+        std::cerr << "history: " << knots << " knots held at t = " << t << ", " << knots_at_half << " halfway; the window keeps growing\n";
+        ok = false;
+    }
+
+    std::cout << "history window: max error " << worst << " (bound " << bound << "), " << knots << " knots held\n";
+    return ok;
+}
+
+// ── Method of steps ─────────────────────────────────────────────────────────
+
+// y'(t) = −y(t − 1)
+struct LinearDelay {
+    void operator()(double t, const DES::Vec<1> & /*y*/, const DES::DelayHistoryView<1> &hist, DES::Vec<1> &dydt) const
+    {
+        dydt[0] = -hist(0, t - 1.0);
+    }
+};
+
+// Exact solution for y = 1 on t ≤ 0, valid on [0, 3]
+[[nodiscard]] double linear_delay_exact(double t)
+{
+    double y = 1.0 - t;
+    if (t > 1.0)
+    {
+        y += (t - 1.0) * (t - 1.0) / 2.0;
+    }
+    if (t > 2.0)
+    {
+        y -= (t - 2.0) * (t - 2.0) * (t - 2.0) / 6.0;
+    }
+    return y;
+}
+
+template <typename Solver>
+void configure(Solver &solver)
+{
+    solver.options.rtol = 1.0e-10;
+    solver.options.atol = 1.0e-12;
+    solver.options.h_init = 0.0;  // choose_initial_step() evaluates f(t0, y0)
+    solver.options.h_max = 0.25;
+    solver.options.min_delay = 1.0;
+    solver.options.save_history = false;
+}
+
+// History on [0, 1] after a solve that stops inside it
+template <typename Solver>
+[[nodiscard]] bool check_initial_slope(const char *name)
+{
+    constexpr double t1 = 0.5;
+    constexpr double max_error = 1.0e-12;
+
+    Solver solver;
+    configure(solver);
+
+    LinearDelay rhs;
+    DES::History<double, double> hist(1, 0.0, 0.0, {1.0}, {1.0}, {[](double) { return 1.0; }});
+
+    DES::Vec<1> y;
+    y[0] = 1.0;
+    const auto result = solver.solve(y, 0.0, t1, rhs, hist);
+    if (!result.ok())
+    {
+        std::cerr << name << ": solve failed with status " << static_cast<int>(result.status) << '\n';
+        return false;
+    }
+
+    double worst = 0.0;
+    for (int j = 0; j <= 256; ++j)
+    {
+        const double q = (t1 * j) / 256.0;
+        worst = std::max(worst, std::abs(hist.at_time(q, 0) - linear_delay_exact(q)));
+    }
+    std::cout << name << ": history error on [0, " << t1 << "] " << worst << '\n';
+    if (!(worst <= max_error))
+    {
+        std::cerr << name << ": history error " << worst << " exceeds " << max_error << " (initial slope not seeded?)\n";
+        return false;
+    }
+    return true;
+}
+
+template <typename Solver>
+[[nodiscard]] bool check_method_of_steps(const char *name)
+{
+    constexpr double t1 = 3.0;
+    constexpr double max_error = 1.0e-8;
+
+    Solver solver;
+    configure(solver);
+
+    LinearDelay rhs;
+    DES::History<double, double> hist(1, 0.0, 0.0, {1.0}, {1.0}, {[](double) { return 1.0; }});
+
+    DES::Vec<1> y;
+    y[0] = 1.0;
+    const auto result = solver.solve(y, 0.0, t1, rhs, hist);
+    if (!result.ok())
+    {
+        std::cerr << name << ": solve failed with status " << static_cast<int>(result.status) << '\n';
+        return false;
+    }
+
+    const double err = std::abs(y[0] - linear_delay_exact(t1));
+    std::cout << name << ": y(3) = " << y[0] << ", error " << err << '\n';
+    if (!(err <= max_error))
+    {
+        std::cerr << name << ": error " << err << " exceeds " << max_error << '\n';
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main()
+{
+    bool ok = true;
+    ok &= check_history_window();
+    ok &= check_initial_slope<DES::DoPri54<1>>("DoPri54");
+    ok &= check_initial_slope<DES::Radau5<1>>("Radau5");
+    ok &= check_method_of_steps<DES::DoPri54<1>>("DoPri54");
+    ok &= check_method_of_steps<DES::Radau5<1>>("Radau5");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
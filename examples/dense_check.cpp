@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+#include "../include/Methods/des_dopri87.hpp"
+#include "../include/Methods/des_vern9.hpp"
+
+// ---------------------------------------------------------------------------
+// High-order dense output check
+//
+// The continuous extensions of DoPri87 (DenseMode::HighOrder) and Vern9 are
+// built from extra stages that only run when a dense query needs them.  The
+// first check refines every segment of two fixed-step solves, h and h/2, of
+// a problem with a known solution, and requires the interpolation error to
+// fall at the extension's order.
+//
+// The rest drives Vern9 on a Kepler orbit (e = 0.5, period 2π), the
+// orbit-propagation case it is meant for: an accepted step must cost 16
+// evaluations (FSAL), periapsis and apoapsis events must be located on the
+// 9th-order extension, and uniform output must follow the exact orbit from
+// Kepler's equation.
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// ── Interpolation order ─────────────────────────────────────────────────────
+
+// y₀' = −y₀², y₁' = cos t · y₁ with y(0) = (1, 1): y = (1/(1+t), e^{sin t})
+struct Riccati {
+    void operator()(double t, const DES::Vec<2> &y, DES::Vec<2> &dydt) const
+    {
+        dydt[0] = -y[0] * y[0];
+        dydt[1] = std::cos(t) * y[1];
+    }
+};
+
+// Max error of the refined dense output at nine points inside every step
+template <typename Solver>
+[[nodiscard]] double dense_error(double h)
+{
+    Solver solver;
+    solver.options.rtol = 1.0;  // never reject: every step has length h
+    solver.options.atol = 1.0;
+    solver.options.h_init = h;
+    solver.options.h_min = h;
+    solver.options.h_max = h;
+    solver.options.save_history = false;
+
+    Riccati sys;
+    DES::Vec<2> y(1.0, 1.0);
+    if (!solver.solve(y, 0.0, 4.0, sys).ok())
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    double worst = 0.0;
+    for (int i = 0; i < solver.dense_history_size(); ++i)
+    {
+        const auto &seg = solver.dense_segment(i);
+        for (int j = 1; j < 10; ++j)
+        {
+            const double t = seg.t0 + seg.h * j / 10.0;
+            const DES::Vec<2> v = solver.interpolate(t, sys);
+            worst = std::max({worst, std::abs(v[0] - 1.0 / (1.0 + t)), std::abs(v[1] - std::exp(std::sin(t)))});
+        }
+    }
+    return worst;
+}
+
+template <typename Solver>
+[[nodiscard]] bool check_interpolation_order(const char *name, double min_order)
+{
+    // Steps that divide [0, 4] exactly
+    const double e1 = dense_error<Solver>(0.5);
+    const double e2 = dense_error<Solver>(0.25);
+    const double order = std::log2(e1 / e2);
+
+    std::cout << name << ": dense error " << e1 << " (h = 0.5), " << e2 << " (h = 0.25), observed order " << order << '\n';
+    if (!(order >= min_order))
+    {
+        std::cerr << name << ": observed order " << order << " below " << min_order << '\n';
+        return false;
+    }
+    return true;
+}
+
+// ── Kepler orbit ────────────────────────────────────────────────────────────
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double ecc = 0.5;  // semi-major axis 1, μ = 1, period 2π
+
+// (x, y, vx, vy) about a unit point mass
+struct Kepler {
+    void operator()(double /*t*/, const DES::Vec<4> &s, DES::Vec<4> &ds) const
+    {
+        const double r2 = s[0] * s[0] + s[1] * s[1];
+        const double inv_r3 = 1.0 / (r2 * std::sqrt(r2));
+        ds[0] = s[2];
+        ds[1] = s[3];
+        ds[2] = -s[0] * inv_r3;
+        ds[3] = -s[1] * inv_r3;
+    }
+};
+
+// Periapsis at (1 − e, 0), moving in +y
+[[nodiscard]] DES::Vec<4> periapsis()
+{
+    return DES::Vec<4>(1.0 - ecc, 0.0, 0.0, std::sqrt((1.0 + ecc) / (1.0 - ecc)));
+}
+
+// Position at time t from Kepler's equation E − e sin E = t
+[[nodiscard]] DES::Vec<2> kepler_position(double t)
+{
+    double E = t;
+    for (int i = 0; i < 50; ++i)
+    {
+        const double dE = (E - ecc * std::sin(E) - t) / (1.0 - ecc * std::cos(E));
+        E -= dE;
+        if (std::abs(dE) < 1.0e-16)
+        {
+            break;
+        }
+    }
+    return DES::Vec<2>(std::cos(E) - ecc, std::sqrt(1.0 - ecc * ecc) * std::sin(E));
+}
+
+template <typename Solver>
+void configure(Solver &solver)
+{
+    solver.options.rtol = 1.0e-12;
+    solver.options.atol = 1.0e-12;
+    solver.options.h_max = 0.5;
+    solver.options.save_history = false;
+}
+
+[[nodiscard]] bool check_fsal_cost()
+{
+    DES::Vern9<4> solver;
+    configure(solver);
+    solver.options.h_init = 1.0e-2;  // no initial step selection
+
+    Kepler sys;
+    DES::Vec<4> s = periapsis();
+    if (!solver.solve(s, 0.0, 2.0 * kPi, sys).ok())
+    {
+        std::cerr << "Vern9 FSAL: solve failed\n";
+        return false;
+    }
+
+    // AdaptiveDES evaluates f(t, y) again after a rejected step
+    const auto &st = solver.stats();
+    const long expected = 1 + 16 * st.accepts + 17 * st.rejects;
+    std::cout << "Vern9 FSAL: " << st.rhs_evals << " evaluations for " << st.accepts << " accepted and " << st.rejects << " rejected steps\n";
+    if (st.rhs_evals != expected)
+    {
+        std::cerr << "Vern9 FSAL: expected " << expected << " evaluations (16 per accepted step)\n";
+        return false;
+    }
+    return true;
+}
+
+// Apoapsis (r·v falls through 0) at t = π, then periapsis (rising) at 2π
+[[nodiscard]] bool check_apsis_events()
+{
+    constexpr double max_error = 1.0e-9;
+
+    using Solver = DES::Vern9<4>;
+    Solver solver;
+    configure(solver);
+
+    Solver::EventSpec apoapsis;
+    apoapsis.func = [](double /*t*/, const DES::Vec<4> &s) { return s[0] * s[2] + s[1] * s[3]; };
+    apoapsis.direction = -1;
+    apoapsis.location_tol = 1.0e-12;
+    solver.options.events.push_back(apoapsis);
+
+    Solver::EventSpec periapsis_pass = apoapsis;
+    periapsis_pass.direction = +1;
+    periapsis_pass.terminal = true;
+    solver.options.events.push_back(periapsis_pass);
+
+    Kepler sys;
+    DES::Vec<4> s = periapsis();
+    const auto result = solver.solve(s, 0.0, 3.0 * kPi, sys);
+    if (result.status != DES::SolveStatus::EventTriggered || result.event_index != 1)
+    {
+        std::cerr << "Vern9 events: expected the periapsis event, got status " << static_cast<int>(result.status) << '\n';
+        return false;
+    }
+
+    const double t_err = std::abs(result.t_final - 2.0 * kPi);
+    const double s_err = (s - periapsis()).cwiseAbs().maxCoeff();
+    std::cout << "Vern9 events: periapsis at t = 2π " << (result.t_final >= 2.0 * kPi ? "+ " : "- ") << t_err << ", state error " << s_err << ", " << solver.stats().events_triggered << " events\n";
+
+    bool ok = true;
+    if (!(t_err <= max_error) || !(s_err <= max_error))
+    {
+        std::cerr << "Vern9 events: periapsis error exceeds " << max_error << '\n';
+        ok = false;
+    }
+    if (solver.stats().events_triggered != 2)
+    {
+        std::cerr << "Vern9 events: expected the apoapsis and periapsis events\n";
+        ok = false;
+    }
+    return ok;
+}
+
+[[nodiscard]] bool check_uniform_output()
+{
+    constexpr double max_error = 1.0e-10;
+
+    DES::Vern9<4> solver;
+    configure(solver);
+    solver.options.save_history = true;
+    solver.options.uniform_output = true;
+    solver.options.output_points = 1000;
+
+    Kepler sys;
+    DES::Vec<4> s = periapsis();
+    if (!solver.solve(s, 0.0, 2.0 * kPi, sys).ok())
+    {
+        std::cerr << "Vern9 uniform output: solve failed\n";
+        return false;
+    }
+
+    const auto &hist = solver.history();
+    double worst = 0.0;
+    for (std::size_t j = 0; j < hist.size(); ++j)
+    {
+        const DES::Vec<4> v = hist.state(j);
+        const DES::Vec<2> r = kepler_position(hist.t[j]);
+        worst = std::max({worst, std::abs(v[0] - r[0]), std::abs(v[1] - r[1])});
+    }
+
+    std::cout << "Vern9 uniform output: " << hist.size() << " points, max position error " << worst << '\n';
+    if (!(worst <= max_error))
+    {
+        std::cerr << "Vern9 uniform output: error exceeds " << max_error << '\n';
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main()
+{
+    bool ok = true;
+    ok &= check_interpolation_order<DES::DoPri87<2, 500, DES::DenseMode::HighOrder>>("DoPri87 HighOrder", 6.0);
+    ok &= check_interpolation_order<DES::Vern9<2>>("Vern9", 8.5);
+    ok &= check_fsal_cost();
+    ok &= check_apsis_events();
+    ok &= check_uniform_output();
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,10 +1,9 @@
 #include <cstdlib>
 #include <filesystem>
-#include <fstream>
-#include <iomanip>
 #include <iostream>
 
 #include "../include/Methods/des_dopri54.hpp"
+#include "../include/des_trajectory_io.hpp"
 
 #ifndef DES_PROJECT_SOURCE_DIR
 #define DES_PROJECT_SOURCE_DIR "."
@@ -28,30 +27,71 @@ struct LorenzSystem {
 };
 
 // ---------------------------------------------------------------------------
-// Write the solver history to a CSV file.
-// Returns false and prints a message on I/O failure.
+// Forwards every batch to two sinks, so one solve fills both the file and
+// an in-memory copy
+// ---------------------------------------------------------------------------
+
+template <int N>
+class TeeSink : public DES::OutputSink<N> {
+  public:
+    TeeSink(DES::OutputSink<N> &a, DES::OutputSink<N> &b)
+        : m_a(&a)
+        , m_b(&b)
+    {}
+
+    void begin(Eigen::Index dim) override
+    {
+        m_a->begin(dim);
+        m_b->begin(dim);
+    }
+    void consume(const DES::OutputBatch<N> &batch) override
+    {
+        m_a->consume(batch);
+        m_b->consume(batch);
+    }
+    void end() override
+    {
+        m_a->end();
+        m_b->end();
+    }
+
+  private:
+    DES::OutputSink<N> *m_a;
+    DES::OutputSink<N> *m_b;
+};
+
+// ---------------------------------------------------------------------------
+// Compare the columns of a written .destraj file with the points the same
+// solve recorded in memory.  Returns false and prints the first mismatch.
 // ---------------------------------------------------------------------------
 
 template <typename History>
-[[nodiscard]] bool write_csv(const std::filesystem::path &path, const History &history)
+[[nodiscard]] bool matches_history(const DES::TrajectoryReader &reader, const History &history)
 {
-    std::ofstream file(path);
-    if (!file.is_open())
+    const std::size_t count = history.size();
+    if (reader.size() != count || reader.dim() != 3)
     {
-        std::cerr << "error: could not open output file: " << path << '\n';
+        std::cerr << "trajectory has " << reader.size() << " rows of dimension " << reader.dim() << ", memory has " << count << " of dimension 3\n";
         return false;
     }
 
-    file << std::fixed << std::setprecision(10);
-    file << "t,y0,y1,y2,error_norm,h\n";
-
-    const auto count = history.t.size();
+    const DES::TrajectoryColumn t = reader.t();
+    const DES::TrajectoryColumn h = reader.h();
+    const DES::TrajectoryColumn err = reader.error();
     for (std::size_t i = 0; i < count; ++i)
     {
-        file << history.t[i] << ',' << history.y[i][0] << ',' << history.y[i][1] << ',' << history.y[i][2] << ',' << history.error[i] << ',' << history.h[i] << '\n';
+        bool same = t[i] == history.t[i] && h[i] == history.h[i] && err[i] == history.error[i];
+        for (std::size_t c = 0; c < 3; ++c)
+        {
+            same = same && reader.y(c)[i] == history.y[i][static_cast<Eigen::Index>(c)];
+        }
+        if (!same)
+        {
+            std::cerr << "trajectory row " << i << " (t = " << t[i] << ") differs from the in-memory copy\n";
+            return false;
+        }
     }
-
-    return file.good();
+    return true;
 }
 
 // ---------------------------------------------------------------------------
@@ -76,17 +116,24 @@ int main()
     solver.options.output_points = 10000;
 
     // Initial conditions
-    State y;
-    y[0] = 1.0;
-    y[1] = 1.0;
-    y[2] = 1.0;
+    const State y0(1.0, 1.0, 1.0);
 
     LorenzSystem rhs;
 
-    // Integrate
     constexpr double t0 = 0.0;
     constexpr double t1 = 100.0;
 
+    // Integrate, streaming the recorded points to a .destraj file and to
+    // memory
+    const fs::path data_dir = fs::path(DES_PROJECT_SOURCE_DIR) / "examples" / "data";
+    fs::create_directories(data_dir);
+    const fs::path traj_path = data_dir / "lorenz.destraj";
+
+    State y = y0;
+    DES::TrajectoryFileSink<3> sink(traj_path.string());
+    DES::VectorSink<3> memory;
+    TeeSink<3> tee(sink, memory);
+    solver.options.sink = &tee;
     const auto result = solver.solve(y, t0, t1, rhs);
 
     if (!result.ok())
@@ -95,26 +142,22 @@ int main()
         return EXIT_FAILURE;
     }
 
-    const auto count = solver.history_size();
-    if (count != solver.options.output_points)
+    const auto count = sink.size();
+    if (count != static_cast<std::size_t>(solver.options.output_points))
     {
         std::cerr << "expected " << solver.options.output_points << " output points, got " << count << '\n';
         return EXIT_FAILURE;
     }
 
-    // Write output
-    const fs::path data_dir = fs::path(DES_PROJECT_SOURCE_DIR) / "examples" / "data";
-    fs::create_directories(data_dir);
-
-    const fs::path csv_path = data_dir / "lorenz.csv";
-    if (!write_csv(csv_path, solver.history()))
+    // The file must hold exactly the points kept in memory
+    if (!matches_history(DES::TrajectoryReader(traj_path.string()), memory))
     {
         return EXIT_FAILURE;
     }
 
     // Summary
     const auto &st = solver.stats();
-    std::cout << "wrote csv to:  " << fs::absolute(csv_path) << '\n'
+    std::cout << "wrote file to: " << fs::absolute(traj_path) << '\n'
               << "stored points: " << count << '\n'
               << "final state:   x=" << y[0] << "  y=" << y[1] << "  z=" << y[2] << '\n'
               << "accepted:      " << st.accepts << '\n'
@@ -0,0 +1,156 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "../include/Methods/des_radau5.hpp"
+
+// ---------------------------------------------------------------------------
+// Robertson stiff kinetics problem, solved with Radau5
+//
+//   y1' = -0.04 y1 + 1e4 y2 y3
+//   y2' =  0.04 y1 - 1e4 y2 y3 - 3e7 y2^2
+//   y3' =  3e7 y2^2
+//
+// Integrated over the classic long range t ∈ [0, 1e11], where the step size
+// grows by ten orders of magnitude, and checked against reference values:
+//
+//   t = 1e11  F. Mazzia, C. Magherini, Test Set for IVP Solvers, problem
+//             ROBER (reference solution at t_end)
+//   t = 40    Radau5 and BDF at rtol = 1e-12, atol = 1e-20, which agree
+//             with each other to 1e-11
+//
+// The error is measured in units of the requested tolerance,
+// |y − y_ref| / (atol + rtol |y_ref|); the example fails above max_error.
+//
+// The problem is solved twice: with an analytical jacobian() and with the
+// default finite-difference Jacobian, which must reach the same accuracy
+// without stalling.
+// ---------------------------------------------------------------------------
+
+struct RobertsonSystem {
+    void operator()(double /*t*/, const DES::Vec<3> &y, DES::Vec<3> &dydt) const
+    {
+        const double y1 = y[0];
+        const double y2 = y[1];
+        const double y3 = y[2];
+
+        dydt[0] = -0.04 * y1 + 1.0e4 * y2 * y3;
+        dydt[1] = 0.04 * y1 - 1.0e4 * y2 * y3 - 3.0e7 * y2 * y2;
+        dydt[2] = 3.0e7 * y2 * y2;
+    }
+};
+
+struct RobertsonWithJacobian : RobertsonSystem {
+    void jacobian(double /*t*/, const DES::Vec<3> &y, Eigen::Matrix<double, 3, 3> &J) const
+    {
+        const double y2 = y[1];
+        const double y3 = y[2];
+
+        J(0, 0) = -0.04;
+        J(0, 1) = 1.0e4 * y3;
+        J(0, 2) = 1.0e4 * y2;
+
+        J(1, 0) = 0.04;
+        J(1, 1) = -1.0e4 * y3 - 6.0e7 * y2;
+        J(1, 2) = -1.0e4 * y2;
+
+        J(2, 0) = 0.0;
+        J(2, 1) = 6.0e7 * y2;
+        J(2, 2) = 0.0;
+    }
+};
+
+// Largest component error in units of atol + rtol |y_ref|
+[[nodiscard]] double tolerance_units(const DES::Vec<3> &y, const DES::Vec<3> &ref, double rtol, double atol)
+{
+    return ((y - ref).array().abs() / (atol + rtol * ref.array().abs())).maxCoeff();
+}
+
+// ---------------------------------------------------------------------------
+// Solve over both checkpoints; false if a solve fails or an error is above
+// max_error
+// ---------------------------------------------------------------------------
+
+template <typename System>
+[[nodiscard]] bool run(const char *label, System &rhs)
+{
+    using Solver = DES::Radau5<3>;
+    using State = DES::Vec<3>;
+
+    constexpr double max_error = 10.0;
+
+    struct Checkpoint {
+        double t;
+        State y_ref;
+    };
+    const Checkpoint checkpoints[] = {
+        {40.0, State(7.158270687e-01, 9.185534765e-06, 2.841637457e-01)},
+        {1.0e11, State(2.083340149701255e-08, 8.333360770334713e-14, 9.999999791665050e-01)},
+    };
+
+    Solver solver;
+    solver.options.rtol = 1.0e-8;
+    solver.options.atol = 1.0e-14;  // y2 falls to 1e-13
+    solver.options.h_init = 1.0e-6;
+    solver.options.h_max = 1.0e10;
+    solver.options.save_history = false;
+
+    State y(1.0, 0.0, 0.0);
+
+    bool ok = true;
+    long accepted = 0;
+    long rejected = 0;
+    long newton_failures = 0;
+    long rhs_evals = 0;
+    long jacobians = 0;
+    long lu = 0;
+
+    std::cout << label << '\n';
+    double t0 = 0.0;
+    for (const Checkpoint &cp : checkpoints)
+    {
+        const auto result = solver.solve(y, t0, cp.t, rhs);
+        const auto &st = solver.stats();
+        if (!result.ok())
+        {
+            std::cerr << label << ": solve failed with status " << static_cast<int>(result.status) << " at t=" << result.t_final << " after " << st.steps << " steps"
+                      << " (accepted=" << st.accepts << ", rejected=" << st.rejects << ", newton failures=" << st.newton_failures << ")\n";
+            return false;
+        }
+        accepted += st.accepts;
+        rejected += st.rejects;
+        newton_failures += st.newton_failures;
+        rhs_evals += st.rhs_evals;
+        jacobians += st.jacobian_evals;
+        lu += st.lu_decompositions;
+
+        const double err = tolerance_units(y, cp.y_ref, solver.options.rtol, solver.options.atol);
+        ok &= err <= max_error;
+        std::cout << "  t = " << cp.t << ":  y1=" << y[0] << "  y2=" << y[1] << "  y3=" << y[2] << "  error " << err << " tolerance units" << (err <= max_error ? "" : "  (too large)") << '\n';
+        t0 = cp.t;
+    }
+
+    std::cout << "  mass sum:        " << (y[0] + y[1] + y[2]) << '\n'
+              << "  accepted:        " << accepted << '\n'
+              << "  rejected:        " << rejected << '\n'
+              << "  newton failures: " << newton_failures << '\n'
+              << "  rhs evals:       " << rhs_evals << '\n'
+              << "  Jacobians:       " << jacobians << '\n'
+              << "  LU decomps:      " << lu << '\n';
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// main
+// ---------------------------------------------------------------------------
+
+int main()
+{
+    RobertsonWithJacobian analytic;
+    RobertsonSystem finite_differences;
+
+    bool ok = true;
+    ok &= run("analytical Jacobian", analytic);
+    ok &= run("finite-difference Jacobian", finite_differences);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,94 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "../include/Methods/des_autoswitch.hpp"
+
+// ---------------------------------------------------------------------------
+// Van der Pol oscillator with μ = 1000, solved with AutoSwitch
+//
+//   x' = v
+//   v' = μ (1 − x²) v − x
+//
+// The relaxation oscillation alternates slow stiff drifts along the branches
+// |x| > 1 with fast jumps between them, so AutoSwitch should hand the
+// integration to Rosenbrock4 on the drifts and back to DoPri54 for the
+// jumps.
+//
+// Reference: F. Mazzia, C. Magherini, Test Set for IVP Solvers, problem
+// VDPOL (ε = 1e-6, τ ∈ [0, 2]).  With t = μτ and v = y2 / μ that is this
+// system on [0, 2000], so
+//
+//   x(2000) = 1.706167732170483,   v(2000) = −0.8928097010247975e-3
+//
+// The error is measured in units of the requested tolerance,
+// |y − y_ref| / (atol + rtol |y_ref|); the example fails above max_error.
+// ---------------------------------------------------------------------------
+
+struct VanDerPol {
+    double mu = 1000.0;
+
+    void operator()(double /*t*/, const DES::Vec<2> &y, DES::Vec<2> &dydt) const
+    {
+        dydt[0] = y[1];
+        dydt[1] = mu * (1.0 - y[0] * y[0]) * y[1] - y[0];
+    }
+
+    void jacobian(double /*t*/, const DES::Vec<2> &y, Eigen::Matrix<double, 2, 2> &J) const
+    {
+        J(0, 0) = 0.0;
+        J(0, 1) = 1.0;
+        J(1, 0) = -2.0 * mu * y[0] * y[1] - 1.0;
+        J(1, 1) = mu * (1.0 - y[0] * y[0]);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// main
+// ---------------------------------------------------------------------------
+
+int main()
+{
+    using Solver = DES::AutoSwitch<2>;
+    using State = DES::Vec<2>;
+
+    constexpr double max_error = 10.0;
+    const State y_ref(1.706167732170483, -0.8928097010247975e-3);
+
+    VanDerPol rhs;
+
+    Solver solver;
+    solver.options.rtol = 1.0e-8;
+    solver.options.atol = 1.0e-8;
+    solver.options.h_max = 100.0;
+    solver.options.save_history = false;
+    solver.stiff_solver().autonomous = true;  // no explicit t: skip the ∂f/∂t difference
+
+    State y(2.0, 0.0);
+
+    constexpr double t0 = 0.0;
+    constexpr double t1 = 2000.0;
+
+    const auto result = solver.solve(y, t0, t1, rhs);
+    const auto &st = solver.stats();
+
+    if (!result.ok())
+    {
+        std::cerr << "solve failed with status " << static_cast<int>(result.status) << " at t=" << result.t_final << " after " << st.steps << " steps"
+                  << " (accepted=" << st.accepts << ", rejected=" << st.rejects << ", rhs evals=" << st.rhs_evals << ")\n";
+        return EXIT_FAILURE;
+    }
+
+    const double err = ((y - y_ref).array().abs() / (solver.options.atol + solver.options.rtol * y_ref.array().abs())).maxCoeff();
+    const bool ok = err <= max_error && st.method_switches > 0;
+
+    std::cout << "t = " << t1 << ":  x=" << y[0] << "  v=" << y[1] << "  error " << err << " tolerance units" << (err <= max_error ? "" : "  (too large)") << '\n'
+              << "switches:      " << st.method_switches << (st.method_switches > 0 ? "" : "  (expected at least one)") << '\n'
+              << "stiff steps:   " << st.stiff_steps << '\n'
+              << "accepted:      " << st.accepts << '\n'
+              << "rejected:      " << st.rejects << '\n'
+              << "rhs evals:     " << st.rhs_evals << '\n'
+              << "Jacobians:     " << st.jacobian_evals << '\n';
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
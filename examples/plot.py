@@ -4,6 +4,7 @@ import csv
 from pathlib import Path
 
 import matplotlib.pyplot as plt
+import numpy as np
 
 
 ROOT = Path(__file__).resolve().parent
@@ -27,6 +28,66 @@ def read_csv(path: Path) -> dict[str, list[float]]:
     return data
 
 
+# Header of the binary columnar format written by DES::TrajectoryFileSink
+# (include/des_trajectory_io.hpp).  Columns follow the 64-byte header as
+# contiguous float64 blocks of `capacity` entries: t, h, error, y0, y1, ...
+# Everything is in the writer's byte order, which the byte_order field
+# records.
+TRAJECTORY_MAGIC = b"DESTRAJ\0"
+TRAJECTORY_VERSION = 2
+TRAJECTORY_BYTE_ORDER_MARK = 0x0102030405060708
+TRAJECTORY_BYTE_ORDER_OFFSET = 48
+
+
+def trajectory_header_dtype(order: str) -> np.dtype:
+    return np.dtype(
+        [
+            ("magic", "S8"),
+            ("version", order + "u4"),
+            ("header_bytes", order + "u4"),
+            ("dim", order + "u8"),
+            ("columns", order + "u8"),
+            ("count", order + "u8"),
+            ("capacity", order + "u8"),
+            ("byte_order", order + "u8"),
+            ("reserved", order + "u8"),
+        ]
+    )
+
+
+def trajectory_byte_order(path: Path) -> str:
+    """numpy byte-order prefix ("<" or ">") of a .destraj file."""
+    with path.open("rb") as f:
+        raw = f.read(TRAJECTORY_BYTE_ORDER_OFFSET + 8)
+    if len(raw) < TRAJECTORY_BYTE_ORDER_OFFSET + 8 or raw[:8] != TRAJECTORY_MAGIC:
+        raise ValueError(f"{path} is not a DES trajectory file")
+    mark = raw[TRAJECTORY_BYTE_ORDER_OFFSET:]
+    if mark == TRAJECTORY_BYTE_ORDER_MARK.to_bytes(8, "little"):
+        return "<"
+    if mark == TRAJECTORY_BYTE_ORDER_MARK.to_bytes(8, "big"):
+        return ">"
+    raise ValueError(f"{path} has an unknown byte-order mark")
+
+
+def read_trajectory(path: Path) -> dict[str, np.ndarray]:
+    """Open a .destraj file; every column is a zero-copy numpy.memmap view."""
+    order = trajectory_byte_order(path)
+    header = np.fromfile(path, dtype=trajectory_header_dtype(order), count=1)[0]
+    if int(header["version"]) != TRAJECTORY_VERSION:
+        raise ValueError(f"{path} has unsupported trajectory version {int(header['version'])}")
+
+    count = int(header["count"])
+    columns = int(header["columns"])
+    capacity = int(header["capacity"])
+    data = {"t": np.empty(0), "h": np.empty(0), "error_norm": np.empty(0)}
+    if capacity == 0:
+        return data
+
+    table = np.memmap(path, dtype=order + "f8", mode="r", offset=int(header["header_bytes"]), shape=(columns, capacity))
+    names = ["t", "h", "error_norm"] + [f"y{i}" for i in range(columns - 3)]
+    return {name: table[i, :count] for i, name in enumerate(names)}
+
+
 def state_columns(data: dict[str, list[float]]) -> list[str]:
     excluded = {"t", "error_norm", "h"}
     return [name for name in data if name not in excluded]
@@ -65,7 +126,7 @@ def plot_error(csv_file: Path, data: dict[str, list[float]]) -> None:
     t = data["t"]
     err = data["error_norm"]
 
-    if not err:
+    if len(err) == 0:
         return
 
     fig = plt.figure(figsize=(8, 5))
@@ -92,7 +153,7 @@ def plot_stepsize(csv_file: Path, data: dict[str, list[float]]) -> None:
     t = data["t"]
     h = data["h"]
 
-    if not h:
+    if len(h) == 0:
         return
 
     fig = plt.figure(figsize=(8, 5))
@@ -138,16 +199,43 @@ def plot_3d_if_possible(csv_file: Path, data: dict[str, list[float]]) -> None:
     print(f"Saved {out_path}")
 
 
+def plot_work_precision(csv_file: Path, data: dict[str, list[float]]) -> None:
+    """Error against RHS evaluations for every `<method>_error` / `<method>_rhs` column pair."""
+    methods = [name[: -len("_error")] for name in data if name.endswith("_error") and f"{name[: -len('_error')]}_rhs" in data]
+    if not methods:
+        return
+
+    fig = plt.figure(figsize=(8, 5))
+    ax = fig.add_subplot(111)
+    for method in methods:
+        ax.loglog(data[f"{method}_rhs"], data[f"{method}_error"], marker="o", label=method)
+
+    ax.set_xlabel("RHS evaluations")
+    ax.set_ylabel("max-norm error at t_end")
+    ax.set_title(f"{csv_file.stem}")
+    ax.grid(True, which="both")
+    ax.legend()
+    fig.tight_layout()
+
+    out_path = PLOT_DIR / f"{csv_file.stem}.png"
+    fig.savefig(out_path, dpi=200)
+    plt.close(fig)
+    print(f"Saved {out_path}")
+
+
 def main() -> None:
     PLOT_DIR.mkdir(parents=True, exist_ok=True)
 
-    csv_files = sorted(DATA_DIR.glob("*.csv"))
+    csv_files = sorted(DATA_DIR.glob("*.csv")) + sorted(DATA_DIR.glob("*.destraj"))
     if not csv_files:
-        print(f"No CSV files found in {DATA_DIR}")
+        print(f"No CSV or trajectory files found in {DATA_DIR}")
         return
 
     for csv_file in csv_files:
-        data = read_csv(csv_file)
+        data = read_trajectory(csv_file) if csv_file.suffix == ".destraj" else read_csv(csv_file)
+        if "tol" in data:
+            plot_work_precision(csv_file, data)
+            continue
         if "t" not in data:
             print(f"Skipping {csv_file.name}: missing t column")
             continue
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "../include/Methods/des_dopri54.hpp"
+#include "../include/Methods/des_dopri87.hpp"
+#include "../include/Methods/des_tsit5.hpp"
+#include "../include/Methods/des_vern9.hpp"
+
+#ifndef DES_PROJECT_SOURCE_DIR
+#define DES_PROJECT_SOURCE_DIR "."
+#endif
+
+// ---------------------------------------------------------------------------
+// Work-precision comparison of the explicit pairs on the Lorenz system.
+//
+// Each solver runs at rtol = atol = 10^-3 … 10^-12 over t ∈ [0, 10].  The
+// error is the max-norm distance of y(10) from a DoPri87 reference at
+// 10^-15; work is counted in RHS evaluations and wall time (best of
+// `repeats` runs).  Rounding errors grow by ~e^9 over the interval, so
+// neither the reference nor any solver resolves y(10) below ~10^-12.
+// Results go to stdout and to examples/data/work_precision_lorenz.csv
+// (plotted by plot.py).
+// ---------------------------------------------------------------------------
+
+struct LorenzSystem {
+    double sigma = 10.0;
+    double rho = 28.0;
+    double beta = 8.0 / 3.0;
+
+    void operator()(double /*t*/, const DES::Vec<3> &y, DES::Vec<3> &dydt) const
+    {
+        dydt[0] = sigma * (y[1] - y[0]);
+        dydt[1] = y[0] * (rho - y[2]) - y[1];
+        dydt[2] = y[0] * y[1] - beta * y[2];
+    }
+};
+
+struct Point {
+    double error = 0.0;
+    long rhs_evals = 0;
+    double micros = 0.0;
+};
+
+constexpr double t_end = 10.0;
+constexpr int repeats = 5;
+
+// ---------------------------------------------------------------------------
+// One solver at one tolerance
+// ---------------------------------------------------------------------------
+
+template <typename Solver>
+[[nodiscard]] Point run(double tol, const DES::Vec<3> &reference)
+{
+    Point out;
+    out.micros = std::numeric_limits<double>::infinity();
+
+    for (int r = 0; r < repeats; ++r)
+    {
+        Solver solver;
+        solver.options.rtol = tol;
+        solver.options.atol = tol;
+        solver.options.save_history = false;
+        solver.options.dense_retention.kind = DES::DenseRetention::Kind::None;
+
+        DES::Vec<3> y(1.0, 1.0, 1.0);
+        LorenzSystem rhs;
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto result = solver.solve(y, 0.0, t_end, rhs);
+        const auto stop = std::chrono::steady_clock::now();
+
+        if (!result.ok())
+        {
+            std::cerr << "solve failed at tol " << tol << " with status " << static_cast<int>(result.status) << '\n';
+            std::exit(EXIT_FAILURE);
+        }
+
+        out.error = (y - reference).cwiseAbs().maxCoeff();
+        out.rhs_evals = solver.stats().rhs_evals;
+        out.micros = std::min(out.micros, std::chrono::duration<double, std::micro>(stop - start).count());
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// main
+// ---------------------------------------------------------------------------
+
+int main()
+{
+    namespace fs = std::filesystem;
+
+    // Reference solution
+    DES::Vec<3> reference(1.0, 1.0, 1.0);
+    {
+        DES::DoPri87<3> solver;
+        solver.options.rtol = 1.0e-15;
+        solver.options.atol = 1.0e-15;
+        solver.options.save_history = false;
+        LorenzSystem rhs;
+        if (!solver.solve(reference, 0.0, t_end, rhs).ok())
+        {
+            std::cerr << "reference solve failed\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<double> tolerances;
+    for (int e = 3; e <= 12; ++e)
+    {
+        tolerances.push_back(std::pow(10.0, -e));
+    }
+
+    const fs::path data_dir = fs::path(DES_PROJECT_SOURCE_DIR) / "examples" / "data";
+    fs::create_directories(data_dir);
+    const fs::path csv_path = data_dir / "work_precision_lorenz.csv";
+
+    std::ofstream file(csv_path);
+    if (!file.is_open())
+    {
+        std::cerr << "error: could not open output file: " << csv_path << '\n';
+        return EXIT_FAILURE;
+    }
+    file << std::setprecision(10);
+    file << "tol,dopri54_error,dopri54_rhs,dopri54_us,tsit5_error,tsit5_rhs,tsit5_us,dopri87_error,dopri87_rhs,dopri87_us,vern9_error,vern9_rhs,vern9_us\n";
+
+    std::cout << std::scientific << std::setprecision(2);
+    std::cout << "   tol   |        DoPri54 err / rhs / us      |         Tsit5 err / rhs / us       |        DoPri87 err / rhs / us      |         Vern9 err / rhs / us\n";
+
+    for (const double tol : tolerances)
+    {
+        const Point a = run<DES::DoPri54<3>>(tol, reference);
+        const Point b = run<DES::Tsit5<3>>(tol, reference);
+        const Point c = run<DES::DoPri87<3>>(tol, reference);
+        const Point d = run<DES::Vern9<3>>(tol, reference);
+
+        file << tol << ',' << a.error << ',' << a.rhs_evals << ',' << a.micros << ',' << b.error << ',' << b.rhs_evals << ',' << b.micros << ',' << c.error << ',' << c.rhs_evals << ',' << c.micros << ',' << d.error << ',' << d.rhs_evals << ',' << d.micros << '\n';
+
+        std::cout << tol;
+        for (const Point &p : {a, b, c, d})
+        {
+            std::cout << " | " << p.error << ' ' << std::setw(7) << p.rhs_evals << ' ' << std::fixed << std::setprecision(1) << std::setw(8) << p.micros << std::scientific << std::setprecision(2);
+        }
+        std::cout << '\n';
+    }
+
+    if (!file.good())
+    {
+        return EXIT_FAILURE;
+    }
+    std::cout << "wrote csv to:  " << fs::absolute(csv_path) << '\n';
+    return EXIT_SUCCESS;
+}
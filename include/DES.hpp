@@ -2,6 +2,9 @@
 
 // DES — Differential Equation Solver.  Eigen backend, C++17.
 // Requires Eigen 3.3+.
+//
+// N is either a compile-time dimension or Eigen::Dynamic.  Dynamic solvers
+// size every state-sized buffer once per solve, from the initial state.
 
 #include <Eigen/Dense>
 #include <algorithm>
@@ -10,16 +13,22 @@
 #include <limits>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace DES {
 
 // ---------------------------------------------------------------------------
-// Primary vector type: Eigen fixed-size column vector
+// Primary vector type: Eigen column vector (fixed-size or Eigen::Dynamic)
 // ---------------------------------------------------------------------------
 
 template <int N>
 using Vec = Eigen::Matrix<double, N, 1>;
 
+// Per-component scalar options (e.g. atol_vec): std::array for fixed N,
+// std::vector sized by the caller for N = Eigen::Dynamic
+template <int N>
+using ComponentArray = std::conditional_t<N == Eigen::Dynamic, std::vector<double>, std::array<double, static_cast<std::size_t>(N == Eigen::Dynamic ? 0 : N)>>;
+
 // ---------------------------------------------------------------------------
 // Enumerations
 // ---------------------------------------------------------------------------
@@ -34,6 +43,12 @@ enum class ControllerKind {
     Gustafsson
 };
 
+// Storage of recorded states in OutputHistory
+enum class HistoryLayout {
+    AoS,  // y[j] is the j-th state vector
+    SoA   // components[i] is the i-th component over all points
+};
+
 enum class SolveStatus {
     // ── Normal termination ────────────────────────────────────────────────
     Success,
@@ -54,16 +69,111 @@ enum class SolveStatus {
     BreakingPointFailure,  // bisection for breaking-point location failed
 };
 
+// ---------------------------------------------------------------------------
+// ColumnView — contiguous read-only run of doubles (one recorded series)
+// ---------------------------------------------------------------------------
+
+struct ColumnView {
+    const double *data = nullptr;
+    std::size_t size = 0;
+
+    [[nodiscard]] double operator[](std::size_t i) const noexcept
+    {
+        return data[i];
+    }
+    [[nodiscard]] const double *begin() const noexcept
+    {
+        return data;
+    }
+    [[nodiscard]] const double *end() const noexcept
+    {
+        return data + size;
+    }
+};
+
 // ---------------------------------------------------------------------------
 // Workspace — scratch arrays for Runge–Kutta stage evaluations
 // ---------------------------------------------------------------------------
 
 template <int N, int MaxStages = 16>
 struct Workspace {
+    static constexpr int registers = MaxStages + 4;
+
     std::array<Vec<N>, MaxStages> k{};
     Vec<N> next{};
     Vec<N> error{};
-    Vec<N> fsal{};  // first-same-as-last endpoint, reused as k[0] next step
+    Vec<N> fsal{};   // first-same-as-last endpoint, reused as k[0] next step
+    Vec<N> stage{};  // stage argument y + h·Σ aᵢⱼ kⱼ handed to the RHS
+
+    // Register holding f(t+h, y_{n+1}) after an FSAL step
+    [[nodiscard]] Vec<N> &endpoint_rhs() noexcept
+    {
+        return fsal;
+    }
+
+    // Size every register for an n-dimensional state (no-op for fixed N)
+    void resize(Eigen::Index n)
+    {
+        for (auto &v : k)
+        {
+            v.resize(n);
+        }
+        next.resize(n);
+        error.resize(n);
+        fsal.resize(n);
+        stage.resize(n);
+    }
+
+    void set_zero()
+    {
+        for (auto &v : k)
+        {
+            v.setZero();
+        }
+        next.setZero();
+        error.setZero();
+        fsal.setZero();
+        stage.setZero();
+    }
+};
+
+// ---------------------------------------------------------------------------
+// LowStorageWorkspace — the four registers of a 2R low-storage step
+//
+// k[0] is the only derivative register: it enters a step as f(t, y), takes
+// every later stage derivative and ends the step as f(t+h, y_{n+1}), which
+// is the FSAL value of the next step.  There is no separate fsal copy.
+// ---------------------------------------------------------------------------
+
+template <int N>
+struct LowStorageWorkspace {
+    static constexpr int registers = 4;
+
+    std::array<Vec<N>, 1> k{};
+    Vec<N> next{};
+    Vec<N> error{};
+    Vec<N> stage{};
+
+    [[nodiscard]] Vec<N> &endpoint_rhs() noexcept
+    {
+        return k[0];
+    }
+
+    void resize(Eigen::Index n)
+    {
+        k[0].resize(n);
+        next.resize(n);
+        error.resize(n);
+        stage.resize(n);
+    }
+
+    void set_zero()
+    {
+        k[0].setZero();
+        next.setZero();
+        error.setZero();
+        stage.setZero();
+    }
 };
 
 // ---------------------------------------------------------------------------
@@ -81,6 +191,14 @@ struct SolverStats {
     long breaking_points_crossed = 0;  // enforced mesh points crossed
     long events_triggered = 0;         // sign-changes detected (all events)
     long bisection_iters = 0;          // total bisection iterations
+
+    long jacobian_evals = 0;      // J = ∂f/∂y evaluations (implicit solvers)
+    long lu_decompositions = 0;   // LU factorizations of the iteration matrix
+    long newton_iters = 0;        // simplified-Newton iterations (Radau5, BDF)
+    long newton_failures = 0;     // steps rejected for Newton divergence
+
+    long method_switches = 0;     // non-stiff ↔ stiff hand-overs (AutoSwitch)
+    long stiff_steps = 0;         // accepted steps taken by the stiff method
 };
 
 // ---------------------------------------------------------------------------
@@ -103,6 +221,22 @@ struct SolveResult {
     }
 };
 
+// ---------------------------------------------------------------------------
+// MemoryUsage — bytes held by a solver's retained data (capacity, not size)
+// ---------------------------------------------------------------------------
+
+struct MemoryUsage {
+    std::size_t workspace = 0;       // Workspace registers (k[], next, error, fsal, stage)
+    std::size_t dense_history = 0;   // retained DenseSegments
+    std::size_t output_history = 0;  // OutputHistory plus the sink batch
+    std::size_t delay_history = 0;   // DDE History ring buffers, if given
+
+    [[nodiscard]] std::size_t total() const noexcept
+    {
+        return workspace + dense_history + output_history + delay_history;
+    }
+};
+
 // ---------------------------------------------------------------------------
 // ControllerState — persistent data for multi-step error controllers
 // ---------------------------------------------------------------------------
@@ -144,18 +278,26 @@ struct StepController {
         }
 
         const double inv_q = 1.0 / static_cast<double>(adaptive_order + 1);
-        double factor = safety * std::pow(error_norm, -inv_q);
+        double factor = 0.0;
 
+        // Only the powers the active controller uses are evaluated: two for
+        // PI (which replaces the elementary factor), one or two otherwise.
+        // std::pow, not vmath: two scalars do not fill a packet, and a
+        // 2-wide Eigen pow is no faster (propose_lanes batches the lanes)
         if (kind == ControllerKind::PI && state.has_prev_error)
         {
             const double a = (alpha >= 0.0) ? alpha : 0.7 * inv_q;
             const double b = (beta >= 0.0) ? beta : 0.4 * inv_q;
             factor = safety * std::pow(error_norm, -a) * std::pow(std::max(state.prev_error, 1.0e-16), b);
         }
-        else if (kind == ControllerKind::Gustafsson && accepted && !state.previous_rejected && state.has_accepted_reference && state.accepted_h > 0.0)
+        else
         {
-            const double gust = safety * (h_abs / state.accepted_h) * std::pow(std::max(state.accepted_error, 1.0e-16) / std::max(error_norm * error_norm, 1.0e-32), inv_q);
-            factor = std::min(factor, gust);
+            factor = safety * std::pow(error_norm, -inv_q);
+            if (kind == ControllerKind::Gustafsson && accepted && !state.previous_rejected && state.has_accepted_reference && state.accepted_h > 0.0)
+            {
+                const double gust = safety * (h_abs / state.accepted_h) * std::pow(std::max(state.accepted_error, 1.0e-16) / std::max(error_norm * error_norm, 1.0e-32), inv_q);
+                factor = std::min(factor, gust);
+            }
         }
 
         if (!accepted || state.previous_rejected)
@@ -195,4 +337,41 @@ struct HasLastDenseStep : std::false_type {};
 template <typename T>
 struct HasLastDenseStep<T, std::void_t<decltype(std::declval<const T &>().last_dense_step())>> : std::true_type {};
 
+// Multistep solvers choose their own step size (and order): AdaptiveDES
+// asks Derived::next_step_size(err_norm, accepted, h_abs) instead of the
+// StepController when present
+template <typename T, typename = void>
+struct HasNextStepSize : std::false_type {};
+template <typename T>
+struct HasNextStepSize<T, std::void_t<decltype(std::declval<T &>().next_step_size(0.0, true, 0.0))>> : std::true_type {};
+
+// Implicit solvers whose nonlinear iteration failed report it through
+// step_failure(): 0 when the step was computed, otherwise the factor by
+// which AdaptiveDES shrinks h before retrying (no error norm is formed)
+template <typename T, typename = void>
+struct HasStepFailure : std::false_type {};
+template <typename T>
+struct HasStepFailure<T, std::void_t<decltype(std::declval<const T &>().step_failure())>> : std::true_type {};
+
+// Solvers that keep a factorization tied to h may hold the step size
+// after an accepted step: AdaptiveDES passes the controller's proposal
+// through Derived::hold_step_size(next_h, h_abs) when present
+template <typename T, typename = void>
+struct HasHoldStepSize : std::false_type {};
+template <typename T>
+struct HasHoldStepSize<T, std::void_t<decltype(std::declval<const T &>().hold_step_size(0.0, 0.0))>> : std::true_type {};
+
+// Solvers whose compute_step() already reduced the scaled error norm (in
+// the same pass that wrote ws.error) report it through step_error_norm();
+// AdaptiveDES then skips its own scaled_error() pass
+template <typename T, typename = void>
+struct HasStepErrorNorm : std::false_type {};
+template <typename T>
+struct HasStepErrorNorm<T, std::void_t<decltype(std::declval<const T &>().step_error_norm())>> : std::true_type {};
+
+template <typename T, typename = void>
+struct HasDenseHistory : std::false_type {};
+template <typename T>
+struct HasDenseHistory<T, std::void_t<decltype(std::declval<const T &>().dense_history().memory_bytes())>> : std::true_type {};
+
 }  // namespace DES
\ No newline at end of file
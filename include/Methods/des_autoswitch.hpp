@@ -0,0 +1,436 @@
+#pragma once
+
+/*  des_autoswitch.hpp  –  DES namespace
+ *
+ *  AutoSwitch — DoPri54 with automatic stiffness detection, handing the
+ *  integration over to Rosenbrock4 while the problem is stiff and back once
+ *  it is not (in the spirit of LSODA).
+ *
+ *  References
+ *  ──────────
+ *  • E. Hairer, G. Wanner.
+ *    Solving Ordinary Differential Equations II — Stiff and
+ *    Differential-Algebraic Problems.
+ *    2nd ed., Springer, 1996, §IV.2 (stiffness detection for DOPRI5).
+ *
+ *  • L. R. Petzold.
+ *    Automatic selection of methods for solving stiff and nonstiff systems
+ *    of ordinary differential equations.
+ *    SIAM J. Sci. Stat. Comput. 4 (1983) 136–148.
+ *
+ *  • B. P. Sommeijer, L. F. Shampine, J. G. Verwer.
+ *    RKC: An explicit solver for parabolic PDEs.
+ *    J. Comput. Appl. Math. 88 (1998) 315–326 (nonlinear power method).
+ *
+ *  Stiffness detection
+ *  ───────────────────
+ *  Non-stiff → stiff.  DoPri54 evaluates stages 6 and 7 at the same time
+ *  t + h, at Y₆ and at y_{n+1}, so
+ *
+ *      ρ ≈ ‖k₇ − k₆‖ / ‖y_{n+1} − Y₆‖
+ *
+ *  estimates the dominant eigenvalue |λ| of J at no extra cost.  DoPri54's
+ *  stability region reaches ≈ −3.3 on the real axis; an accepted step with
+ *  h·ρ > stiff_threshold was limited by stability, not accuracy.  After
+ *  switch_to_stiff such steps, with fewer than stiff_reset non-stiff ones in
+ *  a row in between, the problem is declared stiff.
+ *
+ *  Stiff → non-stiff.  Rosenbrock stages damp the stiff modes, so they yield
+ *  no comparable estimate.  Before each step at a new point one nonlinear
+ *  power iteration
+ *
+ *      v ← (f(t, y + δ·v/‖v‖) − f(t, y)) / δ,     ρ ≈ ‖v‖
+ *
+ *  costs one RHS call.  v is carried from step to step, starting from the
+ *  direction y_{n+1} − Y₆ of the last stiff DoPri54 test, so the iteration
+ *  keeps converging as the solution moves.  After switch_to_nonstiff
+ *  consecutive accepted steps with h·ρ ≤ stiff_threshold, DoPri54 could
+ *  take the same steps stably and the integration switches back.
+ *
+ *  Hand-over
+ *  ─────────
+ *  • Switches happen between accepted steps.  t, y, h and the controller's
+ *    error history stay in AdaptiveDES and carry over unchanged; the
+ *    controller only sees the order of the active method
+ *    (controller_order()).
+ *  • has_fsal() is true.  In stiff mode f(t + h, y_{n+1}) is evaluated at
+ *    the end of each attempt, replacing the f(t, y) call Rosenbrock4 would
+ *    otherwise need at the start of the next step.
+ *  • Both methods produce DenseSegment<N>s.  They go into one DenseHistory,
+ *    so interpolate(), events, uniform output and DDE lookups see a single
+ *    record regardless of which method took a step.
+ *  • stats().method_switches and stats().stiff_steps report the switching.
+ *
+ *  The embedded solvers are reached through nonstiff_solver() and
+ *  stiff_solver() for method settings (e.g. Rosenbrock4's fd_eps,
+ *  sparse_jacobian, autonomous); their own options are not used.
+ */
+
+#include "des_dopri54.hpp"
+#include "des_rossenbrock.hpp"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace DES {
+
+template <int N, int HistoryPoints = 1000>
+class AutoSwitch : public AdaptiveDES<AutoSwitch<N, HistoryPoints>, N, HistoryPoints, 7> {
+    using Base = AdaptiveDES<AutoSwitch<N, HistoryPoints>, N, HistoryPoints, 7>;
+    using WorkspaceT = Workspace<N, 7>;
+    using NonStiff = DoPri54<N, HistoryPoints>;
+    using Stiff = Rosenbrock4<N, HistoryPoints>;
+
+  public:
+    // h·ρ above which a step counts as stability-limited
+    double stiff_threshold = 3.25;
+
+    // Stability-limited DoPri54 steps before switching to Rosenbrock4;
+    // stiff_reset non-stiff steps in a row start the count over
+    int switch_to_stiff = 15;
+    int stiff_reset = 6;
+
+    // Consecutive non-stiff Rosenbrock4 steps before switching back
+    int switch_to_nonstiff = 6;
+
+    AutoSwitch()
+    {
+        this->options.controller.kind = ControllerKind::PI;
+        this->options.controller.safety = 0.9;
+        this->options.controller.min_factor = 0.2;
+        this->options.controller.max_factor = 10.0;
+    }
+
+    // ── CRTP capability queries ─────────────────────────────────────────────
+
+    [[nodiscard]] static constexpr int method_order()
+    {
+        return NonStiff::method_order();
+    }
+    [[nodiscard]] static constexpr int adaptive_order()
+    {
+        return NonStiff::adaptive_order();
+    }
+    [[nodiscard]] static constexpr bool has_fsal()
+    {
+        return true;
+    }
+
+    [[nodiscard]] int controller_order() const noexcept
+    {
+        return m_step_stiff ? Stiff::adaptive_order() : NonStiff::adaptive_order();
+    }
+
+    // True while Rosenbrock4 takes the steps
+    [[nodiscard]] bool stiff() const noexcept
+    {
+        return m_stiff;
+    }
+
+    [[nodiscard]] NonStiff &nonstiff_solver() noexcept
+    {
+        return m_nonstiff;
+    }
+    [[nodiscard]] Stiff &stiff_solver() noexcept
+    {
+        return m_stiff_solver;
+    }
+
+    // ── Dense output ────────────────────────────────────────────────────────
+
+    [[nodiscard]] bool has_dense_output() const noexcept
+    {
+        return m_last.valid;
+    }
+
+    [[nodiscard]] const DenseSegment<N> &last_dense_step() const noexcept
+    {
+        return m_last;
+    }
+
+    [[nodiscard]] int dense_history_size() const noexcept
+    {
+        return static_cast<int>(m_dense_hist.size());
+    }
+
+    [[nodiscard]] const DenseHistory<N> &dense_history() const noexcept
+    {
+        return m_dense_hist;
+    }
+
+    [[nodiscard]] const DenseSegment<N> &dense_segment(int i) const
+    {
+        if (i < 0 || i >= dense_history_size())
+        {
+            throw std::out_of_range("AutoSwitch: dense history index out of range");
+        }
+        return m_dense_hist[static_cast<std::size_t>(i)];
+    }
+
+    [[nodiscard]] Vec<N> interpolate(double t) const
+    {
+        if (m_dense_hist.empty())
+        {
+            throw std::out_of_range("AutoSwitch: no dense segments stored");
+        }
+        if (const DenseSegment<N> *seg = m_dense_hist.find(t))
+        {
+            return seg->eval(t);
+        }
+        throw std::out_of_range("AutoSwitch: interpolation time outside stored dense history");
+    }
+
+    // interpolate() at every time in sorted_t (ordered in the integration
+    // direction), column j of `out` for sorted_t[j] — O(n + m) merge walk
+    void interpolate_many(ColumnView sorted_t, Eigen::Matrix<double, N, Eigen::Dynamic> &out) const
+    {
+        if (m_dense_hist.empty())
+        {
+            throw std::out_of_range("AutoSwitch: no dense segments stored");
+        }
+        if (m_dense_hist.eval_many(sorted_t.data, sorted_t.size, out) != sorted_t.size)
+        {
+            throw std::out_of_range("AutoSwitch: interpolation times unsorted or outside stored dense history");
+        }
+    }
+
+    [[nodiscard]] double interpolate_component(double t, int component) const
+    {
+        return interpolate(t)[component];
+    }
+
+    // ── solve() overloads ─────────────────────────────────────────────────────
+    //
+    // Bind the system's Jacobian sources to the embedded Rosenbrock4 once per
+    // solve, as Rosenbrock4::solve() does.
+
+    template <typename System>
+    SolveResult solve(Vec<N> &y, double t0, double t1, System &sys)
+    {
+        m_stiff_solver.setup_jacobian(sys, y.size());
+        typename Base::NoOpObserver obs;
+        return Base::solve(y, t0, t1, sys, obs);
+    }
+
+    template <typename System, typename Observer>
+    SolveResult solve(Vec<N> &y, double t0, double t1, System &sys, Observer &&obs)
+    {
+        m_stiff_solver.setup_jacobian(sys, y.size());
+        return Base::solve(y, t0, t1, sys, std::forward<Observer>(obs));
+    }
+
+    template <typename System>
+    SolveResult solve(Vec<N> &y, double t0, double t1, System &sys, typename Base::DelayHistoryStorage &dh)
+    {
+        m_stiff_solver.setup_jacobian(sys, y.size());
+        typename Base::NoOpObserver obs;
+        return Base::solve(y, t0, t1, sys, dh, obs);
+    }
+
+    template <typename System, typename Observer>
+    SolveResult solve(Vec<N> &y, double t0, double t1, System &sys, typename Base::DelayHistoryStorage &dh, Observer &&obs)
+    {
+        m_stiff_solver.setup_jacobian(sys, y.size());
+        return Base::solve(y, t0, t1, sys, dh, std::forward<Observer>(obs));
+    }
+
+    // ── Lifecycle hooks ──────────────────────────────────────────────────────
+
+    void before_solve()
+    {
+        if (!(stiff_threshold > 0.0) || switch_to_stiff < 1 || stiff_reset < 1 || switch_to_nonstiff < 1)
+        {
+            throw std::invalid_argument("DES: AutoSwitch thresholds and step counts must be positive");
+        }
+
+        const Eigen::Index n = this->dimension();
+        m_last.reset(n);
+        m_dense_hist.reset(this->options.dense_retention, static_cast<std::size_t>(this->options.reserve_steps));
+
+        // The embedded solvers hand each segment over in after_step() and
+        // keep none themselves
+        DenseRetention none;
+        none.kind = DenseRetention::Kind::None;
+        m_nonstiff.options.dense_retention = none;
+        m_nonstiff.options.reserve_steps = 0;
+        m_nonstiff.prepare_embedded(n);
+        m_stiff_solver.options.dense_retention = none;
+        m_stiff_solver.options.reserve_steps = 0;
+        m_stiff_solver.options.atol = this->options.atol;  // FD Jacobian scale
+        m_stiff_solver.options.atol_vec = this->options.atol_vec;
+        m_stiff_solver.options.use_vector_atol = this->options.use_vector_atol;
+        m_stiff_solver.prepare_embedded(n);
+
+        m_ros_ws.resize(n);
+        m_dir.resize(n);
+        m_dir.setZero();
+        m_probe.resize(n);
+        m_f_probe.resize(n);
+
+        m_stiff = false;
+        m_step_stiff = false;
+        m_probed = false;
+        m_stiff_count = 0;
+        m_nonstiff_count = 0;
+        m_rho = 0.0;
+        m_h_rho = 0.0;
+    }
+
+    void after_step(double t)
+    {
+        if (m_step_stiff)
+        {
+            m_stiff_solver.after_step(t);
+            m_last = m_stiff_solver.last_dense_step();
+            ++this->m_stats.stiff_steps;
+        }
+        else
+        {
+            m_nonstiff.after_step(t);
+            m_last = m_nonstiff.last_dense_step();
+        }
+        m_dense_hist.push(m_last);
+        m_probed = false;
+
+        if (!m_stiff)
+        {
+            if (m_h_rho > stiff_threshold)
+            {
+                m_nonstiff_count = 0;
+                if (++m_stiff_count >= switch_to_stiff)
+                {
+                    switch_method();
+                }
+            }
+            else if (++m_nonstiff_count >= stiff_reset)
+            {
+                m_stiff_count = 0;
+            }
+        }
+        else
+        {
+            if (m_h_rho <= stiff_threshold)
+            {
+                if (++m_nonstiff_count >= switch_to_nonstiff)
+                {
+                    switch_method();
+                }
+            }
+            else
+            {
+                m_nonstiff_count = 0;
+            }
+        }
+    }
+
+    // ── Step computation ─────────────────────────────────────────────────────
+    //
+    // On entry: ws.k[0] = f(t, y)  (FSAL or fresh eval, whichever method took
+    // the previous step).
+
+    template <typename RhsEval>
+    void compute_step(double t, const Vec<N> &y, double h, RhsEval &&rhs, WorkspaceT &ws, SolverStats &stats)
+    {
+        m_step_stiff = m_stiff;
+
+        if (!m_stiff)
+        {
+            m_nonstiff.compute_step(t, y, h, rhs, ws, stats);
+
+            // Stages 6 and 7 share t + h; Y₆ is still in ws.stage
+            const double den = (ws.next - ws.stage).squaredNorm();
+            const double num = (ws.k[6] - ws.k[5]).squaredNorm();
+            m_h_rho = (den > 0.0) ? std::abs(h) * std::sqrt(num / den) : 0.0;
+            if (m_h_rho > stiff_threshold)
+            {
+                m_dir = ws.next - ws.stage;  // starting vector for the power iteration
+            }
+            return;
+        }
+
+        // A retry of a rejected step reuses ρ from the same (t, y)
+        if (!m_probed)
+        {
+            estimate_rho(t, y, rhs, ws.k[0], stats);
+            m_probed = true;
+        }
+        m_h_rho = std::abs(h) * m_rho;
+
+        m_ros_ws.k[0] = ws.k[0];
+        m_stiff_solver.compute_step(t, y, h, rhs, m_ros_ws, stats);
+        ws.next = m_ros_ws.next;
+        ws.error = m_ros_ws.error;
+
+        rhs(t + h, ws.next, ws.fsal);
+        ++stats.rhs_evals;
+    }
+
+  private:
+    NonStiff m_nonstiff{};
+    Stiff m_stiff_solver{};
+    Workspace<N, 4> m_ros_ws{};
+
+    DenseSegment<N> m_last{};
+    DenseHistory<N> m_dense_hist{};
+
+    // Power-iteration direction and probe scratch, sized in before_solve()
+    Vec<N> m_dir{};
+    Vec<N> m_probe{};
+    Vec<N> m_f_probe{};
+
+    // Active method, method of the step just computed, and whether ρ has
+    // been estimated at the current point
+    bool m_stiff = false;
+    bool m_step_stiff = false;
+    bool m_probed = false;
+
+    // Stiff / non-stiff accepted steps counted towards the next switch,
+    // latest estimate of |λ|, and h·ρ for the step just computed
+    int m_stiff_count = 0;
+    int m_nonstiff_count = 0;
+    double m_rho = 0.0;
+    double m_h_rho = 0.0;
+
+    void switch_method()
+    {
+        m_stiff = !m_stiff;
+        m_stiff_count = 0;
+        m_nonstiff_count = 0;
+        ++this->m_stats.method_switches;
+    }
+
+    // One nonlinear power iteration at (t, y): m_dir ← J·m_dir/‖m_dir‖ by a
+    // forward difference of length δ, ρ = ‖m_dir‖
+    template <typename RhsEval>
+    void estimate_rho(double t, const Vec<N> &y, RhsEval &rhs, const Vec<N> &f0, SolverStats &stats)
+    {
+        double dir_norm = m_dir.norm();
+        if (!(dir_norm > 0.0) || !std::isfinite(dir_norm))
+        {
+            m_dir = f0;
+            dir_norm = m_dir.norm();
+            if (!(dir_norm > 0.0) || !std::isfinite(dir_norm))
+            {
+                m_dir.setOnes();
+                dir_norm = m_dir.norm();
+            }
+        }
+
+        const double delta = std::sqrt(std::numeric_limits<double>::epsilon()) * std::max(1.0, y.norm());
+        m_probe.noalias() = y + (delta / dir_norm) * m_dir;
+        rhs(t, m_probe, m_f_probe);
+        ++stats.rhs_evals;
+
+        m_dir.noalias() = (m_f_probe - f0) / delta;
+        m_rho = m_dir.norm();
+        if (!std::isfinite(m_rho))
+        {
+            // Leave the stiff method in charge and restart the iteration
+            m_rho = std::numeric_limits<double>::infinity();
+            m_dir.setZero();
+        }
+    }
+};
+
+}  // namespace DES
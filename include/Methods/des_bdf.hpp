@@ -0,0 +1,764 @@
+#pragma once
+
+/*  des_bdf.hpp  –  DES namespace
+ *
+ *  BDF — variable-order (1–5), variable-step BDF / NDF multistep method in
+ *  Nordsieck form, for large stiff ODEs and DDEs.
+ *
+ *  The solution is carried as the Nordsieck array of the order-k polynomial
+ *  P through y_n, y_{n−1}, …, y_{n−k}:
+ *
+ *      z_j = h^j P^(j)(t_n) / j!,   j = 0 … k,   P(t_n + s h) = Σ_j z_j s^j.
+ *
+ *  A step predicts z⁽⁰⁾ = Π z (Pascal matrix, P shifted by one step) and
+ *  solves for the correction e = y_{n+1} − z⁽⁰⁾_0 in
+ *
+ *      (1 − κ_k) γ_k e + z⁽⁰⁾_1 = h f(t_{n+1}, z⁽⁰⁾_0 + e),   γ_k = Σ_{j≤k} 1/j,
+ *
+ *  by modified Newton with the iteration matrix W = (1/c)·I − J,
+ *  c = h / ((1 − κ_k) γ_k).  The corrected array is z = z⁽⁰⁾ + e ℓ, where
+ *  ℓ_j are the coefficients of Π_{i=1..k} (1 + s/i); e itself is
+ *  ∇^{k+1} y_{n+1}, the next backward difference.
+ *
+ *  κ = 0 gives the classical BDFs.  The NDFs (κ_k = −0.185, −1/9, −0.0823,
+ *  −0.0415, 0) trade a little stability angle for a smaller error constant
+ *  and take roughly 20 % larger steps at orders 1–4.
+ *
+ *  References
+ *  ──────────
+ *  • L. F. Shampine, M. W. Reichelt.
+ *    The MATLAB ODE Suite.
+ *    SIAM J. Sci. Comput. 18 (1997) 1–22.  (NDFs, step and order control)
+ *
+ *  • A. C. Hindmarsh.
+ *    ODEPACK, a systematized collection of ODE solvers.
+ *    IMACS Trans. Sci. Comput. 1 (1983) 55–64.  (Nordsieck form, LSODE)
+ *
+ *  • E. Hairer, G. Wanner.
+ *    Solving Ordinary Differential Equations II — Stiff and
+ *    Differential-Algebraic Problems.
+ *    2nd ed., Springer, 1996.  §III.6 (Nordsieck methods), §V.
+ *
+ *  Properties
+ *  ──────────
+ *  • Orders 1 … max_order (≤ 5), starting at order 1; one RHS call per
+ *    Newton iteration and no stages
+ *  • The solver picks h and k itself (ode15s strategy) through
+ *    next_step_size(): h is held for k + 2 steps, then the order among
+ *    k − 1, k, k + 1 that allows the largest step is taken, and only if that
+ *    step is larger.  Changing h rescales the array, z_j ← (h'/h)^j z_j, so
+ *    clipping by h_max, breaking points or the endpoint costs nothing extra.
+ *  • J is kept across steps.  It is refreshed when Newton fails with an old
+ *    J (same h, before the step is given up) or after jac_max_age accepted
+ *    steps; W is refactored only when J or c changes.  SolverStats counts
+ *    jacobian_evals, lu_decompositions, newton_iters and newton_failures.
+ *  • Jacobian sources, as for Rosenbrock4: analytical .jacobian(), declared
+ *    band (BandedLU) or sparsity pattern (CPR-colored differences,
+ *    Eigen::SparseLU), forward-mode autodiff through a Dual-templated RHS,
+ *    dense finite differences
+ *  • Dense output: the Nordsieck polynomial over the last step, of the
+ *    order k that step was taken with
+ *
+ *  Implementation notes
+ *  ────────────────────
+ *  • has_fsal() is true: ws.fsal = z_1 / h, the derivative of the
+ *    interpolant at t_{n+1}.  It stands in for f(t_{n+1}, y_{n+1}) in the DDE
+ *    history and saves the RHS call AdaptiveDES would otherwise make at the
+ *    start of each step.  The exact f(t_n, y_n) is only needed for a restart
+ *    and for finite-difference Jacobians, which evaluate it when missing.
+ *  • Newton divergence or slow convergence (with a current J) is reported as
+ *    an error norm of 2; next_step_size() then cuts h by 0.3.
+ *
+ *  DDE usage
+ *  ─────────
+ *  t_{n+1} must stay behind the smallest delay: AdaptiveDES caps h at
+ *  min_delay.  Past values from before a breaking point do not describe the
+ *  solution after it, so the method restarts at order 1 there.
+ */
+
+#include "des_adaptive.hpp"
+#include "des_dense_output.hpp"
+#include "des_jacobian.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace DES {
+
+template <int N, int HistoryPoints = 1000>
+class BDF : public AdaptiveDES<BDF<N, HistoryPoints>, N, HistoryPoints, 2> {
+    using Base = AdaptiveDES<BDF<N, HistoryPoints>, N, HistoryPoints, 2>;
+    using WorkspaceT = Workspace<N, 2>;
+    using Segment = DenseSegment<N, 5>;  // room for the order-5 polynomial
+
+    static constexpr int max_k = 5;
+
+    // ── Coefficients, indexed by order k ────────────────────────────────────
+    struct C {
+        // γ_k = Σ_{j≤k} 1/j
+        static constexpr double gamma[max_k + 1] = {0.0, 1.0, 3.0 / 2.0, 11.0 / 6.0, 25.0 / 12.0, 137.0 / 60.0};
+
+        // NDF κ_k (Shampine & Reichelt); BDF uses κ = 0
+        static constexpr double kappa[max_k + 1] = {0.0, -0.1850, -1.0 / 9.0, -0.0823, -0.0415, 0.0};
+
+        // ℓ_kj: coefficient of s^j in Π_{i=1..k} (1 + s/i)
+        static constexpr double ell[max_k + 1][max_k + 1] = {
+            {1.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+            {1.0, 1.0, 0.0, 0.0, 0.0, 0.0},
+            {1.0, 3.0 / 2.0, 1.0 / 2.0, 0.0, 0.0, 0.0},
+            {1.0, 11.0 / 6.0, 1.0, 1.0 / 6.0, 0.0, 0.0},
+            {1.0, 25.0 / 12.0, 35.0 / 24.0, 5.0 / 12.0, 1.0 / 24.0, 0.0},
+            {1.0, 137.0 / 60.0, 15.0 / 8.0, 17.0 / 24.0, 1.0 / 8.0, 1.0 / 120.0},
+        };
+
+        static constexpr double factorial[max_k + 1] = {1.0, 1.0, 2.0, 6.0, 24.0, 120.0};
+    };
+
+  public:
+    // Finite-difference epsilon for Jacobian approximation.
+    // Perturbation for component j: fd_eps * max(|y[j]|, min(1, atol_j))
+    double fd_eps = 1.0e-7;
+
+    // Use the sparse FD Jacobian path with a pattern found by structural
+    // probing (N + 1 RHS calls per solve), as for Rosenbrock4
+    bool sparse_jacobian = false;
+
+    // NDF coefficients (default, as in ode15s); false → classical BDF
+    bool ndf = true;
+
+    // Highest order used, 1 … 5.  BDF/NDF 3–5 are not A-stable: lower this
+    // for problems with eigenvalues close to the imaginary axis.
+    int max_order = 5;
+
+    // Newton iterations per attempt (ode15s: 4)
+    int max_newton_iters = 4;
+
+    // Refresh J after this many accepted steps even if Newton still
+    // converges; ≤ 0 → only on a Newton failure
+    int jac_max_age = 50;
+
+    BDF() = default;
+
+    // ── CRTP capability queries ─────────────────────────────────────────────
+
+    [[nodiscard]] static constexpr int method_order()
+    {
+        return max_k;
+    }
+    // The order every solve starts with; used for the initial step size
+    [[nodiscard]] static constexpr int adaptive_order()
+    {
+        return 1;
+    }
+    [[nodiscard]] static constexpr bool has_fsal()
+    {
+        return true;
+    }
+
+    // Order of the last attempted step
+    [[nodiscard]] int order() const noexcept
+    {
+        return m_k;
+    }
+
+    // ── Dense output (Nordsieck polynomial) ─────────────────────────────────
+
+    [[nodiscard]] bool has_dense_output() const noexcept
+    {
+        return m_last.valid;
+    }
+
+    // Pattern and coloring used by the sparse path (empty otherwise)
+    [[nodiscard]] const JacobianSparsity &jacobian_sparsity() const noexcept
+    {
+        return m_jac.sparsity();
+    }
+
+    [[nodiscard]] const Segment &last_dense_step() const noexcept
+    {
+        return m_last;
+    }
+
+    [[nodiscard]] int dense_history_size() const noexcept
+    {
+        return static_cast<int>(m_dense_hist.size());
+    }
+
+    [[nodiscard]] const DenseHistory<N, 5> &dense_history() const noexcept
+    {
+        return m_dense_hist;
+    }
+
+    [[nodiscard]] const Segment &dense_segment(int i) const
+    {
+        if (i < 0 || i >= dense_history_size())
+        {
+            throw std::out_of_range("BDF: dense history index out of range");
+        }
+        return m_dense_hist[static_cast<std::size_t>(i)];
+    }
+
+    [[nodiscard]] Vec<N> interpolate(double t) const
+    {
+        if (m_dense_hist.empty())
+        {
+            throw std::out_of_range("BDF: no dense segments stored");
+        }
+        if (const Segment *seg = m_dense_hist.find(t))
+        {
+            return seg->eval(t);
+        }
+        throw std::out_of_range("BDF: interpolation time outside dense history");
+    }
+
+    // interpolate() at every time in sorted_t (ordered in the integration
+    // direction), column j of `out` for sorted_t[j] — O(n + m) merge walk
+    void interpolate_many(ColumnView sorted_t, Eigen::Matrix<double, N, Eigen::Dynamic> &out) const
+    {
+        if (m_dense_hist.empty())
+        {
+            throw std::out_of_range("BDF: no dense segments stored");
+        }
+        if (m_dense_hist.eval_many(sorted_t.data, sorted_t.size, out) != sorted_t.size)
+        {
+            throw std::out_of_range("BDF: interpolation times unsorted or outside stored dense history");
+        }
+    }
+
+    [[nodiscard]] double interpolate_component(double t, int component) const
+    {
+        return interpolate(t)[component];
+    }
+
+    // ── solve() overloads ─────────────────────────────────────────────────────
+    //
+    // These shadow the base-class overloads so that setup_jacobian() is called
+    // exactly once per solve, before the integration loop begins.
+
+    // ODE — no observer
+    template <typename System>
+    SolveResult solve(Vec<N> &y, double t0, double t1, System &sys)
+    {
+        setup_jacobian(sys, y.size());
+        typename Base::NoOpObserver obs;
+        return Base::solve(y, t0, t1, sys, obs);
+    }
+
+    // ODE — with observer
+    template <typename System, typename Observer>
+    SolveResult solve(Vec<N> &y, double t0, double t1, System &sys, Observer &&obs)
+    {
+        setup_jacobian(sys, y.size());
+        return Base::solve(y, t0, t1, sys, std::forward<Observer>(obs));
+    }
+
+    // DDE — no observer
+    template <typename System>
+    SolveResult solve(Vec<N> &y, double t0, double t1, System &sys, typename Base::DelayHistoryStorage &dh)
+    {
+        setup_jacobian(sys, y.size());
+        typename Base::NoOpObserver obs;
+        return Base::solve(y, t0, t1, sys, dh, obs);
+    }
+
+    // DDE — with observer
+    template <typename System, typename Observer>
+    SolveResult solve(Vec<N> &y, double t0, double t1, System &sys, typename Base::DelayHistoryStorage &dh, Observer &&obs)
+    {
+        setup_jacobian(sys, y.size());
+        return Base::solve(y, t0, t1, sys, dh, std::forward<Observer>(obs));
+    }
+
+    // ── Lifecycle hooks ──────────────────────────────────────────────────────
+
+    // All N- and N×N-sized scratch lives in members sized here, so the step
+    // loop itself never allocates — also for N = Eigen::Dynamic (the sparse
+    // path excepted, as in Rosenbrock4).
+    void before_solve()
+    {
+        if (max_order < 1 || max_order > max_k)
+        {
+            throw std::invalid_argument("DES: BDF max_order must be between 1 and 5");
+        }
+        if (max_newton_iters < 1)
+        {
+            throw std::invalid_argument("DES: BDF max_newton_iters must be positive");
+        }
+
+        const Eigen::Index n = this->dimension();
+        m_last.reset(n);
+        m_pending.reset(n);
+        m_dense_hist.reset(this->options.dense_retention, static_cast<std::size_t>(this->options.reserve_steps));
+
+        m_jac.resize(n);
+        m_jac.set_fd_floor([this](Eigen::Index j) { return this->component_atol(static_cast<int>(j)); });
+        for (int j = 0; j <= max_k; ++j)
+        {
+            m_z[j].resize(n);
+            m_zn[j].resize(n);
+        }
+        m_e.resize(n);
+        m_e_prev.resize(n);
+        m_psi.resize(n);
+        m_f0.resize(n);
+        m_scal.resize(n);
+
+        m_k = 1;
+        m_k_next = 1;
+        m_h = 0.0;
+        m_nconh = 0;
+        m_fails = 0;
+        m_restart = true;
+        m_retry = false;
+        m_newton_failed = false;
+        m_jac_age = -1;
+        m_jac_current = false;
+        m_w_c = 0.0;
+        m_rate = 0.0;
+        m_err_km1 = 0.0;
+        m_err_kp1 = 0.0;
+    }
+
+    // Commit the corrected array, then apply an order change chosen by
+    // next_step_size() for the coming step
+    void after_step(double /*t*/)
+    {
+        m_last = m_pending;
+        m_dense_hist.push(m_pending);
+
+        for (int j = 0; j <= m_k; ++j)
+        {
+            m_z[j].swap(m_zn[j]);
+        }
+        m_e_prev.swap(m_e);  // ∇^{k+1} y_{n+1}, for the order k + 1 estimate
+
+        if (m_k_next > m_k)
+        {
+            raise_order(m_e_prev);
+        }
+        else if (m_k_next < m_k)
+        {
+            lower_order();
+        }
+
+        m_retry = false;
+        m_jac_current = false;
+        if (m_jac_age >= 0)
+        {
+            ++m_jac_age;
+        }
+    }
+
+    void after_breaking_point(double /*t*/)
+    {
+        m_restart = true;
+    }
+
+    // ── Step size and order (Shampine & Reichelt, ode15s) ───────────────────
+    //
+    // Called by AdaptiveDES after every attempt, before after_step().  The
+    // factors 1.2 / 1.3 / 1.4 bias the choice towards keeping the order, and
+    // h never grows by more than 10 at once.
+
+    double next_step_size(double err_norm, bool accepted, double h_abs)
+    {
+        const int k = m_k;
+        if (m_newton_failed)
+        {
+            m_newton_failed = false;
+            return 0.3 * h_abs;
+        }
+
+        if (!accepted)
+        {
+            ++m_fails;
+            if (m_fails > 1)
+            {
+                return 0.5 * h_abs;
+            }
+            double h_new = h_abs * std::max(0.1, 0.833 * std::pow(err_norm, -1.0 / (k + 1)));
+            if (k > 1)
+            {
+                const double hkm1 = h_abs * std::max(0.1, 0.769 * std::pow(m_err_km1, -1.0 / k));
+                if (hkm1 > h_new)
+                {
+                    h_new = std::min(h_abs, hkm1);
+                    lower_order();
+                }
+            }
+            return h_new;
+        }
+
+        m_fails = 0;
+        m_nconh = std::min(m_nconh + 1, max_k + 2);
+        if (m_nconh < k + 2)
+        {
+            return h_abs;
+        }
+
+        const auto h_for = [h_abs](double err, int q, double bias) {
+            const double r = bias * std::pow(err, 1.0 / (q + 1));
+            return (r > 0.1) ? h_abs / r : 10.0 * h_abs;
+        };
+
+        double h_opt = h_for(err_norm, k, 1.2);
+        int k_opt = k;
+        if (k > 1)
+        {
+            const double hkm1 = h_for(m_err_km1, k - 1, 1.3);
+            if (hkm1 > h_opt)
+            {
+                h_opt = std::min(h_abs, hkm1);
+                k_opt = k - 1;
+            }
+        }
+        if (k < max_order)
+        {
+            const double hkp1 = h_for(m_err_kp1, k + 1, 1.4);
+            if (hkp1 > h_opt)
+            {
+                h_opt = hkp1;
+                k_opt = k + 1;
+            }
+        }
+
+        if (h_opt > h_abs)
+        {
+            m_k_next = k_opt;
+            return h_opt;
+        }
+        return h_abs;
+    }
+
+    // ── Step computation ─────────────────────────────────────────────────────
+    //
+    // On entry ws.k[0] = f(t, y) on the first step, after a breaking point and
+    // on a retry; otherwise it holds the FSAL stand-in z₁/h.  ws.k[1] receives
+    // f at the Newton iterates; ws.stage and ws.error are scratch until the
+    // error estimate is written.
+
+    template <typename RhsEval>
+    void compute_step(double t, const Vec<N> &y, double h, RhsEval &&rhs, WorkspaceT &ws, SolverStats &stats)
+    {
+        const bool retry = m_retry;
+        m_retry = true;
+        bool f0_exact = retry || m_restart;
+        if (f0_exact)
+        {
+            m_f0 = ws.k[0];
+        }
+
+        // ── Nordsieck array for this h: restart at order 1, or rescale ──────
+        if (m_restart)
+        {
+            m_k = 1;
+            m_z[0] = y;
+            m_z[1] = h * ws.k[0];
+            m_h = h;
+            m_nconh = 0;
+            m_restart = false;
+        }
+        else if (h != m_h)
+        {
+            const double r = h / m_h;
+            double rj = 1.0;
+            for (int j = 1; j <= m_k; ++j)
+            {
+                rj *= r;
+                m_z[j] *= rj;
+            }
+            m_h = h;
+            m_nconh = 0;
+        }
+        const int k = m_k;
+        m_k_next = k;
+
+        const double rtol = this->options.rtol;
+        for (Eigen::Index i = 0; i < y.size(); ++i)
+        {
+            m_scal[i] = this->component_atol(static_cast<int>(i)) + rtol * std::abs(y[i]);
+        }
+
+        // ── Predictor z⁽⁰⁾ = Π z ─────────────────────────────────────────────
+        for (int j = 0; j <= k; ++j)
+        {
+            m_zn[j] = m_z[j];
+        }
+        for (int j0 = 0; j0 < k; ++j0)
+        {
+            for (int j = k - 1; j >= j0; --j)
+            {
+                m_zn[j] += m_zn[j + 1];
+            }
+        }
+
+        // ── Corrector: W Δ = f(z⁽⁰⁾_0 + e) − z⁽⁰⁾_1 / h − e / c ─────────────
+        const double lk = (1.0 - kappa(k)) * C::gamma[k];
+        const double c = h / lk;
+        m_psi = m_zn[1] * (1.0 / h);
+
+        // A Newton failure with an old J retries once with a fresh one at
+        // the same h before the step is given up
+        bool need_jac = m_jac_age < 0 || (jac_max_age > 0 && m_jac_age >= jac_max_age);
+        for (;;)
+        {
+            if (need_jac)
+            {
+                if (m_jac.finite_differences() && !f0_exact)
+                {
+                    rhs(t, y, m_f0);
+                    ++stats.rhs_evals;
+                    f0_exact = true;
+                }
+                m_jac.evaluate(t, y, m_f0, rhs, fd_eps, stats);
+                m_jac_age = 0;
+                m_jac_current = true;
+                m_w_c = 0.0;
+                need_jac = false;
+            }
+            if (c != m_w_c)
+            {
+                m_jac.factor(1.0 / c);
+                m_w_c = c;
+                m_rate = 0.0;
+                ++stats.lu_decompositions;
+            }
+            if (newton(t, h, lk, rhs, ws, stats))
+            {
+                break;
+            }
+            if (m_jac_current)
+            {
+                newton_failed(y, ws, stats);
+                return;
+            }
+            need_jac = true;
+        }
+
+        // ── Error estimate and corrected array ──────────────────────────────
+        ws.error = error_constant(k) * m_e;
+        m_zn[0] = ws.next;
+        for (int j = 1; j <= k; ++j)
+        {
+            m_zn[j] += C::ell[k][j] * m_e;
+        }
+        ws.fsal = m_zn[1] * (1.0 / h);
+
+        // Estimates at orders k − 1 (∇^k y_{n+1} = k!·z_k) and k + 1
+        // (∇^{k+2} y_{n+1} = e − e_prev, valid after k + 1 steps at this h)
+        m_err_km1 = 0.0;
+        if (k > 1)
+        {
+            ws.stage = C::factorial[k] * m_zn[k];
+            m_err_km1 = error_constant(k - 1) * this->scaled_error(y, ws.next, ws.stage);
+        }
+        m_err_kp1 = std::numeric_limits<double>::infinity();
+        if (k < max_order && m_nconh + 1 >= k + 2)
+        {
+            ws.stage = m_e - m_e_prev;
+            m_err_kp1 = error_constant(k + 1) * this->scaled_error(y, ws.next, ws.stage);
+        }
+
+        // ── Dense output: P(t_n + θh) = Σ_j z_j (θ − 1)^j ───────────────────
+        // Taylor shift by −1 on z_1..z_k (the constant term is y_n itself)
+        const double inv_h = 1.0 / h;
+        m_pending.t0 = t;
+        m_pending.h = h;
+        m_pending.y0 = y;
+        m_pending.valid = true;
+        m_pending.order = k;
+        for (int j = 1; j <= k; ++j)
+        {
+            m_pending.q[j - 1] = m_zn[j];
+        }
+        for (int j0 = 0; j0 < k; ++j0)
+        {
+            for (int j = k - 1; j >= std::max(j0, 1); --j)
+            {
+                m_pending.q[j - 1] -= m_pending.q[j];
+            }
+        }
+        for (int j = 0; j < max_k; ++j)
+        {
+            if (j < k)
+            {
+                m_pending.q[j] *= inv_h;
+            }
+            else
+            {
+                m_pending.q[j].setZero();
+            }
+        }
+    }
+
+  private:
+    Segment m_last{};
+    Segment m_pending{};
+    DenseHistory<N, 5> m_dense_hist{};
+
+    // Nordsieck arrays: committed at t_n for step size m_h, and the
+    // predicted / corrected one of the current attempt
+    std::array<Vec<N>, max_k + 1> m_z{};
+    std::array<Vec<N>, max_k + 1> m_zn{};
+    Vec<N> m_e{};       // correction of the current attempt
+    Vec<N> m_e_prev{};  // correction of the last accepted step
+    Vec<N> m_psi{};
+    Vec<N> m_f0{};
+    Vec<N> m_scal{};
+
+    // J and the factored iteration matrix W = (1/c)·I − J
+    IterationMatrix<N> m_jac{};
+
+    // Order / step state: current and next order, step size of m_z, steps
+    // at this (h, k), consecutive error-test failures, restart pending,
+    // retry of a rejected attempt, Newton failure to report
+    int m_k = 1;
+    int m_k_next = 1;
+    double m_h = 0.0;
+    int m_nconh = 0;
+    int m_fails = 0;
+    bool m_restart = true;
+    bool m_retry = false;
+    bool m_newton_failed = false;
+
+    // Newton / reuse state: accepted steps since J was evaluated (−1: none
+    // yet), J evaluated at the current (t, y), the c that W was factored
+    // for, and the contraction rate carried between steps with that W
+    int m_jac_age = -1;
+    bool m_jac_current = false;
+    double m_w_c = 0.0;
+    double m_rate = 0.0;
+
+    // Scaled error estimates at orders k − 1 and k + 1
+    double m_err_km1 = 0.0;
+    double m_err_kp1 = 0.0;
+
+    [[nodiscard]] double kappa(int k) const noexcept
+    {
+        return ndf ? C::kappa[k] : 0.0;
+    }
+
+    // Local error ≈ (κ_k γ_k + 1/(k+1)) ∇^{k+1} y_{n+1}
+    [[nodiscard]] double error_constant(int k) const noexcept
+    {
+        return kappa(k) * C::gamma[k] + 1.0 / (k + 1);
+    }
+
+    // ── Modified Newton on e ────────────────────────────────────────────────
+    //
+    // Convergence test of ode15s in tolerance units: stop when the
+    // estimated remaining error Δ·ρ/(1 − ρ) is below 0.5; give up when the
+    // iteration slows (ρ > 0.9) or cannot get there in the iterations left.
+    // Unlike ode15s, a step never stops after one iteration on a rate
+    // remembered from earlier steps: with an aging J that rate is too
+    // optimistic, and the leftover iteration error in stiff components is
+    // amplified by the order-k predictor into the next error estimates.
+
+    template <typename RhsEval>
+    bool newton(double t, double h, double lk, RhsEval &rhs, WorkspaceT &ws, SolverStats &stats)
+    {
+        const double inv_c = lk / h;
+        const double n = static_cast<double>(m_e.size());
+        const double min_norm = 100.0 * std::numeric_limits<double>::epsilon() * std::sqrt((m_zn[0].array() / m_scal.array()).square().sum() / n);
+
+        m_e.setZero();
+        ws.next = m_zn[0];
+        double old_norm = 0.0;
+        for (int iter = 1; iter <= max_newton_iters; ++iter)
+        {
+            rhs(t + h, ws.next, ws.k[1]);
+            ++stats.rhs_evals;
+            ++stats.newton_iters;
+
+            ws.stage.noalias() = ws.k[1] - m_psi - inv_c * m_e;
+            m_jac.solve(ws.stage, ws.error);
+            const double norm = std::sqrt((ws.error.array() / m_scal.array()).square().sum() / n);
+            if (!std::isfinite(norm))
+            {
+                return false;
+            }
+            m_e += ws.error;
+            ws.next.noalias() = m_zn[0] + m_e;
+
+            if (norm <= min_norm)
+            {
+                return true;
+            }
+            if (iter > 1)
+            {
+                if (norm > 0.9 * old_norm)
+                {
+                    return false;
+                }
+                m_rate = std::max(0.9 * m_rate, norm / old_norm);
+                const double err_it = norm * m_rate / (1.0 - m_rate);
+                if (err_it <= 0.5)
+                {
+                    return true;
+                }
+                if (iter == max_newton_iters || err_it * std::pow(m_rate, max_newton_iters - iter) > 0.5)
+                {
+                    return false;
+                }
+            }
+            old_norm = norm;
+        }
+        return false;
+    }
+
+    void newton_failed(const Vec<N> &y, WorkspaceT &ws, SolverStats &stats)
+    {
+        ++stats.newton_failures;
+        m_newton_failed = true;
+        ws.next = y;
+        ws.error = 2.0 * m_scal;
+        m_pending.valid = false;
+    }
+
+    // ── Order changes on the committed array m_z ────────────────────────────
+    //
+    // In backward-difference form P_k = Σ_{j≤k} ∇^j y · s(s+1)…(s+j−1)/j!,
+    // and s(s+1)…(s+k−1)/k! = s·Π_{i<k}(1 + s/i)/k, so adding or dropping
+    // the top term only needs the ℓ table.
+
+    // k → k + 1: add ∇^{k+1} y (= e of the step just taken)
+    void raise_order(const Vec<N> &e)
+    {
+        const int k = m_k;
+        const double inv = 1.0 / (k + 1);
+        for (int j = 1; j <= k; ++j)
+        {
+            m_z[j] += (C::ell[k][j - 1] * inv) * e;
+        }
+        m_z[k + 1] = (C::ell[k][k] * inv) * e;
+        m_k = k + 1;
+        m_nconh = 0;
+    }
+
+    // k → k − 1: drop ∇^k y = k!·z_k
+    void lower_order()
+    {
+        const int k = m_k;
+        for (int j = 1; j < k; ++j)
+        {
+            m_z[j] -= (C::factorial[k - 1] * C::ell[k - 1][j - 1]) * m_z[k];
+        }
+        m_k = k - 1;
+        m_nconh = 0;
+    }
+
+    // ── Jacobian setup ───────────────────────────────────────────────────────
+    //
+    // Sources of J as in Rosenbrock4 (see IterationMatrix)
+
+    template <typename System>
+    void setup_jacobian(System &sys, Eigen::Index n)
+    {
+        m_jac.bind(sys, n, sparse_jacobian, "BDF");
+    }
+};
+
+}  // namespace DES
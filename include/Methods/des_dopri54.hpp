@@ -16,6 +16,7 @@
 
 #include "../des_adaptive.hpp"
 #include "../des_dense_output.hpp"
+#include "../des_tableau.hpp"
 
 #include <cmath>
 #include <limits>
@@ -30,17 +31,25 @@ class DoPri54 : public AdaptiveDES<DoPri54<N, HistoryPoints>, N, HistoryPoints,
     using WorkspaceT = Workspace<N, 7>;
 
     // ── Butcher tableau (Dormand & Prince 1980) ────────────────────────────
-    struct C {
-        static constexpr double c2 = 1.0 / 5.0, c3 = 3.0 / 10.0, c4 = 4.0 / 5.0, c5 = 8.0 / 9.0, c6 = 1.0;
+    struct Tableau {
+        static constexpr int stages = 7;
 
-        static constexpr double a21 = 1.0 / 5.0, a31 = 3.0 / 40.0, a32 = 9.0 / 40.0, a41 = 44.0 / 45.0, a42 = -56.0 / 15.0, a43 = 32.0 / 9.0, a51 = 19372.0 / 6561.0, a52 = -25360.0 / 2187.0, a53 = 64448.0 / 6561.0, a54 = -212.0 / 729.0, a61 = 9017.0 / 3168.0, a62 = -355.0 / 33.0,
-                                a63 = 46732.0 / 5247.0, a64 = 49.0 / 176.0, a65 = -5103.0 / 18656.0;
+        static constexpr double c[7] = {0.0, 1.0 / 5.0, 3.0 / 10.0, 4.0 / 5.0, 8.0 / 9.0, 1.0, 1.0};
 
-        // 5th-order solution weights (b₂ = 0)
-        static constexpr double b1 = 35.0 / 384.0, b3 = 500.0 / 1113.0, b4 = 125.0 / 192.0, b5 = -2187.0 / 6784.0, b6 = 11.0 / 84.0;
+        // Row 7 = b: stage 7 is f(t+h, y_{n+1}) (FSAL)
+        static constexpr double a[7][7] = {{},
+                                           {1.0 / 5.0},
+                                           {3.0 / 40.0, 9.0 / 40.0},
+                                           {44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0},
+                                           {19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0},
+                                           {9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0},
+                                           {35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0}};
+
+        // 5th-order solution weights (b₂ = b₇ = 0)
+        static constexpr double b[7] = {35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0, 0.0};
 
         // Error weights e = b − b̂  (embedded 4th-order)
-        static constexpr double e1 = -71.0 / 57600.0, e3 = 71.0 / 16695.0, e4 = -71.0 / 1920.0, e5 = 17253.0 / 339200.0, e6 = -22.0 / 525.0, e7 = 1.0 / 40.0;
+        static constexpr double e[7] = {-71.0 / 57600.0, 0.0, 71.0 / 16695.0, -71.0 / 1920.0, 17253.0 / 339200.0, -22.0 / 525.0, 1.0 / 40.0};
 
         // Dense-output polynomial: contributes p[i][j]*k[i] to the j-th degree
         // term (j = 1..4) of the continuous extension
@@ -53,6 +62,9 @@ class DoPri54 : public AdaptiveDES<DoPri54<N, HistoryPoints>, N, HistoryPoints,
                                            {0.0, 40617522.0 / 29380423.0, -110615467.0 / 29380423.0, 69997945.0 / 29380423.0}};
     };
 
+    using RK = ExplicitRK<Tableau>;
+    static_assert(RK::fsal, "DoPri54: stage 7 must be the FSAL stage");
+
   public:
     DoPri54()
     {
@@ -94,6 +106,11 @@ class DoPri54 : public AdaptiveDES<DoPri54<N, HistoryPoints>, N, HistoryPoints,
         return static_cast<int>(m_dense_hist.size());
     }
 
+    [[nodiscard]] const DenseHistory<N> &dense_history() const noexcept
+    {
+        return m_dense_hist;
+    }
+
     [[nodiscard]] const DenseSegment<N> &dense_segment(int i) const
     {
         if (i < 0 || i >= dense_history_size())
@@ -113,41 +130,32 @@ class DoPri54 : public AdaptiveDES<DoPri54<N, HistoryPoints>, N, HistoryPoints,
         return m_last.eval(t);
     }
 
-    // Binary search over dense history for the segment containing t — O(log n)
+    // Lookup in the retained dense history (see DenseRetention) — O(1) expected
     [[nodiscard]] Vec<N> interpolate(double t) const
     {
-        const int n = dense_history_size();
-        if (n == 0)
+        if (m_dense_hist.empty())
         {
             throw std::out_of_range("DoPri54: no dense segments stored");
         }
-        if (m_dense_hist.back().contains(t))
+        if (const DenseSegment<N> *seg = m_dense_hist.find(t))
         {
-            return m_dense_hist.back().eval(t);
+            return seg->eval(t);
         }
+        throw std::out_of_range("DoPri54: interpolation time outside stored dense history");
+    }
 
-        int lo = 0, hi = n - 1;
-        while (lo <= hi)
+    // interpolate() at every time in sorted_t (ordered in the integration
+    // direction), column j of `out` for sorted_t[j] — O(n + m) merge walk
+    void interpolate_many(ColumnView sorted_t, Eigen::Matrix<double, N, Eigen::Dynamic> &out) const
+    {
+        if (m_dense_hist.empty())
         {
-            const int mid = (lo + hi) / 2;
-            const auto &seg = m_dense_hist[static_cast<std::size_t>(mid)];
-            const double t1 = seg.t0 + seg.h;
-            const double eps = 64.0 * std::numeric_limits<double>::epsilon() * std::max(1.0, std::max(std::abs(seg.t0), std::abs(t1)));
-            const double dir = (seg.h >= 0.0) ? 1.0 : -1.0;
-            if ((dir > 0.0) ? (t < seg.t0 - eps) : (t > seg.t0 + eps))
-            {
-                hi = mid - 1;
-            }
-            else if ((dir > 0.0) ? (t > t1 + eps) : (t < t1 - eps))
-            {
-                lo = mid + 1;
-            }
-            else
-            {
-                return seg.eval(t);
-            }
+            throw std::out_of_range("DoPri54: no dense segments stored");
+        }
+        if (m_dense_hist.eval_many(sorted_t.data, sorted_t.size, out) != sorted_t.size)
+        {
+            throw std::out_of_range("DoPri54: interpolation times unsorted or outside stored dense history");
         }
-        throw std::out_of_range("DoPri54: interpolation time outside stored dense history");
     }
 
     [[nodiscard]] double interpolate_component(double t, int component) const
@@ -159,57 +167,41 @@ class DoPri54 : public AdaptiveDES<DoPri54<N, HistoryPoints>, N, HistoryPoints,
 
     void before_solve()
     {
-        m_last = {};
-        m_pending = {};
-        m_dense_hist.clear();
+        m_last.reset(this->dimension());
+        m_pending.reset(this->dimension());
+        m_dense_hist.reset(this->options.dense_retention, static_cast<std::size_t>(this->options.reserve_steps));
     }
 
     void after_step(double /*t*/)
     {
         m_last = m_pending;
-        m_dense_hist.push_back(m_pending);
+        m_dense_hist.push(m_pending);
     }
 
     // ── Step computation ─────────────────────────────────────────────────────
     //
     // solve_impl guarantees ws.k[0] = f(t, y) on entry (FSAL or fresh eval).
 
+    // Reduced by ExplicitRK in the pass that wrote ws.error
+    [[nodiscard]] double step_error_norm() const noexcept
+    {
+        return m_err_norm;
+    }
+
     template <typename RhsEval>
     void compute_step(double t, const Vec<N> &y, double h, RhsEval &&rhs, WorkspaceT &ws, SolverStats &stats)
     {
-        // Precompute scaled stage coefficients to avoid repeated multiplications
-        const double ha21 = h * C::a21;
-        const double ha31 = h * C::a31, ha32 = h * C::a32;
-        const double ha41 = h * C::a41, ha42 = h * C::a42, ha43 = h * C::a43;
-        const double ha51 = h * C::a51, ha52 = h * C::a52, ha53 = h * C::a53, ha54 = h * C::a54;
-        const double ha61 = h * C::a61, ha62 = h * C::a62, ha63 = h * C::a63, ha64 = h * C::a64, ha65 = h * C::a65;
-
-        rhs(t + C::c2 * h, y + ha21 * ws.k[0], ws.k[1]);
-        ++stats.rhs_evals;
-
-        rhs(t + C::c3 * h, y + ha31 * ws.k[0] + ha32 * ws.k[1], ws.k[2]);
-        ++stats.rhs_evals;
-
-        rhs(t + C::c4 * h, y + ha41 * ws.k[0] + ha42 * ws.k[1] + ha43 * ws.k[2], ws.k[3]);
-        ++stats.rhs_evals;
-
-        rhs(t + C::c5 * h, y + ha51 * ws.k[0] + ha52 * ws.k[1] + ha53 * ws.k[2] + ha54 * ws.k[3], ws.k[4]);
-        ++stats.rhs_evals;
-
-        rhs(t + C::c6 * h, y + ha61 * ws.k[0] + ha62 * ws.k[1] + ha63 * ws.k[2] + ha64 * ws.k[3] + ha65 * ws.k[4], ws.k[5]);
-        ++stats.rhs_evals;
-
-        // 5th-order solution (b₂ = 0)
-        ws.next = y + h * (C::b1 * ws.k[0] + C::b3 * ws.k[2] + C::b4 * ws.k[3] + C::b5 * ws.k[4] + C::b6 * ws.k[5]);
-
-        // Stage 7 = f(t+h, y_new): FSAL — reused as k[0] of the next step
-        rhs(t + h, ws.next, ws.k[6]);
-        ++stats.rhs_evals;
-
-        // Error estimate: difference between 5th and 4th-order solutions
-        ws.error = h * (C::e1 * ws.k[0] + C::e3 * ws.k[2] + C::e4 * ws.k[3] + C::e5 * ws.k[4] + C::e6 * ws.k[5] + C::e7 * ws.k[6]);
-
-        ws.fsal = ws.k[6];  // recycled by solve_impl as k[0] of next step
+        // Stages 2–7, y_{n+1}, error and ws.fsal = k[6] (recycled by
+        // solve_impl as k[0] of the next step)
+        if (this->owns_error_norm())
+        {
+            auto norm = this->error_norm_sum();
+            m_err_norm = RK::step(t, y, h, rhs, ws, stats, norm);
+        }
+        else
+        {
+            RK::step(t, y, h, rhs, ws, stats);
+        }
 
         build_dense(t, y, h, ws);
     }
@@ -217,7 +209,8 @@ class DoPri54 : public AdaptiveDES<DoPri54<N, HistoryPoints>, N, HistoryPoints,
   private:
     DenseSegment<N> m_last{};
     DenseSegment<N> m_pending{};
-    std::vector<DenseSegment<N>> m_dense_hist{};
+    DenseHistory<N> m_dense_hist{};
+    double m_err_norm = 0.0;
 
     // Build the Horner-form continuous extension for the current trial step.
     // Committed to m_last in after_step() only if the step is accepted.
@@ -227,13 +220,12 @@ class DoPri54 : public AdaptiveDES<DoPri54<N, HistoryPoints>, N, HistoryPoints,
         m_pending.h = h;
         m_pending.y0 = y;
         m_pending.valid = true;
+        m_pending.order = 4;
         m_pending.q[0] = ws.k[0];
 
-        m_pending.q[1] = C::p[0][1] * ws.k[0] + C::p[2][1] * ws.k[2] + C::p[3][1] * ws.k[3] + C::p[4][1] * ws.k[4] + C::p[5][1] * ws.k[5] + C::p[6][1] * ws.k[6];
-
-        m_pending.q[2] = C::p[0][2] * ws.k[0] + C::p[2][2] * ws.k[2] + C::p[3][2] * ws.k[3] + C::p[4][2] * ws.k[4] + C::p[5][2] * ws.k[5] + C::p[6][2] * ws.k[6];
-
-        m_pending.q[3] = C::p[0][3] * ws.k[0] + C::p[2][3] * ws.k[2] + C::p[3][3] * ws.k[3] + C::p[4][3] * ws.k[4] + C::p[5][3] * ws.k[5] + C::p[6][3] * ws.k[6];
+        RK::template combine<PRow<Tableau, 1>>(m_pending.q[1], 1.0, ws.k);
+        RK::template combine<PRow<Tableau, 2>>(m_pending.q[2], 1.0, ws.k);
+        RK::template combine<PRow<Tableau, 3>>(m_pending.q[3], 1.0, ws.k);
     }
 };
 
@@ -20,6 +20,12 @@
  *  • Error = h · (b − d) · k, implemented via precomputed e coefficients
  *  • Dense output: Hermite cubic O(h⁴) from endpoint function evaluations
  *    (one extra RHS eval per step; stored in ws.fsal, has_fsal() = false)
+ *  • DoPri87<N, H, DenseMode::HighOrder>: 7th-order continuous extension,
+ *    O(h⁸), from stages 1, 6–14 and four extra stages 15–18.  The extra
+ *    stages are only evaluated for steps a dense query hits (events,
+ *    uniform output, interpolate with the system); see refine_dense_step().
+ *    The default DenseMode::Standard stores only the cubic's three
+ *    coefficient vectors per segment
  *  • Recommended tolerances: rtol = atol = 1e-10 … 1e-14
  *
  *  Stage layout in Workspace<N,13>.k[0..12]:
@@ -36,11 +42,24 @@
  *    k[10] = stage 11
  *    k[11] = stage 12
  *    k[12] = stage 13  ← only in b13; d13 = 0
+ *    fsal  = stage 14  = f(t + h, y_{n+1})
+ *
+ *  Continuous extension (DenseMode::HighOrder)
+ *  ───────────────────────────────────────────
+ *  Bootstrapped in the manner of Enright, Jackson, Nørsett & Thomsen
+ *  (ACM TOMS 12, 1986): stage 15 evaluates the unique 5th-order extension
+ *  over stages 1–14 at c = 1/10; stages 16–18 evaluate the 6th-order
+ *  extension over stages 1–15 at c = 1/3, 1/2, 2/3.  The weights p below
+ *  are the unique solution of the order-7 continuous order conditions
+ *  (all 85 trees) over stages 1, 6–14, 16–18 with y(t+h) = y_{n+1} and
+ *  y'(t+h) = stage 14, solved in 60-digit arithmetic for this tableau.
  */
 
 #include "des_adaptive.hpp"
 #include "des_dense_output.hpp"
+#include "des_tableau.hpp"
 
+#include <array>
 #include <cmath>
 #include <limits>
 #include <stdexcept>
@@ -48,11 +67,17 @@
 
 namespace DES {
 
-template <int N, int HistoryPoints = 500>
-class DoPri87 : public AdaptiveDES<DoPri87<N, HistoryPoints>, N, HistoryPoints, 13> {
-    using Base = AdaptiveDES<DoPri87<N, HistoryPoints>, N, HistoryPoints, 13>;
+template <int N, int HistoryPoints = 500, DenseMode Mode = DenseMode::Standard>
+class DoPri87 : public AdaptiveDES<DoPri87<N, HistoryPoints, Mode>, N, HistoryPoints, 13> {
+    using Base = AdaptiveDES<DoPri87<N, HistoryPoints, Mode>, N, HistoryPoints, 13>;
     using WorkspaceT = Workspace<N, 13>;
 
+    // Coefficient vectors per segment: the Hermite cubic needs 3, the
+    // 7th-order extension 7
+    static constexpr bool kHighOrder = Mode == DenseMode::HighOrder;
+    static constexpr std::size_t kDenseQ = kHighOrder ? 7 : 3;
+    using Segment = DenseSegment<N, kDenseQ>;
+
     // ── Butcher tableau (Prince & Dormand 1981, verified against Hairer) ────
     struct C {
         // Abscissae
@@ -103,14 +128,85 @@ class DoPri87 : public AdaptiveDES<DoPri87<N, HistoryPoints>, N, HistoryPoints,
                                 b13 = 1.0 / 4.0;
 
         // 7th-order embedded weights d (stages 1, 6–12; d13 = 0)
-        static constexpr double d1 = 13451932.0 / 455176632.0, d6 = -808719846.0 / 976000145.0, d7 = 1757004468.0 / 5645159321.0, d8 = 656045339.0 / 265891186.0, d9 = -3867574721.0 / 1518517206.0, d10 = 465885868.0 / 322736535.0, d11 = 53011238.0 / 667516719.0, d12 = 2.0 / 45.0;
+        static constexpr double d6 = -808719846.0 / 976000145.0, d7 = 1757004468.0 / 5645159321.0, d8 = 656045339.0 / 265891186.0, d9 = -3867574721.0 / 1518517206.0, d10 = 465885868.0 / 322736535.0, d11 = 53011238.0 / 667516719.0, d12 = 2.0 / 45.0;
+
+        // The published d1 = 13451932 / 455176632 is rounded: it leaves
+        // Σd = 1 − 5.8e-10, so the error estimate carries a first-order
+        // term 5.8e-10·h·f that caps h near tol / (5.8e-10·|f|) once rtol
+        // approaches 1e-9.  Stage 1 enters no other order condition
+        // (c1 = 0), so fixing Σd = 1 through d1 is exact.
+        static constexpr double d1 = 1.0 - (d6 + d7 + d8 + d9 + d10 + d11 + d12);
+
 
         // Error weights e = b − d (compile-time)
         // e₁₃ = b₁₃ − d₁₃ = b₁₃ (since d₁₃ = 0)
         static constexpr double e1 = b1 - d1, e6 = b6 - d6, e7 = b7 - d7, e8 = b8 - d8, e9 = b9 - d9, e10 = b10 - d10, e11 = b11 - d11, e12 = b12 - d12,
                                 e13 = b13;  // d13 = 0
+
+        // ── Array form for ExplicitRK (zeros are dropped at compile time) ──
+        static constexpr int stages = 13;
+
+        static constexpr double c[13] = {0.0, c2, c3, c4, c5, c6, c7, c8, c9, c10, c11, 1.0, 1.0};
+
+        static constexpr double a[13][13] = {{},
+                                             {a21},
+                                             {a31, a32},
+                                             {a41, 0.0, a43},
+                                             {a51, 0.0, a53, a54},
+                                             {a61, 0.0, 0.0, a64, a65},
+                                             {a71, 0.0, 0.0, a74, a75, a76},
+                                             {a81, 0.0, 0.0, a84, a85, a86, a87},
+                                             {a91, 0.0, 0.0, a94, a95, a96, a97, a98},
+                                             {a101, 0.0, 0.0, a104, a105, a106, a107, a108, a109},
+                                             {a111, 0.0, 0.0, a114, a115, a116, a117, a118, a119, a1110},
+                                             {a121, 0.0, 0.0, a124, a125, a126, a127, a128, a129, a1210, a1211},
+                                             {a131, 0.0, 0.0, a134, a135, a136, a137, a138, a139, a1310, a1311, 0.0}};
+
+        static constexpr double b[13] = {b1, 0.0, 0.0, 0.0, 0.0, b6, b7, b8, b9, b10, b11, b12, b13};
+
+        static constexpr double e[13] = {e1, 0.0, 0.0, 0.0, 0.0, e6, e7, e8, e9, e10, e11, e12, e13};
+
+        // ── Continuous extension (DenseMode::HighOrder) ─────────────────────
+        // Stage 14 is f(t + h, y_{n+1}), i.e. a14j = bj; stages 2–5 never enter
+        static constexpr double c15 = 1.0 / 10.0, c16 = 1.0 / 3.0, c17 = 1.0 / 2.0, c18 = 2.0 / 3.0;
+
+        // Stage 15 (c = 1/10): from the 5th-order extension over stages 1–14
+        static constexpr double a151 = 0.0781642102363445, a156 = 0.19675523133498574, a157 = -0.026049336165904626, a158 = -0.11288956785432826, a159 = -0.1276235811509841, a1510 = 0.08642955057324335, a1511 = 0.02322469191152281, a1512 = -0.037046073574490086, a1513 = 0.03762491186128682, a1514 = -0.01859003717167613;
+
+        // Stage 16 (c = 1/3)
+        static constexpr double a161 = 0.04161506332669656, a166 = -0.25359401861641784, a167 = 0.2983894287945298, a168 = 0.6430994050628626, a169 = -0.5603073766254756, a1610 = 0.20427462200035243, a1611 = -0.0075403937229505434, a1612 = 0.03166333447491119, a1613 = -0.016336084665095316, a1614 = -0.01360276600331411, a1615 = -0.034327880692765794;
+
+        // Stage 17 (c = 1/2)
+        static constexpr double a171 = 0.060427463938928894, a176 = -0.47173275137873893, a177 = 0.4956664842592114, a178 = 1.236902837911764, a179 = -0.9775654490273267, a1710 = 0.3659445440521102, a1711 = -0.021820971857065243, a1712 = 0.04100714827974631, a1713 = -0.033974294917366775, a1714 = 0.0006529967467474306, a1715 = -0.1955080080080104;
+
+        // Stage 18 (c = 2/3)
+        static constexpr double a181 = 0.02662708865593707, a186 = -0.7505546191702664, a187 = 0.37374044803471124, a188 = 1.8693118652890715, a189 = -1.3842092945613327, a1810 = 0.5784067628592239, a1811 = -0.013426133902786014, a1812 = -0.023350285671927765, a1813 = -0.0031007815443689986, a1814 = 0.027549497371171218, a1815 = -0.03432788069276642;
+
+        // Dense-output polynomial: contributes p[i][j]*k[i] to the j-th degree
+        // term (j = 1..7); rows 2–5 and 15 are zero
+        static constexpr double p[18][7] = {{1.0040541961200473, -7.804545447256734, 29.928823462641528, -62.98598081198435, 74.16386959060796, -45.79445609827489, 11.52998259928797},
+                                            {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+                                            {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+                                            {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+                                            {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+                                            {0.257048254366158, 5.880550540183617, -14.000044367915137, -27.83378212045829, 131.8952353759576, -155.62215544627352, 59.36769543552832},
+                                            {-0.023913724760436326, 16.31927119607186, -96.14192340033175, 245.01144061059304, -321.41910460231674, 212.5938969927929, -56.10035426484772},
+                                            {-0.5864169560403281, 11.558604293599394, -125.2442383147725, 494.9969776012169, -913.413957940102, 793.4639912897126, -260.0714493042105},
+                                            {0.5941792373578795, -7.4475453726082215, 108.21023785578599, -473.6936393696089, 918.6695856756919, -820.7448705235084, 273.65229288307535},
+                                            {-0.2603169395723112, 10.51695677749873, -102.0300678591654, 383.29833122441846, -687.9835523653809, 587.793441460564, -190.67422926744047},
+                                            {0.026189061061802993, 1.8968904818507115, -17.090047447557478, 61.75047337775896, -108.340408961658, 91.25531318221553, -29.340222211161397},
+                                            {-0.09393990465230503, -3.2130179151185905, 24.905069474451736, -81.85541211487643, 135.00141870117398, -109.09491672328885, 34.1126889435576},
+                                            {0.08311677611947425, 2.842835445780045, -24.237809403142748, 84.81159160295783, -145.87308547400028, 121.299755866081, -38.676404813795315},
+                                            {0.0, -0.4999999999999935, 7.29999999999995, -32.24999999999985, 63.399999999999764, -57.74999999999982, 19.799999999999947},
+                                            {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+                                            {0.0, -24.30000000000034, 186.3000000000024, -546.7500000000072, 777.6000000000109, -538.6500000000084, 145.80000000000254},
+                                            {0.0, 6.399999999999746, -83.19999999999817, 319.9999999999945, -531.1999999999914, 403.1999999999934, -115.199999999998},
+                                            {0.0, -12.150000000000224, 105.30000000000157, -364.5000000000047, 607.5000000000072, -481.9500000000055, 145.80000000000166}};
     };
 
+    using RK = ExplicitRK<C>;
+    static_assert(!RK::fsal, "DoPri87: stage 13 is not an FSAL stage");
+
   public:
     DoPri87()
     {
@@ -135,14 +231,14 @@ class DoPri87 : public AdaptiveDES<DoPri87<N, HistoryPoints>, N, HistoryPoints,
         return false;
     }
 
-    // ── Dense output (Hermite cubic, O(h⁴)) ─────────────────────────────────
+    // ── Dense output (Hermite cubic, or 7th order with DenseMode::HighOrder)
 
     [[nodiscard]] bool has_dense_output() const noexcept
     {
         return m_last.valid;
     }
 
-    [[nodiscard]] const DenseSegment<N> &last_dense_step() const noexcept
+    [[nodiscard]] const Segment &last_dense_step() const noexcept
     {
         return m_last;
     }
@@ -152,7 +248,12 @@ class DoPri87 : public AdaptiveDES<DoPri87<N, HistoryPoints>, N, HistoryPoints,
         return static_cast<int>(m_dense_hist.size());
     }
 
-    [[nodiscard]] const DenseSegment<N> &dense_segment(int i) const
+    [[nodiscard]] const DenseHistory<N, kDenseQ> &dense_history() const noexcept
+    {
+        return m_dense_hist;
+    }
+
+    [[nodiscard]] const Segment &dense_segment(int i) const
     {
         if (i < 0 || i >= dense_history_size())
         {
@@ -171,41 +272,70 @@ class DoPri87 : public AdaptiveDES<DoPri87<N, HistoryPoints>, N, HistoryPoints,
         return m_last.eval(t);
     }
 
-    // Binary search over stored segments — O(log n)
+    // Lookup in the retained dense history (see DenseRetention) — O(1)
+    // expected.  With DenseMode::HighOrder, segments no query has refined
+    // yet still hold the Hermite cubic; the overloads taking the system
+    // refine them first.
     [[nodiscard]] Vec<N> interpolate(double t) const
     {
-        const int n = dense_history_size();
-        if (n == 0)
+        if (m_dense_hist.empty())
+        {
+            throw std::out_of_range("DoPri87: no dense segments stored");
+        }
+        if (const Segment *seg = m_dense_hist.find(t))
+        {
+            return seg->eval(t);
+        }
+        throw std::out_of_range("DoPri87: interpolation time outside stored dense history");
+    }
+
+    // interpolate() at every time in sorted_t (ordered in the integration
+    // direction), column j of `out` for sorted_t[j] — O(n + m) merge walk
+    void interpolate_many(ColumnView sorted_t, Eigen::Matrix<double, N, Eigen::Dynamic> &out) const
+    {
+        if (m_dense_hist.empty())
         {
             throw std::out_of_range("DoPri87: no dense segments stored");
         }
-        if (m_dense_hist.back().contains(t))
+        if (m_dense_hist.eval_many(sorted_t.data, sorted_t.size, out) != sorted_t.size)
         {
-            return m_dense_hist.back().eval(t);
+            throw std::out_of_range("DoPri87: interpolation times unsorted or outside stored dense history");
         }
+    }
 
-        int lo = 0, hi = n - 1;
-        while (lo <= hi)
+    // interpolate() after refining the segment containing t to 7th order
+    // (DenseMode::HighOrder).  Recomputes that step's stages from the
+    // stored start point: 18 evaluations of the ODE system `sys`, once per
+    // segment.  Not for use inside solve(); DDE systems are not supported.
+    template <typename System>
+    [[nodiscard]] Vec<N> interpolate(double t, System &sys)
+    {
+        if (m_dense_hist.empty())
         {
-            const int mid = (lo + hi) / 2;
-            const auto &seg = m_dense_hist[static_cast<std::size_t>(mid)];
-            const double t1 = seg.t0 + seg.h;
-            const double eps = 64.0 * std::numeric_limits<double>::epsilon() * std::max(1.0, std::max(std::abs(seg.t0), std::abs(t1)));
-            const double dir = (seg.h >= 0.0) ? 1.0 : -1.0;
-            if ((dir > 0.0) ? (t < seg.t0 - eps) : (t > seg.t0 + eps))
-            {
-                hi = mid - 1;
-            }
-            else if ((dir > 0.0) ? (t > t1 + eps) : (t < t1 - eps))
-            {
-                lo = mid + 1;
-            }
-            else
+            throw std::out_of_range("DoPri87: no dense segments stored");
+        }
+        if (Segment *seg = m_dense_hist.find(t))
+        {
+            refine_stored(*seg, sys);
+            return seg->eval(t);
+        }
+        throw std::out_of_range("DoPri87: interpolation time outside stored dense history");
+    }
+
+    template <typename System>
+    void interpolate_many(ColumnView sorted_t, Eigen::Matrix<double, N, Eigen::Dynamic> &out, System &sys)
+    {
+        if constexpr (kHighOrder)
+        {
+            for (double t : sorted_t)
             {
-                return seg.eval(t);
+                if (Segment *seg = m_dense_hist.find(t))
+                {
+                    refine_stored(*seg, sys);
+                }
             }
         }
-        throw std::out_of_range("DoPri87: interpolation time outside stored dense history");
+        interpolate_many(sorted_t, out);
     }
 
     [[nodiscard]] double interpolate_component(double t, int component) const
@@ -217,15 +347,39 @@ class DoPri87 : public AdaptiveDES<DoPri87<N, HistoryPoints>, N, HistoryPoints,
 
     void before_solve()
     {
-        m_last = {};
-        m_pending = {};
-        m_dense_hist.clear();
+        m_last.reset(this->dimension());
+        m_pending.reset(this->dimension());
+        for (auto &k : m_kx)
+        {
+            k.resize(this->dimension());
+        }
+        m_dense_hist.reset(this->options.dense_retention, static_cast<std::size_t>(this->options.reserve_steps));
     }
 
     void after_step(double /*t*/)
     {
         m_last = m_pending;
-        m_dense_hist.push_back(m_pending);
+        m_dense_hist.push(m_pending);
+    }
+
+    // Called by the base class before events or uniform output read
+    // last_dense_step().  The accepted step's stages are still in m_ws, so
+    // only the four extra stages are evaluated.
+    template <typename RhsEval>
+    void refine_dense_step(RhsEval &&rhs, SolverStats &stats)
+    {
+        if constexpr (kHighOrder)
+        {
+            if (m_last.order >= 7)
+            {
+                return;
+            }
+            extend_dense(m_last, this->m_ws, rhs, stats);
+            if (!m_dense_hist.empty() && m_dense_hist.back().t0 == m_last.t0)
+            {
+                m_dense_hist.back() = m_last;
+            }
+        }
     }
 
     // ── Step computation ─────────────────────────────────────────────────────
@@ -236,89 +390,102 @@ class DoPri87 : public AdaptiveDES<DoPri87<N, HistoryPoints>, N, HistoryPoints,
     //            ws.fsal  = f(t+h, y_{n+1}) for Hermite dense output
     //            m_pending = dense segment for this trial step
 
+    // Reduced by ExplicitRK in the pass that wrote ws.error
+    [[nodiscard]] double step_error_norm() const noexcept
+    {
+        return m_err_norm;
+    }
+
     template <typename RhsEval>
     void compute_step(double t, const Vec<N> &y, double h, RhsEval &&rhs, WorkspaceT &ws, SolverStats &stats)
     {
-        // Save f₀ for Hermite dense output (ws.k[0] is stage 1, not overwritten,
-        // but capturing it explicitly makes the intent clear)
-        const Vec<N> &f0 = ws.k[0];  // reference — k[0] is never overwritten below
-
-        // Precompute h·aᵢⱼ products to avoid repeated multiplications in stage sums
-        const double ha21 = h * C::a21;
-        const double ha31 = h * C::a31, ha32 = h * C::a32;
-        const double ha41 = h * C::a41, ha43 = h * C::a43;
-        const double ha51 = h * C::a51, ha53 = h * C::a53, ha54 = h * C::a54;
-        const double ha61 = h * C::a61, ha64 = h * C::a64, ha65 = h * C::a65;
-        const double ha71 = h * C::a71, ha74 = h * C::a74, ha75 = h * C::a75, ha76 = h * C::a76;
-        const double ha81 = h * C::a81, ha84 = h * C::a84, ha85 = h * C::a85, ha86 = h * C::a86, ha87 = h * C::a87;
-        const double ha91 = h * C::a91, ha94 = h * C::a94, ha95 = h * C::a95, ha96 = h * C::a96, ha97 = h * C::a97, ha98 = h * C::a98;
-        const double ha101 = h * C::a101, ha104 = h * C::a104, ha105 = h * C::a105, ha106 = h * C::a106, ha107 = h * C::a107, ha108 = h * C::a108, ha109 = h * C::a109;
-        const double ha111 = h * C::a111, ha114 = h * C::a114, ha115 = h * C::a115, ha116 = h * C::a116, ha117 = h * C::a117, ha118 = h * C::a118, ha119 = h * C::a119, ha1110 = h * C::a1110;
-        const double ha121 = h * C::a121, ha124 = h * C::a124, ha125 = h * C::a125, ha126 = h * C::a126, ha127 = h * C::a127, ha128 = h * C::a128, ha129 = h * C::a129, ha1210 = h * C::a1210, ha1211 = h * C::a1211;
-        const double ha131 = h * C::a131, ha134 = h * C::a134, ha135 = h * C::a135, ha136 = h * C::a136, ha137 = h * C::a137, ha138 = h * C::a138, ha139 = h * C::a139, ha1310 = h * C::a1310, ha1311 = h * C::a1311;
-
-        // ── Stages 2–13 ─────────────────────────────────────────────────────
-        // k[0] = f(t, y) was set by solve_impl; referenced by every stage below.
-
-        rhs(t + C::c2 * h, y + ha21 * ws.k[0], ws.k[1]);
-        ++stats.rhs_evals;
-
-        rhs(t + C::c3 * h, y + ha31 * ws.k[0] + ha32 * ws.k[1], ws.k[2]);
-        ++stats.rhs_evals;
-
-        rhs(t + C::c4 * h, y + ha41 * ws.k[0] + ha43 * ws.k[2], ws.k[3]);
-        ++stats.rhs_evals;
-
-        rhs(t + C::c5 * h, y + ha51 * ws.k[0] + ha53 * ws.k[2] + ha54 * ws.k[3], ws.k[4]);
-        ++stats.rhs_evals;
-
-        rhs(t + C::c6 * h, y + ha61 * ws.k[0] + ha64 * ws.k[3] + ha65 * ws.k[4], ws.k[5]);
-        ++stats.rhs_evals;
-
-        rhs(t + C::c7 * h, y + ha71 * ws.k[0] + ha74 * ws.k[3] + ha75 * ws.k[4] + ha76 * ws.k[5], ws.k[6]);
-        ++stats.rhs_evals;
-
-        rhs(t + C::c8 * h, y + ha81 * ws.k[0] + ha84 * ws.k[3] + ha85 * ws.k[4] + ha86 * ws.k[5] + ha87 * ws.k[6], ws.k[7]);
-        ++stats.rhs_evals;
+        // Stages 2–13, the 8th-order solution and the error h·(b−d)·k.
+        // ws.k[0] = f(t, y) is stage 1 and is never overwritten.
+        if (this->owns_error_norm())
+        {
+            auto norm = this->error_norm_sum();
+            m_err_norm = RK::step(t, y, h, rhs, ws, stats, norm);
+        }
+        else
+        {
+            RK::step(t, y, h, rhs, ws, stats);
+        }
 
-        rhs(t + C::c9 * h, y + ha91 * ws.k[0] + ha94 * ws.k[3] + ha95 * ws.k[4] + ha96 * ws.k[5] + ha97 * ws.k[6] + ha98 * ws.k[7], ws.k[8]);
+        // ── Dense output: Hermite cubic from f₀ and f₁ ──────────────────────
+        // One extra RHS evaluation per step; stored in ws.fsal (has_fsal=false
+        // so solve_impl never reads ws.fsal as a stage vector).
+        // The segment is only committed in after_step() if the step is accepted.
+        rhs(t + h, ws.next, ws.fsal);
         ++stats.rhs_evals;
 
-        rhs(t + C::c10 * h, y + ha101 * ws.k[0] + ha104 * ws.k[3] + ha105 * ws.k[4] + ha106 * ws.k[5] + ha107 * ws.k[6] + ha108 * ws.k[7] + ha109 * ws.k[8], ws.k[9]);
-        ++stats.rhs_evals;
+        build_hermite<N>(m_pending, t, y, h, ws.next, ws.k[0], ws.fsal);
+    }
 
-        rhs(t + C::c11 * h, y + ha111 * ws.k[0] + ha114 * ws.k[3] + ha115 * ws.k[4] + ha116 * ws.k[5] + ha117 * ws.k[6] + ha118 * ws.k[7] + ha119 * ws.k[8] + ha1110 * ws.k[9], ws.k[10]);
+  private:
+    Segment m_last{};
+    Segment m_pending{};
+    DenseHistory<N, kDenseQ> m_dense_hist{};
+    double m_err_norm = 0.0;
+    std::array<Vec<N>, kHighOrder ? 4 : 0> m_kx{};  // extra stages 15–18
+
+    // Extra stages 15–18 and the 7th-order coefficients.  Expects ws.k and
+    // ws.fsal to hold stages 1–14 of the step `seg` describes.  HighOrder
+    // only.
+    template <typename RhsEval>
+    void extend_dense(Segment &seg, WorkspaceT &ws, RhsEval &&rhs, SolverStats &stats)
+    {
+        const double t = seg.t0;
+        const double h = seg.h;
+        const Vec<N> &y = seg.y0;
+        const auto &k = ws.k;
+        const Vec<N> &f1 = ws.fsal;
+
+        ws.stage.noalias() = y + h * (C::a151 * k[0] + C::a156 * k[5] + C::a157 * k[6] + C::a158 * k[7] + C::a159 * k[8] + C::a1510 * k[9] + C::a1511 * k[10] + C::a1512 * k[11] + C::a1513 * k[12] + C::a1514 * f1);
+        rhs(t + C::c15 * h, ws.stage, m_kx[0]);
         ++stats.rhs_evals;
 
-        // Stage 12 (c12 = 1.0)
-        rhs(t + h, y + ha121 * ws.k[0] + ha124 * ws.k[3] + ha125 * ws.k[4] + ha126 * ws.k[5] + ha127 * ws.k[6] + ha128 * ws.k[7] + ha129 * ws.k[8] + ha1210 * ws.k[9] + ha1211 * ws.k[10], ws.k[11]);
+        ws.stage.noalias() = y + h * (C::a161 * k[0] + C::a166 * k[5] + C::a167 * k[6] + C::a168 * k[7] + C::a169 * k[8] + C::a1610 * k[9] + C::a1611 * k[10] + C::a1612 * k[11] + C::a1613 * k[12] + C::a1614 * f1 + C::a1615 * m_kx[0]);
+        rhs(t + C::c16 * h, ws.stage, m_kx[1]);
         ++stats.rhs_evals;
 
-        // Stage 13 (c13 = 1.0; a1312 = 0 — does NOT use ws.k[11])
-        rhs(t + h, y + ha131 * ws.k[0] + ha134 * ws.k[3] + ha135 * ws.k[4] + ha136 * ws.k[5] + ha137 * ws.k[6] + ha138 * ws.k[7] + ha139 * ws.k[8] + ha1310 * ws.k[9] + ha1311 * ws.k[10], ws.k[12]);
+        ws.stage.noalias() = y + h * (C::a171 * k[0] + C::a176 * k[5] + C::a177 * k[6] + C::a178 * k[7] + C::a179 * k[8] + C::a1710 * k[9] + C::a1711 * k[10] + C::a1712 * k[11] + C::a1713 * k[12] + C::a1714 * f1 + C::a1715 * m_kx[0]);
+        rhs(t + C::c17 * h, ws.stage, m_kx[2]);
         ++stats.rhs_evals;
 
-        // ── 8th-order solution ───────────────────────────────────────────────
-        ws.next = y + h * (C::b1 * ws.k[0] + C::b6 * ws.k[5] + C::b7 * ws.k[6] + C::b8 * ws.k[7] + C::b9 * ws.k[8] + C::b10 * ws.k[9] + C::b11 * ws.k[10] + C::b12 * ws.k[11] + C::b13 * ws.k[12]);
-
-        // ── Error estimate h·(b−d)·k ─────────────────────────────────────────
-        // e₁₃ = b₁₃ (d₁₃ = 0); all other eᵢ = bᵢ − dᵢ
-        ws.error = h * (C::e1 * ws.k[0] + C::e6 * ws.k[5] + C::e7 * ws.k[6] + C::e8 * ws.k[7] + C::e9 * ws.k[8] + C::e10 * ws.k[9] + C::e11 * ws.k[10] + C::e12 * ws.k[11] + C::e13 * ws.k[12]);
-
-        // ── Dense output: Hermite cubic from f₀ and f₁ ──────────────────────
-        // One extra RHS evaluation per step; stored in ws.fsal (has_fsal=false
-        // so solve_impl never reads ws.fsal as a stage vector).
-        // The segment is only committed in after_step() if the step is accepted.
-        rhs(t + h, ws.next, ws.fsal);
+        ws.stage.noalias() = y + h * (C::a181 * k[0] + C::a186 * k[5] + C::a187 * k[6] + C::a188 * k[7] + C::a189 * k[8] + C::a1810 * k[9] + C::a1811 * k[10] + C::a1812 * k[11] + C::a1813 * k[12] + C::a1814 * f1 + C::a1815 * m_kx[0]);
+        rhs(t + C::c18 * h, ws.stage, m_kx[3]);
         ++stats.rhs_evals;
 
-        m_pending = hermite_segment<N>(t, y, h, ws.next, f0, ws.fsal);
+        for (int j = 0; j < 7; ++j)
+        {
+            seg.q[j].noalias() = C::p[0][j] * k[0] + C::p[5][j] * k[5] + C::p[6][j] * k[6] + C::p[7][j] * k[7] + C::p[8][j] * k[8] + C::p[9][j] * k[9] + C::p[10][j] * k[10] + C::p[11][j] * k[11] + C::p[12][j] * k[12] + C::p[13][j] * f1 + C::p[15][j] * m_kx[1] + C::p[16][j] * m_kx[2] +
+                                 C::p[17][j] * m_kx[3];
+        }
+        seg.order = 7;
     }
 
-  private:
-    DenseSegment<N> m_last{};
-    DenseSegment<N> m_pending{};
-    std::vector<DenseSegment<N>> m_dense_hist{};
+    // Refine a stored segment after solve(): rebuild stages 1–14 from its
+    // start point, then extend.  Uses m_ws and m_pending as scratch.
+    template <typename System>
+    void refine_stored(Segment &seg, System &sys)
+    {
+        if constexpr (kHighOrder)
+        {
+            if (seg.order >= 7)
+            {
+                return;
+            }
+            auto rhs = [&](double ts, const Vec<N> &ys, Vec<N> &out) { sys(ts, ys, out); };
+            SolverStats scratch;
+            rhs(seg.t0, seg.y0, this->m_ws.k[0]);
+            compute_step(seg.t0, seg.y0, seg.h, rhs, this->m_ws, scratch);
+            extend_dense(seg, this->m_ws, rhs, scratch);
+            if (m_last.valid && m_last.t0 == seg.t0 && m_last.h == seg.h)
+            {
+                m_last = seg;
+            }
+        }
+    }
 };
 
 }  // namespace DES
\ No newline at end of file
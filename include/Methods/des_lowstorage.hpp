@@ -0,0 +1,290 @@
+#pragma once
+
+/*  des_lowstorage.hpp  –  DES namespace
+ *
+ *  Low-storage explicit Runge–Kutta pairs in Kennedy–Carpenter 2R+ form.
+ *
+ *  Reference: C. A. Kennedy, M. H. Carpenter and R. M. Lewis, Low-storage,
+ *  explicit Runge–Kutta schemes for the compressible Navier–Stokes
+ *  equations, Appl. Numer. Math. 35 (2000) 177–219.
+ *
+ *  A 2R scheme restricts the Butcher matrix to aᵢⱼ = bⱼ for j < i−1, so
+ *  stage i+1 is the running solution plus one multiple of the latest
+ *  derivative:
+ *
+ *      y_{n+1} += h·bᵢ·kᵢ
+ *      err     += h·eᵢ·kᵢ                       (e = b − b̂)
+ *      Y_{i+1}  = y_{n+1} + h·(a_{i+1,i} − bᵢ)·kᵢ
+ *
+ *  Three state-sized registers carry the step (solution, stage argument,
+ *  latest derivative) plus the error accumulator, whatever the number of
+ *  stages.  The workspace is LowStorageWorkspace<N>: next, stage, k[0] and
+ *  error — four vectors, against eleven for DoPri54 and seventeen for
+ *  DoPri87.  k[0] also ends the step holding the FSAL derivative, so there
+ *  is no separate endpoint copy.  The dense segment adds four more (y₀ and
+ *  three Hermite coefficients) only when dense output is used.  Intended
+ *  for large explicit systems (method of lines) where stage traffic, not
+ *  arithmetic, bounds the step.
+ *
+ *  Tableaux
+ *  ────────
+ *  KCL32  RK3(2)4[2R+]C — 4 stages, 3rd order, 2nd-order embedded estimate
+ *  KCL43  RK4(3)5[2R+]C — 5 stages, 4th order, 3rd-order embedded estimate
+ *
+ *  Both satisfy their order conditions (and the embedded ones) to ~1e-11
+ *  with the published rational coefficients.
+ *
+ *  Properties
+ *  ──────────
+ *  • f(t+h, y_{n+1}) is evaluated at the end of each step and reused as
+ *    stage 1 of the next (FSAL), so an accepted step still costs s RHS
+ *    calls and the endpoint derivative is free for dense output and DDE
+ *    history
+ *  • Dense output is the cubic Hermite interpolant through both endpoints
+ *    (order 3), held in a single segment with no separate pending copy.
+ *    A trial step only records y_n and f_n in it; the cubic terms are
+ *    formed in after_step(), for accepted steps alone.  With
+ *    DenseRetention::None, no events and no uniform output nothing reads
+ *    the segment and it is not built at all (last_dense_step() stays
+ *    invalid)
+ *  • Breaking-point enforcement and event detection via AdaptiveDES
+ */
+
+#include "../des_adaptive.hpp"
+#include "../des_dense_output.hpp"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace DES {
+
+// ---------------------------------------------------------------------------
+// 2R+ tableaux — subdiagonal a[i] = a_{i+1,i}, weights b and embedded b̂
+// ---------------------------------------------------------------------------
+
+struct KCL32 {
+    static constexpr int stages = 4;
+    static constexpr int order = 3;
+    static constexpr int embedded_order = 2;
+
+    static constexpr double a[stages - 1] = {11847461282814.0 / 36547543011857.0, 3943225443063.0 / 7078155732230.0, -346793006927.0 / 4029903576067.0};
+
+    static constexpr double b[stages] = {1017324711453.0 / 9774461848756.0, 8237718856693.0 / 13685301971492.0, 57731312506979.0 / 19404895981398.0, -101169746363290.0 / 37734290219643.0};
+
+    static constexpr double bhat[stages] = {15763415370699.0 / 46270243929542.0, 514528521746.0 / 5659431552419.0, 27030193851939.0 / 9429696342944.0, -69544964788955.0 / 30262026368149.0};
+};
+
+struct KCL43 {
+    static constexpr int stages = 5;
+    static constexpr int order = 4;
+    static constexpr int embedded_order = 3;
+
+    static constexpr double a[stages - 1] = {970286171893.0 / 4311952581923.0, 6584761158862.0 / 12103376702013.0, 2251764453980.0 / 15575788980749.0, 26877169314380.0 / 34165994151039.0};
+
+    static constexpr double b[stages] = {1153189308089.0 / 22510343858157.0, 1772645290293.0 / 4653164025191.0, -1672844663538.0 / 4480602732383.0, 2114624349019.0 / 3568978502595.0, 5198255086312.0 / 14908931495163.0};
+
+    static constexpr double bhat[stages] = {1016888040809.0 / 7410784769900.0, 11231460423587.0 / 58533540763752.0, -1563879915014.0 / 6823010717585.0, 606302364029.0 / 971179775848.0, 1097981568119.0 / 3980877426433.0};
+};
+
+// ---------------------------------------------------------------------------
+// LowStorageRK<N, Tableau, HistoryPoints>
+// ---------------------------------------------------------------------------
+
+template <int N, typename Tableau = KCL43, int HistoryPoints = 1000>
+class LowStorageRK : public AdaptiveDES<LowStorageRK<N, Tableau, HistoryPoints>, N, HistoryPoints, 1, LowStorageWorkspace<N>> {
+    using Base = AdaptiveDES<LowStorageRK<N, Tableau, HistoryPoints>, N, HistoryPoints, 1, LowStorageWorkspace<N>>;
+    using WorkspaceT = LowStorageWorkspace<N>;
+    using Segment = DenseSegment<N, 3>;  // cubic Hermite
+
+    static constexpr int S = Tableau::stages;
+
+  public:
+    LowStorageRK()
+    {
+        this->options.controller.kind = ControllerKind::PI;
+        this->options.controller.safety = 0.9;
+        this->options.controller.min_factor = 0.2;
+        this->options.controller.max_factor = 5.0;
+    }
+
+    // ── CRTP capability queries ─────────────────────────────────────────────
+
+    [[nodiscard]] static constexpr int method_order()
+    {
+        return Tableau::order;
+    }
+    [[nodiscard]] static constexpr int adaptive_order()
+    {
+        return Tableau::embedded_order;
+    }
+    [[nodiscard]] static constexpr bool has_fsal()
+    {
+        return true;
+    }
+
+    // ── Dense output ────────────────────────────────────────────────────────
+
+    [[nodiscard]] bool has_dense_output() const noexcept
+    {
+        return m_last.valid;
+    }
+
+    [[nodiscard]] const Segment &last_dense_step() const noexcept
+    {
+        return m_last;
+    }
+
+    [[nodiscard]] int dense_history_size() const noexcept
+    {
+        return static_cast<int>(m_dense_hist.size());
+    }
+
+    [[nodiscard]] const DenseHistory<N, 3> &dense_history() const noexcept
+    {
+        return m_dense_hist;
+    }
+
+    [[nodiscard]] const Segment &dense_segment(int i) const
+    {
+        if (i < 0 || i >= dense_history_size())
+        {
+            throw std::out_of_range("LowStorageRK: dense history index out of range");
+        }
+        return m_dense_hist[static_cast<std::size_t>(i)];
+    }
+
+    [[nodiscard]] Vec<N> dense_eval_theta(double theta) const
+    {
+        return m_last.eval_theta(theta);
+    }
+
+    [[nodiscard]] Vec<N> dense_eval(double t) const
+    {
+        return m_last.eval(t);
+    }
+
+    // Lookup in the retained dense history (see DenseRetention) — O(1) expected
+    [[nodiscard]] Vec<N> interpolate(double t) const
+    {
+        if (m_dense_hist.empty())
+        {
+            throw std::out_of_range("LowStorageRK: no dense segments stored");
+        }
+        if (const Segment *seg = m_dense_hist.find(t))
+        {
+            return seg->eval(t);
+        }
+        throw std::out_of_range("LowStorageRK: interpolation time outside stored dense history");
+    }
+
+    // interpolate() at every time in sorted_t (ordered in the integration
+    // direction), column j of `out` for sorted_t[j] — O(n + m) merge walk
+    void interpolate_many(ColumnView sorted_t, Eigen::Matrix<double, N, Eigen::Dynamic> &out) const
+    {
+        if (m_dense_hist.empty())
+        {
+            throw std::out_of_range("LowStorageRK: no dense segments stored");
+        }
+        if (m_dense_hist.eval_many(sorted_t.data, sorted_t.size, out) != sorted_t.size)
+        {
+            throw std::out_of_range("LowStorageRK: interpolation times unsorted or outside stored dense history");
+        }
+    }
+
+    [[nodiscard]] double interpolate_component(double t, int component) const
+    {
+        return interpolate(t)[component];
+    }
+
+    // ── Lifecycle hooks ──────────────────────────────────────────────────────
+
+    void before_solve()
+    {
+        const auto &o = this->options;
+        m_last.reset(this->dimension());
+        m_dense_hist.reset(o.dense_retention, static_cast<std::size_t>(o.reserve_steps));
+        m_dense = o.dense_retention.kind != DenseRetention::Kind::None || !o.events.empty() || o.uniform_output;
+    }
+
+    // Completes the Hermite segment begun in compute_step(): y_{n+1} and
+    // f(t+h, y_{n+1}) are still in ws.next and ws.k[0]
+    void after_step(double /*t*/)
+    {
+        if (!m_dense)
+        {
+            return;
+        }
+
+        const Vec<N> &y1 = this->m_ws.next;
+        const Vec<N> &f1 = this->m_ws.k[0];
+        const double inv_h = 1.0 / m_last.h;
+        m_last.q[1].noalias() = (3.0 * inv_h) * (y1 - m_last.y0) - 2.0 * m_last.q[0] - f1;
+        m_last.q[2].noalias() = (-2.0 * inv_h) * (y1 - m_last.y0) + m_last.q[0] + f1;
+        m_last.valid = true;
+        m_dense_hist.push(m_last);
+    }
+
+    // ── Step computation ─────────────────────────────────────────────────────
+    //
+    // solve_impl guarantees ws.k[0] = f(t, y) on entry (FSAL or fresh eval).
+    // Stages 2..s overwrite ws.k[0], which ends the step holding
+    // f(t+h, y_{n+1}); a rejected step gets f(t, y) re-evaluated.
+
+    template <typename RhsEval>
+    void compute_step(double t, const Vec<N> &y, double h, RhsEval &&rhs, WorkspaceT &ws, SolverStats &stats)
+    {
+        // Left end of the Hermite segment, taken before k[0] is overwritten;
+        // only after_step() forms the rest and marks it valid, so a
+        // rejected trial never reaches events or the dense history
+        if (m_dense)
+        {
+            m_last.t0 = t;
+            m_last.h = h;
+            m_last.y0 = y;
+            m_last.q[0] = ws.k[0];
+            m_last.order = 3;
+            m_last.valid = false;
+        }
+
+        ws.next = y;
+        ws.error.setZero();
+
+        Vec<N> &k = ws.k[0];
+        double c_base = 0.0;  // Σ_{j<i−1} bⱼ, so cᵢ = c_base + a_{i,i−1}
+
+        for (int i = 0; i < S; ++i)
+        {
+            if (i > 0)
+            {
+                rhs(t + (c_base + Tableau::a[i - 1]) * h, ws.stage, k);
+                ++stats.rhs_evals;
+                c_base += Tableau::b[i - 1];
+            }
+
+            ws.next.noalias() += (h * Tableau::b[i]) * k;
+            ws.error.noalias() += (h * (Tableau::b[i] - Tableau::bhat[i])) * k;
+            if (i + 1 < S)
+            {
+                ws.stage.noalias() = ws.next + (h * (Tableau::a[i] - Tableau::b[i])) * k;
+            }
+        }
+
+        rhs(t + h, ws.next, k);
+        ++stats.rhs_evals;
+    }
+
+  private:
+    Segment m_last{};
+    DenseHistory<N, 3> m_dense_hist{};
+    bool m_dense = true;  // anything reads the segment (set in before_solve())
+};
+
+template <int N, int HistoryPoints = 1000>
+using LowStorage32 = LowStorageRK<N, KCL32, HistoryPoints>;
+
+template <int N, int HistoryPoints = 1000>
+using LowStorage43 = LowStorageRK<N, KCL43, HistoryPoints>;
+
+}  // namespace DES
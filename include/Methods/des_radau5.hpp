@@ -0,0 +1,605 @@
+#pragma once
+
+/*  des_radau5.hpp  –  DES namespace
+ *
+ *  Radau5 — 3-stage Radau IIA collocation method (order 5) for stiff ODEs
+ *  and DDEs.
+ *
+ *  The stage increments Z_i = Y_i − y_n solve the collocation system
+ *
+ *      Z = h (A ⊗ I) F(Z),     F(Z)_i = f(t_n + c_i h, y_n + Z_i),
+ *
+ *  by simplified Newton iterations with a frozen Jacobian J.  With
+ *  A⁻¹ = T Λ T⁻¹, Λ = diag(γ̂, [α̂ −β̂; β̂ α̂]), and W = (T⁻¹ ⊗ I) Z, every
+ *  iteration decouples into one real and one complex N×N system
+ *
+ *      (γ̂/h · I − J) ΔW₁         = r₁,
+ *      ((α̂ + iβ̂)/h · I − J) (ΔW₂ + iΔW₃) = r₂ + i r₃,
+ *
+ *  so a step factors two N×N matrices instead of one 3N×3N matrix.
+ *
+ *  References
+ *  ──────────
+ *  • E. Hairer, G. Wanner.
+ *    Solving Ordinary Differential Equations II — Stiff and
+ *    Differential-Algebraic Problems.
+ *    2nd ed., Springer, 1996.  §IV.8 (implementation of RADAU5).
+ *
+ *  • E. Hairer, G. Wanner.  RADAU5 Fortran code, version of 1996/2002.
+ *
+ *  Properties
+ *  ──────────
+ *  • 3 stages, order 5 (stage order 3), embedded error estimate of order 3
+ *  • L-stable and stiffly accurate: y_{n+1} = Y₃
+ *  • Simplified Newton with J kept across steps while the iteration
+ *    contracts fast (θ ≤ jac_reuse_theta); both factorizations are kept
+ *    while h / h_W stays in [w_keep_low, w_keep_high], h_W being the step
+ *    size they were computed for — the residual always uses the current h,
+ *    so a stale matrix only slows convergence
+ *  • Newton divergence or slow convergence rejects the step and shrinks h
+ *    directly through step_failure(), without an error estimate (counted
+ *    in SolverStats::newton_failures)
+ *  • Jacobian sources, as for Rosenbrock4: analytical .jacobian(), forward-
+ *    mode autodiff through a Dual-templated RHS, dense finite differences
+ *  • Dense output: the collocation polynomial (cubic through y_n, Y₁, Y₂,
+ *    Y₃), O(h⁴) uniformly and bounded on stiff components.  Breaking points
+ *    and events work through AdaptiveDES like for the other solvers.
+ *
+ *  Error estimate
+ *  ──────────────
+ *      err = (γ̂/h · I − J)⁻¹ (f(t_n, y_n) + (e₁ Z₁ + e₂ Z₂ + e₃ Z₃) / h)
+ *
+ *  with (e₁, e₂, e₃) = (−(13 + 7√6)/3, (−13 + 7√6)/3, −1/3).  On the first
+ *  step and after a rejection, an estimate above 1 is filtered once more
+ *  through f(t_n, y_n + err), which removes the O(1) growth on very stiff
+ *  components (Hairer & Wanner §IV.8).
+ *
+ *  DDE usage
+ *  ─────────
+ *  The stage abscissae t_n + c_i h lie inside the step, so delayed
+ *  arguments must stay behind t_n: AdaptiveDES caps h at min_delay, as for
+ *  the explicit solvers.  J is taken with respect to the current state only.
+ */
+
+#include "des_adaptive.hpp"
+#include "des_dense_output.hpp"
+#include "des_jacobian.hpp"
+
+#include <Eigen/LU>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <stdexcept>
+
+namespace DES {
+
+template <int N, int HistoryPoints = 1000>
+class Radau5 : public AdaptiveDES<Radau5<N, HistoryPoints>, N, HistoryPoints, 4> {
+    using Base = AdaptiveDES<Radau5<N, HistoryPoints>, N, HistoryPoints, 4>;
+    using CMat = Eigen::Matrix<std::complex<double>, N, N>;
+    using CVec = Eigen::Matrix<std::complex<double>, N, 1>;
+    using WorkspaceT = Workspace<N, 4>;
+
+    // ── Radau IIA (s = 3) constants, as in Hairer's RADAU5 ─────────────────
+    struct C {
+        static constexpr double c1 = 0.15505102572168219018;  // (4 − √6)/10
+        static constexpr double c2 = 0.64494897427831780982;  // (4 + √6)/10
+
+        // Eigenvalues of A⁻¹: γ̂ (real), α̂ ± iβ̂
+        static constexpr double u1 = 3.6378342527444957322;
+        static constexpr double alph = 2.6810828736277521339;
+        static constexpr double beta = 3.0504301992474105694;
+
+        // A⁻¹ = T Λ T⁻¹ (t32 = 1, t33 = 0)
+        static constexpr double t11 = 9.1232394870892942792e-02, t12 = -0.14125529502095420843, t13 = -3.0029194105147424492e-02;
+        static constexpr double t21 = 0.24171793270710701896, t22 = 0.20412935229379993199, t23 = 0.38294211275726193779;
+        static constexpr double t31 = 0.96604818261509293619;
+
+        static constexpr double ti11 = 4.3255798900631553510, ti12 = 0.33919925181580986954, ti13 = 0.54177053993587487119;
+        static constexpr double ti21 = -4.1787185915519047273, ti22 = -0.32768282076106238708, ti23 = 0.47662355450055045196;
+        static constexpr double ti31 = -0.50287263494578687595, ti32 = 2.5719269498556054292, ti33 = -0.59603920482822492497;
+
+        // Error-estimate weights
+        static constexpr double e1 = -10.048809399827416, e2 = 1.3821427331607488, e3 = -1.0 / 3.0;
+
+        // Collocation polynomial P(θ) = θ (a₀ + a₁θ + a₂θ²) with P(c₁) = Z₁,
+        // P(c₂) = Z₂, P(1) = Z₃:  a_k = Σᵢ v_ki Zᵢ
+        static constexpr double v[3][3] = {
+            {10.048809399827416, -1.3821427331607488, 1.0 / 3.0},
+            {-25.629591447076638, 10.296258113743306, -8.0 / 3.0},
+            {15.580782047249224, -8.9141153805825564, 10.0 / 3.0},
+        };
+    };
+
+  public:
+    // Finite-difference epsilon for Jacobian approximation.
+    // Perturbation for component j: fd_eps * max(|y[j]|, min(1, atol_j))
+    double fd_eps = 1.0e-7;
+
+    // Newton iterations per step before the step is rejected (Hairer: 7)
+    int max_newton_iters = 7;
+
+    // Keep J for the next step when the accepted step's Newton contraction
+    // rate θ is at or below this (Hairer: 0.001).  Negative: new J every step.
+    double jac_reuse_theta = 0.001;
+
+    // Keep both factorizations while h / h_W ∈ [w_keep_low, w_keep_high]
+    // (Hairer's quot1 / quot2)
+    double w_keep_low = 1.0;
+    double w_keep_high = 1.2;
+
+    // Newton stopping tolerance κ relative to the error tolerance; 0 →
+    // max(10 ε / rtol, min(0.03, √rtol)) as in RADAU5
+    double newton_tol = 0.0;
+
+    Radau5()
+    {
+        this->options.controller.kind = ControllerKind::Gustafsson;
+        this->options.controller.safety = 0.9;
+        this->options.controller.min_factor = 0.2;
+        this->options.controller.max_factor = 8.0;
+        this->options.h_max = 1.0;
+    }
+
+    // ── CRTP capability queries ─────────────────────────────────────────────
+
+    [[nodiscard]] static constexpr int method_order()
+    {
+        return 5;
+    }
+    [[nodiscard]] static constexpr int adaptive_order()
+    {
+        return 3;
+    }
+    [[nodiscard]] static constexpr bool has_fsal()
+    {
+        return false;
+    }
+
+    // Factor to shrink h by after a failed Newton iteration, else 0
+    [[nodiscard]] double step_failure() const noexcept
+    {
+        return m_newton_shrink;
+    }
+
+    // ── Dense output (collocation polynomial, O(h⁴)) ───────────────────────
+
+    [[nodiscard]] bool has_dense_output() const noexcept
+    {
+        return m_last.valid;
+    }
+
+    [[nodiscard]] const DenseSegment<N> &last_dense_step() const noexcept
+    {
+        return m_last;
+    }
+
+    [[nodiscard]] int dense_history_size() const noexcept
+    {
+        return static_cast<int>(m_dense_hist.size());
+    }
+
+    [[nodiscard]] const DenseHistory<N> &dense_history() const noexcept
+    {
+        return m_dense_hist;
+    }
+
+    [[nodiscard]] const DenseSegment<N> &dense_segment(int i) const
+    {
+        if (i < 0 || i >= dense_history_size())
+        {
+            throw std::out_of_range("Radau5: dense history index out of range");
+        }
+        return m_dense_hist[static_cast<std::size_t>(i)];
+    }
+
+    [[nodiscard]] Vec<N> interpolate(double t) const
+    {
+        if (m_dense_hist.empty())
+        {
+            throw std::out_of_range("Radau5: no dense segments stored");
+        }
+        if (const DenseSegment<N> *seg = m_dense_hist.find(t))
+        {
+            return seg->eval(t);
+        }
+        throw std::out_of_range("Radau5: interpolation time outside dense history");
+    }
+
+    // interpolate() at every time in sorted_t (ordered in the integration
+    // direction), column j of `out` for sorted_t[j] — O(n + m) merge walk
+    void interpolate_many(ColumnView sorted_t, Eigen::Matrix<double, N, Eigen::Dynamic> &out) const
+    {
+        if (m_dense_hist.empty())
+        {
+            throw std::out_of_range("Radau5: no dense segments stored");
+        }
+        if (m_dense_hist.eval_many(sorted_t.data, sorted_t.size, out) != sorted_t.size)
+        {
+            throw std::out_of_range("Radau5: interpolation times unsorted or outside stored dense history");
+        }
+    }
+
+    [[nodiscard]] double interpolate_component(double t, int component) const
+    {
+        return interpolate(t)[component];
+    }
+
+    // ── solve() overloads ─────────────────────────────────────────────────────
+    //
+    // These shadow the base-class overloads so that setup_jacobian() is called
+    // exactly once per solve, before the integration loop begins.
+
+    // ODE — no observer
+    template <typename System>
+    SolveResult solve(Vec<N> &y, double t0, double t1, System &sys)
+    {
+        setup_jacobian(sys, y.size());
+        typename Base::NoOpObserver obs;
+        return Base::solve(y, t0, t1, sys, obs);
+    }
+
+    // ODE — with observer
+    template <typename System, typename Observer>
+    SolveResult solve(Vec<N> &y, double t0, double t1, System &sys, Observer &&obs)
+    {
+        setup_jacobian(sys, y.size());
+        return Base::solve(y, t0, t1, sys, std::forward<Observer>(obs));
+    }
+
+    // DDE — no observer
+    template <typename System>
+    SolveResult solve(Vec<N> &y, double t0, double t1, System &sys, typename Base::DelayHistoryStorage &dh)
+    {
+        setup_jacobian(sys, y.size());
+        typename Base::NoOpObserver obs;
+        return Base::solve(y, t0, t1, sys, dh, obs);
+    }
+
+    // DDE — with observer
+    template <typename System, typename Observer>
+    SolveResult solve(Vec<N> &y, double t0, double t1, System &sys, typename Base::DelayHistoryStorage &dh, Observer &&obs)
+    {
+        setup_jacobian(sys, y.size());
+        return Base::solve(y, t0, t1, sys, dh, std::forward<Observer>(obs));
+    }
+
+    // ── Lifecycle hooks ──────────────────────────────────────────────────────
+
+    // All N- and N×N-sized scratch lives in members sized here, so the step
+    // loop itself never allocates — also for N = Eigen::Dynamic.
+    void before_solve()
+    {
+        if (!(max_newton_iters >= 2))
+        {
+            throw std::invalid_argument("DES: Radau5 max_newton_iters must be at least 2");
+        }
+        if (!(w_keep_low > 0.0) || !(w_keep_high >= w_keep_low))
+        {
+            throw std::invalid_argument("DES: Radau5 needs 0 < w_keep_low <= w_keep_high");
+        }
+
+        const Eigen::Index n = this->dimension();
+        m_last.reset(n);
+        m_pending.reset(n);
+        m_dense_hist.reset(this->options.dense_retention, static_cast<std::size_t>(this->options.reserve_steps));
+
+        m_jac.resize(n);
+        m_jac.set_fd_floor([this](Eigen::Index j) { return this->component_atol(static_cast<int>(j)); });
+        m_E2.resize(n, n);
+        if constexpr (N == Eigen::Dynamic)
+        {
+            // fixed N: the default-constructed LU already has its size
+            m_lu2 = Eigen::PartialPivLU<CMat>(n);
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+            m_z[i].resize(n);
+            m_w[i].resize(n);
+        }
+        m_f0.resize(n);
+        m_scal.resize(n);
+        m_cw.resize(n);
+
+        m_need_jac = true;
+        m_jac_current = false;
+        m_w_h = 0.0;
+        m_retry = false;
+        m_first = true;
+        m_theta = 0.0;
+        m_faccon = 1.0;
+        m_newton_shrink = 0.0;
+    }
+
+    void after_step(double /*t*/)
+    {
+        m_last = m_pending;
+        m_dense_hist.push(m_pending);
+
+        m_retry = false;
+        m_first = false;
+        m_jac_current = false;
+        m_need_jac = !(m_theta <= jac_reuse_theta);
+    }
+
+    // ── Step computation ─────────────────────────────────────────────────────
+    //
+    // On entry: ws.k[0] = f(t, y)  (set by solve_impl; has_fsal = false).
+    // ws.k[1..3] hold the stage RHS values of the current Newton iterate.
+    //
+    // A step whose Newton iteration diverges or converges too slowly is
+    // reported through step_failure(); AdaptiveDES rejects it and retries
+    // with h scaled by the factor newton_failed() recorded.
+
+    template <typename RhsEval>
+    void compute_step(double t, const Vec<N> &y, double h, RhsEval &&rhs, WorkspaceT &ws, SolverStats &stats)
+    {
+        const Eigen::Index n = y.size();
+        m_f0 = ws.k[0];
+        m_newton_shrink = 0.0;
+
+        // A call without an accepted step since the previous one retries a
+        // rejected step from the same (t, y); an old J is replaced then.
+        const bool retry = m_retry;
+        m_retry = true;
+        if (retry && !m_jac_current)
+        {
+            m_need_jac = true;
+        }
+
+        // ── Jacobian at (t, y) and the two factorizations ───────────────────
+        bool refactor = (m_w_h == 0.0);
+        if (m_need_jac)
+        {
+            m_jac.evaluate(t, y, m_f0, rhs, fd_eps, stats);
+            m_need_jac = false;
+            m_jac_current = true;
+            refactor = true;
+        }
+        const double quot = refactor ? 0.0 : h / m_w_h;
+        if (refactor || !(quot >= w_keep_low && quot <= w_keep_high))
+        {
+            factor(h);
+            stats.lu_decompositions += 2;
+        }
+
+        const double rtol = this->options.rtol;
+        for (Eigen::Index i = 0; i < n; ++i)
+        {
+            m_scal[i] = this->component_atol(static_cast<int>(i)) + rtol * std::abs(y[i]);
+        }
+        const double eps = std::numeric_limits<double>::epsilon();
+        const double fnewt = (newton_tol > 0.0) ? newton_tol : std::max(10.0 * eps / rtol, std::min(0.03, std::sqrt(rtol)));
+
+        // ── Starting values: previous collocation polynomial, extrapolated ─
+        start_values(t, y, h);
+
+        // ── Simplified Newton iteration ─────────────────────────────────────
+        const double fac1 = C::u1 / h;
+        const double alphn = C::alph / h;
+        const double betan = C::beta / h;
+
+        m_faccon = std::pow(std::max(m_faccon, eps), 0.8);
+        m_theta = std::abs(jac_reuse_theta);
+        double dynold = 0.0;
+        double thqold = 0.0;
+        bool converged = false;
+
+        for (int newt = 1; newt <= max_newton_iters; ++newt)
+        {
+            // F(Z) at the three stage points
+            ws.stage.noalias() = y + m_z[0];
+            rhs(t + C::c1 * h, ws.stage, ws.k[1]);
+            ws.stage.noalias() = y + m_z[1];
+            rhs(t + C::c2 * h, ws.stage, ws.k[2]);
+            ws.stage.noalias() = y + m_z[2];
+            rhs(t + h, ws.stage, ws.k[3]);
+            stats.rhs_evals += 3;
+            ++stats.newton_iters;
+
+            // Transformed residuals → increments (ws.next/ws.error/ws.stage
+            // are free scratch until the step is finished)
+            Vec<N> &d1 = ws.next;
+            Vec<N> &d2 = ws.error;
+            Vec<N> &d3 = ws.stage;
+            d1.noalias() = C::ti11 * ws.k[1] + C::ti12 * ws.k[2] + C::ti13 * ws.k[3] - fac1 * m_w[0];
+            d2.noalias() = C::ti21 * ws.k[1] + C::ti22 * ws.k[2] + C::ti23 * ws.k[3] - alphn * m_w[1] + betan * m_w[2];
+            d3.noalias() = C::ti31 * ws.k[1] + C::ti32 * ws.k[2] + C::ti33 * ws.k[3] - betan * m_w[1] - alphn * m_w[2];
+
+            m_jac.solve(d1, d1);
+            m_cw.real() = d2;
+            m_cw.imag() = d3;
+            m_cw = m_lu2.solve(m_cw);
+            d2 = m_cw.real();
+            d3 = m_cw.imag();
+
+            const double dyno = std::sqrt(((d1.array() / m_scal.array()).square() + (d2.array() / m_scal.array()).square() + (d3.array() / m_scal.array()).square()).sum() / static_cast<double>(3 * n));
+            if (!std::isfinite(dyno))
+            {
+                newton_failed(0.5, stats);
+                return;
+            }
+
+            // Contraction rate θ; give up early when the iteration cannot
+            // reach fnewt within max_newton_iters
+            if (newt > 1 && newt < max_newton_iters)
+            {
+                const double thq = dyno / dynold;
+                m_theta = (newt == 2) ? thq : std::sqrt(thq * thqold);
+                thqold = thq;
+                if (m_theta < 0.99)
+                {
+                    m_faccon = m_theta / (1.0 - m_theta);
+                    const double dyth = m_faccon * dyno * std::pow(m_theta, max_newton_iters - 1 - newt) / fnewt;
+                    if (dyth >= 1.0)
+                    {
+                        const double qnewt = std::clamp(dyth, 1.0e-4, 20.0);
+                        newton_failed(0.8 * std::pow(qnewt, -1.0 / (4.0 + max_newton_iters - 1 - newt)), stats);
+                        return;
+                    }
+                }
+                else
+                {
+                    newton_failed(0.5, stats);
+                    return;
+                }
+            }
+            dynold = std::max(dyno, eps);
+
+            m_w[0] += d1;
+            m_w[1] += d2;
+            m_w[2] += d3;
+            m_z[0].noalias() = C::t11 * m_w[0] + C::t12 * m_w[1] + C::t13 * m_w[2];
+            m_z[1].noalias() = C::t21 * m_w[0] + C::t22 * m_w[1] + C::t23 * m_w[2];
+            m_z[2].noalias() = C::t31 * m_w[0] + m_w[1];
+
+            if (m_faccon * dyno <= fnewt)
+            {
+                converged = true;
+                break;
+            }
+        }
+
+        if (!converged)
+        {
+            newton_failed(0.5, stats);
+            return;
+        }
+
+        // ── Error estimate (Hairer's ESTRAD) ────────────────────────────────
+        // ws.k[1] = (e₁Z₁ + e₂Z₂ + e₃Z₃)/h, ws.error = E₁⁻¹(f₀ + ws.k[1])
+        ws.k[1].noalias() = (C::e1 / h) * m_z[0] + (C::e2 / h) * m_z[1] + (C::e3 / h) * m_z[2];
+        ws.stage.noalias() = m_f0 + ws.k[1];
+        m_jac.solve(ws.stage, ws.error);
+        if (m_first || retry)
+        {
+            const double err = std::sqrt((ws.error.array() / m_scal.array()).square().sum() / static_cast<double>(n));
+            if (!(err < 1.0))
+            {
+                ws.stage.noalias() = y + ws.error;
+                rhs(t, ws.stage, ws.k[2]);
+                ++stats.rhs_evals;
+                ws.stage.noalias() = ws.k[2] + ws.k[1];
+                m_jac.solve(ws.stage, ws.error);
+            }
+        }
+
+        // ── Solution: stiffly accurate, y_{n+1} = Y₃ ────────────────────────
+        ws.next.noalias() = y + m_z[2];
+
+        // ── Dense output: P(θ) = θ(a₀ + a₁θ + a₂θ²), q_k = a_k / h ──────────
+        const double inv_h = 1.0 / h;
+        m_pending.t0 = t;
+        m_pending.h = h;
+        m_pending.y0 = y;
+        m_pending.valid = true;
+        m_pending.order = 4;
+        for (int k = 0; k < 3; ++k)
+        {
+            m_pending.q[k].noalias() = inv_h * (C::v[k][0] * m_z[0] + C::v[k][1] * m_z[1] + C::v[k][2] * m_z[2]);
+        }
+        m_pending.q[3].setZero();
+    }
+
+  private:
+    DenseSegment<N> m_last{};
+    DenseSegment<N> m_pending{};
+    DenseHistory<N> m_dense_hist{};
+
+    // J and the factored E₁ = γ̂/h·I − J (dense J: E₂ is built from it)
+    IterationMatrix<N, JacobianStructure::Dense> m_jac{};
+
+    // Per-step scratch, sized in before_solve()
+    CMat m_E2{};
+    Eigen::PartialPivLU<CMat> m_lu2{};
+    std::array<Vec<N>, 3> m_z{};  // stage increments Z_i
+    std::array<Vec<N>, 3> m_w{};  // transformed increments W = T⁻¹Z
+    Vec<N> m_f0{};
+    Vec<N> m_scal{};
+    CVec m_cw{};
+
+    // Newton / reuse state: J wanted at the next attempt, J evaluated at the
+    // current (t, y), h the factorizations belong to, retry of a rejected
+    // step, first step of the solve, last contraction rate and the
+    // convergence-speed estimate carried between steps
+    bool m_need_jac = true;
+    bool m_jac_current = false;
+    double m_w_h = 0.0;
+    bool m_retry = false;
+    bool m_first = true;
+    double m_theta = 0.0;
+    double m_faccon = 1.0;
+    double m_newton_shrink = 0.0;  // step_failure() of the last attempt
+
+    // ── Jacobian setup ───────────────────────────────────────────────────────
+    //
+    // Analytical .jacobian() if present, else forward-mode autodiff through
+    // a Dual-templated RHS, else dense finite differences (see
+    // IterationMatrix).  Declared bands and sparsity patterns are ignored:
+    // E₂ needs J as a dense matrix.
+
+    template <typename System>
+    void setup_jacobian(System &sys, Eigen::Index n)
+    {
+        m_jac.bind(sys, n, false, "Radau5");
+    }
+
+    // ── E₁ = γ̂/h·I − J and E₂ = (α̂ + iβ̂)/h·I − J ──────────────────────────
+
+    void factor(double h)
+    {
+        m_jac.factor(C::u1 / h);
+
+        m_E2 = -m_jac.dense().template cast<std::complex<double>>();
+        m_E2.diagonal().array() += std::complex<double>(C::alph / h, C::beta / h);
+        m_lu2.compute(m_E2);
+
+        m_w_h = h;
+    }
+
+    // ── Newton starting values ──────────────────────────────────────────────
+    //
+    // Z_i = P_prev(t + c_i h) − y from the previous step's collocation
+    // polynomial when it ends at t; zero on the first step of a solve.
+
+    void start_values(double t, const Vec<N> &y, double h)
+    {
+        const double eps = 64.0 * std::numeric_limits<double>::epsilon() * std::max(1.0, std::abs(t));
+        if (!m_last.valid || std::abs(m_last.t0 + m_last.h - t) > eps)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                m_z[i].setZero();
+                m_w[i].setZero();
+            }
+            return;
+        }
+
+        const double cs[3] = {C::c1, C::c2, 1.0};
+        for (int i = 0; i < 3; ++i)
+        {
+            const double th = 1.0 + cs[i] * h / m_last.h;
+            m_z[i].noalias() = m_last.y0 - y + (m_last.h * th) * (m_last.q[0] + th * (m_last.q[1] + th * m_last.q[2]));
+        }
+        m_w[0].noalias() = C::ti11 * m_z[0] + C::ti12 * m_z[1] + C::ti13 * m_z[2];
+        m_w[1].noalias() = C::ti21 * m_z[0] + C::ti22 * m_z[1] + C::ti23 * m_z[2];
+        m_w[2].noalias() = C::ti31 * m_z[0] + C::ti32 * m_z[1] + C::ti33 * m_z[2];
+    }
+
+    // ── Newton failure → rejected step ──────────────────────────────────────
+    //
+    // Records the factor AdaptiveDES shrinks h by (Hairer: 0.5 on
+    // divergence, from the predicted contraction on slow convergence).
+
+    void newton_failed(double reduction, SolverStats &stats)
+    {
+        ++stats.newton_failures;
+        m_newton_shrink = std::clamp(reduction, this->options.controller.min_factor, 0.9);
+        m_pending.valid = false;
+    }
+};
+
+}  // namespace DES
@@ -2,22 +2,31 @@
 
 /*  des_rossenbrock.hpp  –  DES namespace
  *
- *  Rosenbrock4 — GRK4A Rosenbrock method for stiff ODEs and DDEs.
+ *  Rosenbrock4 — GRK4A Rosenbrock method for stiff ODEs and DDEs, with a
+ *  ROS34PW2 W-method mode for Jacobian reuse.
  *
- *  This implementation uses the transformed Rosenbrock form
+ *  This implementation uses the transformed Rosenbrock form of Hairer &
+ *  Wanner (IV.7.4'), with
  *
  *      W = (1/(γ h)) I - J(t_n, y_n),
  *
  *  where J is the Jacobian with respect to the current state.  The same
- *  matrix W is factorized once and reused for all four stage solves in a step.
+ *  matrix W is factorized once and reused for all stage solves in a step.
  *
- *  The stage vectors k_i stored in ws.k are O(h) state increments, not slope
- *  vectors.  Accordingly, stage states are formed as y + Σ a_ij k_j (no extra
+ *  The stage vectors u_i stored in ws.k are O(h) state increments, not slope
+ *  vectors.  Accordingly, stage states are formed as y + Σ a_ij u_j (no extra
  *  factor of h), and both the step update and embedded error estimate are plain
- *  linear combinations of the k_i.
+ *  linear combinations of the u_i.  The coefficients (a_ij, c_ij, m_i) follow
+ *  from the Kaps–Rentrop (α_ij, γ_ij, b_i) by  a = α Γ⁻¹,
+ *  c = diag(γ⁻¹) − Γ⁻¹,  m = b Γ⁻¹.
  *
  *  References
  *  ──────────
+ *  • J. Rang, L. Angermann.
+ *    New Rosenbrock W-methods of order 3 for partial differential algebraic
+ *    equations of index 1.
+ *    BIT 45 (2005) 761–787.
+ *
  *  • P. Kaps, P. Rentrop.
  *    Generalized Runge-Kutta methods of order four with stepsize control for
  *    stiff ordinary differential equations.
@@ -33,43 +42,82 @@
  *  • 4 stages, order 4, embedded order 3 for adaptive step-size control
  *  • A-stable (GRK4A is not L-stable)
  *  • Linearly implicit: one LU factorization per attempted step, reused for all
- *    four stages
+ *    four stages and the dense-output solve
+ *  • JacobianPolicy::Reuse switches to the W-method ROS34PW2 (order 3(2),
+ *    stiffly accurate) and keeps J across steps; SolverStats counts
+ *    jacobian_evals and lu_decompositions
  *  • Jacobian support:
  *      – Analytical: provide sys.jacobian(t, y, J) → used automatically
- *      – Finite-difference fallback when no .jacobian member is present
- *  • Dense output: generic Hermite cubic segment built from
- *      (t_n, y_n, f_n) and (t_{n+1}, y_{n+1}, f_{n+1})
+ *      – Forward-mode autodiff when the RHS is a template over the state
+ *        type (HasDualRhs): exact J in ⌈N / width⌉ Dual passes, see
+ *        des_autodiff.hpp.  Not counted in rhs_evals.
+ *      – Finite-difference fallback when neither is available
+ *      – Sparse finite differences when the system declares
+ *        jacobian_sparsity() or `sparse_jacobian` is set (pattern probed at
+ *        the start of each solve): one RHS call per CPR color instead of
+ *        one per column, J kept as a SparseMatrix and W factored with
+ *        Eigen::SparseLU.  The sparse path allocates inside SparseLU.
+ *        Only for Eigen::Dynamic or fixed N > 16; smaller fixed systems
+ *        always take the dense LU.
+ *      – Banded finite differences when the system declares
+ *        jacobian_bandwidth(): lower + upper + 1 RHS calls per Jacobian, W
+ *        factored with BandedLU in O(N·b²).  Takes precedence over a
+ *        declared sparsity pattern and never allocates in the step loop.
+ *  • Time derivative ∂f/∂t for non-autonomous systems:
+ *      – Analytical: provide sys.time_derivative(t, y, dfdt)
+ *      – Otherwise one forward difference per step, unless the solver's
+ *        `autonomous` flag is set, in which case ∂f/∂t = 0
+ *  • Dense output: 3rd-order continuous extension from the stage increments,
+ *    O(h⁴), with no RHS call beyond the step itself (see below)
  *
  *  Stage equations in the implemented form
  *  ───────────────────────────────────────
- *  With W = (1/(γ h)) I - J and J = ∂f/∂y evaluated at (t_n, y_n):
+ *  With W = (1/(γ h)) I - J, J = ∂f/∂y and f_t = ∂f/∂t at (t_n, y_n):
  *
- *      W k1 = f(t_n, y_n)
+ *      W u1 = f(t_n, y_n)                                         + d1 h f_t
  *
- *      Y2   = y_n + a21 k1
- *      W k2 = f(t_n + c2 h, Y2) + (g21 / h) k1
+ *      Y2   = y_n + a21 u1
+ *      W u2 = f(t_n + c2 h, Y2) + (c21 / h) u1                   + d2 h f_t
  *
- *      Y3   = y_n + a31 k1 + a32 k2
- *      W k3 = f(t_n + c3 h, Y3) + (g31 / h) k1 + (g32 / h) k2
+ *      Y3   = y_n + a31 u1 + a32 u2
+ *      W u3 = f(t_n + c3 h, Y3) + (c31 / h) u1 + (c32 / h) u2    + d3 h f_t
  *
- *      Y4   = Y3   [GRK4A has a4 = a3 and c4 = c3]
- *      W k4 = f(t_n + c3 h, Y3)
- *             + (g41 / h) k1 + (g42 / h) k2 + (g43 / h) k3
+ *      Y4   = Y3   [GRK4A has α4 = α3, hence a4j = a3j and c4 = c3]
+ *      W u4 = f(t_n + c3 h, Y3)
+ *             + (c41 / h) u1 + (c42 / h) u2 + (c43 / h) u3       + d4 h f_t
  *
  *  Step update and error estimate
  *  ──────────────────────────────
- *      y_{n+1} = y_n + b1 k1 + b2 k2 + b3 k3 + b4 k4
+ *      y_{n+1} = y_n + m1 u1 + m2 u2 + m3 u3 + m4 u4
+ *
+ *      err     = e1 u1 + e2 u2 + e3 u3 + e4 u4
+ *
+ *  Dense output
+ *  ────────────
+ *  Because α4 = α3, the order-≤3 conditions on Σ b_i(θ) k_i are rank
+ *  deficient: no cubic built from u1..u4 alone has order 3.  One more
+ *  back-substitution with the factorization already in hand supplies the
+ *  missing direction,
+ *
+ *      W v  = u1 / (γ² h) + h f_t         ( v = (I − γhJ)⁻² h f₀ for f_t = 0 ),
+ *
+ *  and the segment is
  *
- *      err     = e1 k1 + e2 k2 + e3 k3 + e4 k4
+ *      y(t_n + θh) = y_n + Σ_{k=1..3} θᵏ (Σ_i p_ki u_i + p_k5 v).
+ *
+ *  The p_ki satisfy the order-3 conditions for every θ, reduce to m_i at
+ *  θ = 1, and minimize the order-4 error over θ ∈ [0, 1].  All five vectors
+ *  pass through W⁻¹, so for stiff components (hλ → −∞) the interpolant stays
+ *  bounded.  The Hermite cubic it replaces carries h f(y_{n+1}) = hλ y_{n+1}
+ *  and overshoots there.
  *
  *  Implementation notes
  *  ────────────────────
  *  • compute_step() receives f(t_n, y_n) in ws.k[0] on entry and overwrites
  *    ws.k[0..3] with the four Rosenbrock stage increments.
- *  • Stage 4 reuses the stage-3 RHS evaluation because Y4 = Y3 and c4 = c3 in
- *    this GRK4A formulation, so there is no extra RHS call for stage 4.
- *  • Dense output here is the library’s generic Hermite cubic interpolant; it
- *    is not a Rosenbrock-specific stiff-aware dense output formula.
+ *  • Stage 4 reuses the stage-3 RHS evaluation because Y4 = Y3 and c4 = c3,
+ *    so a step costs two RHS calls beyond f(t_n, y_n) (plus the Jacobian and
+ *    f_t, analytical or finite-difference).
  *
  *  DDE usage
  *  ─────────
@@ -81,86 +129,179 @@
 
 #include "des_adaptive.hpp"
 #include "des_dense_output.hpp"
+#include "des_jacobian.hpp"
 
-#include <Eigen/LU>
-
+#include <algorithm>
 #include <cmath>
 #include <functional>
-#include <limits>
 #include <stdexcept>
 #include <type_traits>
-#include <vector>
 
 namespace DES {
 
 // ---------------------------------------------------------------------------
-// HasJacobian<System, N>
+// JacobianPolicy — when Rosenbrock4 re-evaluates J and refactors W
 //
-// True when System has a member:
-//   void jacobian(double t, const Vec<N>&, Eigen::Matrix<double,N,N>&)
+//   EveryStep – exact Rosenbrock method (GRK4A, order 4(3)).  J is evaluated
+//               once per accepted point and kept across rejected retries at
+//               that point; W is refactored on every attempt.
+//   Reuse     – W-method (ROS34PW2, order 3(2)), whose order does not depend
+//               on J being current.  J is kept across steps until a step
+//               taken with an old J is rejected or J reaches jac_max_age
+//               accepted steps.  After an accepted step whose controller
+//               asks for growth of at most w_refactor_ratio, h is held, so
+//               the factored W is reused as is.
 // ---------------------------------------------------------------------------
 
-template <typename System, int N, typename = void>
-struct HasJacobian : std::false_type {};
-
-template <typename System, int N>
-struct HasJacobian<System, N, std::void_t<decltype(std::declval<System &>().jacobian(std::declval<double>(), std::declval<const Vec<N> &>(), std::declval<Eigen::Matrix<double, N, N> &>()))>> : std::true_type {};
+enum class JacobianPolicy { EveryStep, Reuse };
 
 // ---------------------------------------------------------------------------
-// Rosenbrock4<N, HistoryPoints>
+// Rosenbrock4<N, HistoryPoints, Policy>
 // ---------------------------------------------------------------------------
 
-template <int N, int HistoryPoints = 1000>
-class Rosenbrock4 : public AdaptiveDES<Rosenbrock4<N, HistoryPoints>, N, HistoryPoints, 4> {
-    using Base = AdaptiveDES<Rosenbrock4<N, HistoryPoints>, N, HistoryPoints, 4>;
-    using JacMat = Eigen::Matrix<double, N, N>;
-    using LU_t = Eigen::PartialPivLU<JacMat>;
+template <int N, int HistoryPoints = 1000, JacobianPolicy Policy = JacobianPolicy::EveryStep>
+class Rosenbrock4 : public AdaptiveDES<Rosenbrock4<N, HistoryPoints, Policy>, N, HistoryPoints, 4> {
+    using Base = AdaptiveDES<Rosenbrock4<N, HistoryPoints, Policy>, N, HistoryPoints, 4>;
     using WorkspaceT = Workspace<N, 4>;
 
     // ── GRK4A coefficients (Kaps & Rentrop 1979) in transformed W-form ─────
-    struct Coeff {
+    //
+    // Derived from the published (α_ij, γ_ij, b_i, b̂_i) as described in the
+    // file header; the published values carry 12 digits, which bounds how
+    // well the order conditions hold (~1e-13).
+    struct GRK4A {
+        static constexpr int order = 4;
+
         // Diagonal shift: W = (1/γh)·I − J
         static constexpr double gamma = 0.395;
 
-        // Stage y-arguments: Yᵢ = y + Σⱼ<ᵢ aᵢⱼ kⱼ
-        // The kᵢ in this implementation are O(h) increments, so there is no
-        // extra factor of h in the stage states, final update, or error estimate.
-        static constexpr double a21 = 0.438;
-        static constexpr double a31 = 0.796920457938;
-        static constexpr double a32 = 0.0730795420615;
-        // GRK4A: a₄ = a₃  ⟹ Y₄ = Y₃
-
-        // Corresponding abscissae c_i = Σ_j a_ij
-        static constexpr double c2 = a21;        // 0.438
-        static constexpr double c3 = a31 + a32;  // 0.87
-
-        // Off-diagonal Γᵢⱼ (divided by h in stage equations)
-        static constexpr double g21 = -0.767672395484;
-        static constexpr double g31 = -0.851675323742;
-        static constexpr double g32 = 0.522967289188;
-        static constexpr double g41 = 0.288463109545;
-        static constexpr double g42 = 0.0880214273381;
-        static constexpr double g43 = -0.337389840627;
+        // Stage y-arguments: Yᵢ = y + Σⱼ<ᵢ aᵢⱼ uⱼ
+        static constexpr double a21 = 1.1088607594936708;
+        static constexpr double a31 = 2.3770852619819607;
+        static constexpr double a32 = 0.18501149888987342;
+        // GRK4A: α₄ = α₃  ⟹ Y₄ = Y₃, stage 4 reuses f(Y₃)
+        static constexpr bool y4_is_y3 = true;
+        static constexpr double a41 = a31;
+        static constexpr double a42 = a32;
+        static constexpr double a43 = 0.0;
+
+        // Abscissae αᵢ = Σⱼ αᵢⱼ
+        static constexpr double c2 = 0.438;
+        static constexpr double c3 = 0.87;
+        static constexpr double c4 = c3;
+
+        // Stage couplings (divided by h in stage equations)
+        static constexpr double c21 = -4.9201884023970521;
+        static constexpr double c31 = 1.0555886860493509;
+        static constexpr double c32 = 3.3518172676686429;
+        static constexpr double c41 = 3.8468690070473168;
+        static constexpr double c42 = 3.4271092412701316;
+        static constexpr double c43 = -2.1624088487550073;
+
+        // ∂f/∂t weights dᵢ = Σⱼ≤ᵢ γᵢⱼ
+        static constexpr double d1 = 0.395;
+        static constexpr double d2 = -0.372672395484;
+        static constexpr double d3 = 0.066291965446;
+        static constexpr double d4 = 0.4340946962561;
 
         // 4th-order solution weights
-        static constexpr double b1 = 0.199293275701;
-        static constexpr double b2 = 0.482645235674;
-        static constexpr double b3 = 0.0680614886256;
-        static constexpr double b4 = 0.25;
-
-        // Embedded 3rd-order weights: b̂ = [0.346325833758, 0.285693175712, 0.367980990530, 0]
-        // Error = b − b̂
-        static constexpr double e1 = -0.147032558057;
-        static constexpr double e2 = 0.196952059962;
-        static constexpr double e3 = -0.2999195019044;
-        static constexpr double e4 = 0.25;
+        static constexpr double m1 = 1.8456832404082617;
+        static constexpr double m2 = 0.13697968943635319;
+        static constexpr double m3 = 0.7129097783295113;
+        static constexpr double m4 = 0.63291139240506333;
+
+        // Error = m − m̂ (m̂: embedded 3rd-order weights)
+        static constexpr double e1 = -0.048318701767683485;
+        static constexpr double e2 = 0.64711086510659321;
+        static constexpr double e3 = -0.21868766605023554;
+        static constexpr double e4 = 0.63291139240506333;
+
+        // Dense output: coefficient of θᵏ⁺¹ is Σᵢ p[k][i] uᵢ + p[k][4] v
+        static constexpr bool dense_uses_v = true;
+        static constexpr double p[3][5] = {
+            {6.0921965388665678, 9.6298571693729524, -1.6849089104949813, -0.94136711717915378, 2.7027027026982515},
+            {-5.852689327505586, -23.800145376065188, 4.0698411556975342, 2.9497375666509873, -8.1081081080957293},
+            {1.6061760290449068, 14.307267896114505, -1.6720224668671786, -1.3754590570836878, 5.4054054053995229},
+        };
     };
 
+    // ── ROS34PW2 coefficients (Rang & Angermann 2005) in transformed form ──
+    //
+    // W-method: order 3 (embedded 2) for any matrix in place of J, stiffly
+    // accurate (m = a₄ + e₄ᵀ, so y_{n+1} = Y₄ + u₄), L-stable.
+    struct ROS34PW2 {
+        static constexpr int order = 3;
+
+        static constexpr double gamma = 0.435866521508459;
+
+        static constexpr double a21 = 2.0;
+        static constexpr double a31 = 1.4192173174557647;
+        static constexpr double a32 = -0.25923221167296973;
+        static constexpr bool y4_is_y3 = false;
+        static constexpr double a41 = 4.1847604823191604;
+        static constexpr double a42 = -0.28519201735549593;
+        static constexpr double a43 = 2.2942803602790418;
+
+        static constexpr double c2 = 0.87173304301691801;
+        static constexpr double c3 = 0.73157995778885243;
+        static constexpr double c4 = 1.0;
+
+        static constexpr double c21 = -4.5885607205580836;
+        static constexpr double c31 = -4.1847604823191604;
+        static constexpr double c32 = 0.28519201735549593;
+        static constexpr double c41 = -6.3681792001283579;
+        static constexpr double c42 = -6.7956209444668358;
+        static constexpr double c43 = 2.8700986043310559;
+
+        static constexpr double d1 = 0.435866521508459;
+        static constexpr double d2 = -0.435866521508459;
+        static constexpr double d3 = -0.4133333762338865;
+        static constexpr double d4 = 0.0;
+
+        static constexpr double m1 = a41;
+        static constexpr double m2 = a42;
+        static constexpr double m3 = a43;
+        static constexpr double m4 = 1.0;
+
+        static constexpr double e1 = 0.27774994764796812;
+        static constexpr double e2 = -1.403239895175999;
+        static constexpr double e3 = 1.7726301276675507;
+        static constexpr double e4 = 0.5;
+
+        // Dense output from u₁..u₄ alone: order 2 for any W, order 3 when J
+        // is current, equal to y_{n+1} at θ = 1
+        static constexpr bool dense_uses_v = false;
+        static constexpr double p[3][5] = {
+            {0.83265902315438955, -1.4616213371246523, 0.0, -2.3981200751955822, 0.0},
+            {4.5207842005203478, -4.7279543222840159, 9.7529396851681778, 5.5019597901121235, 0.0},
+            {-1.1686827413555756, 5.9043836420531735, -7.4586593248891377, -2.1038397149165413, 0.0},
+        };
+    };
+
+    using Coeff = std::conditional_t<Policy == JacobianPolicy::Reuse, ROS34PW2, GRK4A>;
+
   public:
     // Finite-difference epsilon for Jacobian approximation.
-    // Perturbation for component j: fd_eps * max(|y[j]|, 1.0)
+    // Perturbation for component j: fd_eps * max(|y[j]|, min(1, atol_j))
     double fd_eps = 1.0e-7;
 
+    // Use the sparse FD Jacobian path with a pattern found by structural
+    // probing (N + 1 RHS calls per solve).  Systems that declare
+    // jacobian_sparsity() take the sparse path without it; an analytical
+    // .jacobian(), or a fixed N ≤ 16, always takes the dense one.
+    bool sparse_jacobian = false;
+
+    // Declares f independent of t, so ∂f/∂t = 0 and no forward difference in
+    // t is taken.  Ignored when the system provides .time_derivative().
+    bool autonomous = false;
+
+    // JacobianPolicy::Reuse only: refresh J after this many accepted steps,
+    // and keep h (and with it the factored W) when the controller proposes
+    // h_new with 1 ≤ h_new / h ≤ 1 + w_refactor_ratio.  W always matches
+    // the h it is used with; 0 refactors on every change of h.
+    int jac_max_age = 20;
+    double w_refactor_ratio = 0.2;
+
     Rosenbrock4()
     {
         this->options.controller.kind = ControllerKind::PI;
@@ -174,24 +315,44 @@ class Rosenbrock4 : public AdaptiveDES<Rosenbrock4<N, HistoryPoints>, N, History
 
     [[nodiscard]] static constexpr int method_order()
     {
-        return 4;
+        return Coeff::order;
     }
     [[nodiscard]] static constexpr int adaptive_order()
     {
-        return 3;
+        return Coeff::order - 1;
     }
     [[nodiscard]] static constexpr bool has_fsal()
     {
         return false;
     }
 
-    // ── Dense output (generic Hermite cubic, O(h⁴)) ────────────────────────
+    // JacobianPolicy::Reuse: hold h across small growth requests so the
+    // next step reuses W (see w_refactor_ratio).  Shrinking is never held.
+    [[nodiscard]] double hold_step_size(double next_h, double h_abs) const noexcept
+    {
+        if constexpr (Policy == JacobianPolicy::Reuse)
+        {
+            if (next_h >= h_abs && next_h <= (1.0 + w_refactor_ratio) * h_abs)
+            {
+                return h_abs;
+            }
+        }
+        return next_h;
+    }
+
+    // ── Dense output (stage-based 3rd-order extension, O(h⁴)) ─────────────
 
     [[nodiscard]] bool has_dense_output() const noexcept
     {
         return m_last.valid;
     }
 
+    // Pattern and coloring used by the sparse path (empty otherwise)
+    [[nodiscard]] const JacobianSparsity &jacobian_sparsity() const noexcept
+    {
+        return m_jac.sparsity();
+    }
+
     [[nodiscard]] const DenseSegment<N> &last_dense_step() const noexcept
     {
         return m_last;
@@ -202,6 +363,11 @@ class Rosenbrock4 : public AdaptiveDES<Rosenbrock4<N, HistoryPoints>, N, History
         return static_cast<int>(m_dense_hist.size());
     }
 
+    [[nodiscard]] const DenseHistory<N> &dense_history() const noexcept
+    {
+        return m_dense_hist;
+    }
+
     [[nodiscard]] const DenseSegment<N> &dense_segment(int i) const
     {
         if (i < 0 || i >= dense_history_size())
@@ -213,38 +379,29 @@ class Rosenbrock4 : public AdaptiveDES<Rosenbrock4<N, HistoryPoints>, N, History
 
     [[nodiscard]] Vec<N> interpolate(double t) const
     {
-        const int n = dense_history_size();
-        if (n == 0)
+        if (m_dense_hist.empty())
         {
             throw std::out_of_range("Rosenbrock4: no dense segments stored");
         }
-        if (m_dense_hist.back().contains(t))
+        if (const DenseSegment<N> *seg = m_dense_hist.find(t))
         {
-            return m_dense_hist.back().eval(t);
+            return seg->eval(t);
         }
+        throw std::out_of_range("Rosenbrock4: interpolation time outside dense history");
+    }
 
-        int lo = 0, hi = n - 1;
-        while (lo <= hi)
+    // interpolate() at every time in sorted_t (ordered in the integration
+    // direction), column j of `out` for sorted_t[j] — O(n + m) merge walk
+    void interpolate_many(ColumnView sorted_t, Eigen::Matrix<double, N, Eigen::Dynamic> &out) const
+    {
+        if (m_dense_hist.empty())
         {
-            const int mid = (lo + hi) / 2;
-            const auto &seg = m_dense_hist[static_cast<std::size_t>(mid)];
-            const double t1 = seg.t0 + seg.h;
-            const double eps = 64.0 * std::numeric_limits<double>::epsilon() * std::max(1.0, std::max(std::abs(seg.t0), std::abs(t1)));
-            const double dir = (seg.h >= 0.0) ? 1.0 : -1.0;
-            if ((dir > 0.0) ? (t < seg.t0 - eps) : (t > seg.t0 + eps))
-            {
-                hi = mid - 1;
-            }
-            else if ((dir > 0.0) ? (t > t1 + eps) : (t < t1 - eps))
-            {
-                lo = mid + 1;
-            }
-            else
-            {
-                return seg.eval(t);
-            }
+            throw std::out_of_range("Rosenbrock4: no dense segments stored");
+        }
+        if (m_dense_hist.eval_many(sorted_t.data, sorted_t.size, out) != sorted_t.size)
+        {
+            throw std::out_of_range("Rosenbrock4: interpolation times unsorted or outside stored dense history");
         }
-        throw std::out_of_range("Rosenbrock4: interpolation time outside dense history");
     }
 
     [[nodiscard]] double interpolate_component(double t, int component) const
@@ -261,7 +418,7 @@ class Rosenbrock4 : public AdaptiveDES<Rosenbrock4<N, HistoryPoints>, N, History
     template <typename System>
     SolveResult solve(Vec<N> &y, double t0, double t1, System &sys)
     {
-        setup_jacobian(sys);
+        setup_jacobian(sys, y.size());
         typename Base::NoOpObserver obs;
         return Base::solve(y, t0, t1, sys, obs);
     }
@@ -270,7 +427,7 @@ class Rosenbrock4 : public AdaptiveDES<Rosenbrock4<N, HistoryPoints>, N, History
     template <typename System, typename Observer>
     SolveResult solve(Vec<N> &y, double t0, double t1, System &sys, Observer &&obs)
     {
-        setup_jacobian(sys);
+        setup_jacobian(sys, y.size());
         return Base::solve(y, t0, t1, sys, std::forward<Observer>(obs));
     }
 
@@ -278,7 +435,7 @@ class Rosenbrock4 : public AdaptiveDES<Rosenbrock4<N, HistoryPoints>, N, History
     template <typename System>
     SolveResult solve(Vec<N> &y, double t0, double t1, System &sys, typename Base::DelayHistoryStorage &dh)
     {
-        setup_jacobian(sys);
+        setup_jacobian(sys, y.size());
         typename Base::NoOpObserver obs;
         return Base::solve(y, t0, t1, sys, dh, obs);
     }
@@ -287,165 +444,253 @@ class Rosenbrock4 : public AdaptiveDES<Rosenbrock4<N, HistoryPoints>, N, History
     template <typename System, typename Observer>
     SolveResult solve(Vec<N> &y, double t0, double t1, System &sys, typename Base::DelayHistoryStorage &dh, Observer &&obs)
     {
-        setup_jacobian(sys);
+        setup_jacobian(sys, y.size());
         return Base::solve(y, t0, t1, sys, dh, std::forward<Observer>(obs));
     }
 
     // ── Lifecycle hooks ──────────────────────────────────────────────────────
 
+    // All N- and N×N-sized scratch lives in members sized here, so the step
+    // loop itself never allocates — also for N = Eigen::Dynamic.
     void before_solve()
     {
-        m_last = {};
-        m_pending = {};
-        m_dense_hist.clear();
+        const Eigen::Index n = this->dimension();
+        m_last.reset(n);
+        m_pending.reset(n);
+        m_dense_hist.reset(this->options.dense_retention, static_cast<std::size_t>(this->options.reserve_steps));
+
+        m_jac.resize(n);
+        m_jac.set_fd_floor([this](Eigen::Index j) { return this->component_atol(static_cast<int>(j)); });
+        m_f0.resize(n);
+        m_f.resize(n);
+        m_f3.resize(n);
+        m_ft.resize(n);
+        m_v.resize(n);
+
+        m_jac_age = -1;
+        m_w_h = 0.0;
+        m_retry = false;
     }
 
     void after_step(double /*t*/)
     {
         m_last = m_pending;
-        m_dense_hist.push_back(m_pending);
+        m_dense_hist.push(m_pending);
+
+        m_retry = false;
+        if (m_jac_age >= 0)
+        {
+            ++m_jac_age;
+        }
     }
 
     // ── Step computation ─────────────────────────────────────────────────────
     //
     // On entry: ws.k[0] = f(t, y)  (set by solve_impl; has_fsal = false)
     //
-    // The method overwrites ws.k[0..3] with Rosenbrock stage increments k₁..k₄
+    // The method overwrites ws.k[0..3] with Rosenbrock stage increments u₁..u₄
     // in transformed W-form.  They are not raw function evaluations.
-    // ws.fsal stores f(t+h, y_{n+1}) for the Hermite dense segment.
     //
-    // Jacobian J = ∂f/∂y is evaluated at (t, y).  For DDEs, delayed/history
-    // values are frozen during the step; the rhs lambda captures the query
-    // window accordingly, so perturbing y for FD Jacobians does not change the
-    // delay lookup horizon.
+    // Jacobian J = ∂f/∂y and f_t = ∂f/∂t are evaluated at (t, y) whenever
+    // the policy asks for a fresh one (see JacobianPolicy).  For DDEs,
+    // delayed/history values are frozen during the step; the rhs lambda
+    // captures the query window accordingly, so perturbing y for FD Jacobians
+    // does not change the delay lookup horizon.
 
     template <typename RhsEval>
     void compute_step(double t, const Vec<N> &y, double h, RhsEval &&rhs, WorkspaceT &ws, SolverStats &stats)
     {
         using Cf = Coeff;
 
-        // f₀ = f(t, y) — already in ws.k[0] on entry.
-        // In this Rosenbrock formulation the stage vectors kᵢ are O(h) increments,
-        // not slope vectors. Therefore stage states use y + Σ aᵢⱼ kⱼ (no extra h), and
-        // the final update/error estimate are also plain linear combinations of kᵢ.
-        // Save as a const reference; we need it for:
-        //   (a) the right-hand side of the W·k₁ = f₀ equation
-        //   (b) the FD Jacobian column differences
-        //   (c) the Hermite f₀ for dense output
-        const Vec<N> f0 = ws.k[0];
-
-        // ── Jacobian J = ∂f/∂y at (t, y) ────────────────────────────────────
-        JacMat J;
-        if (m_jac_fn)
+        // f₀ = f(t, y) — already in ws.k[0] on entry.  Saved in m_f0; we
+        // need it for the W·u₁ = f₀ equation and the FD column differences.
+        m_f0 = ws.k[0];
+        const Vec<N> &f0 = m_f0;
+
+        // A call without an accepted step since the previous one is a retry
+        // of a rejected step from the same (t, y).
+        const bool retry = m_retry;
+        m_retry = true;
+
+        // ── Jacobian J = ∂f/∂y and f_t = ∂f/∂t at (t, y) ────────────────────
+        // EveryStep: a retry keeps J, which is still exact at (t, y).
+        // Reuse: keep J until a step taken with an old J is rejected or J
+        // reaches jac_max_age accepted steps.
+        bool fresh_jac = (m_jac_age < 0);
+        if constexpr (Policy == JacobianPolicy::EveryStep)
         {
-            m_jac_fn(t, y, J);
+            fresh_jac = fresh_jac || !retry;
         }
         else
         {
-            compute_jac_fd(t, y, f0, rhs, J, stats);
+            fresh_jac = fresh_jac || (retry && m_jac_age > 0) || m_jac_age >= jac_max_age;
+        }
+
+        if (fresh_jac)
+        {
+            evaluate_jacobian(t, y, f0, rhs, stats);
+            m_jac_age = 0;
         }
 
         // ── Build and LU-factor W = (1/γh)·I − J ────────────────────────────
-        // One factorization is performed per attempted step and reused for all stages.
-        const double inv_gh = 1.0 / (Cf::gamma * h);
-        JacMat W = -J;
-        W.diagonal().array() += inv_gh;  // W += (1/γh)·I
-        const LU_t lu(W);
+        // EveryStep refactors on every attempt.  Under Reuse W is refactored
+        // only when J is new or h differs from the h W was factored for;
+        // hold_step_size() keeps h unchanged across small growth requests.
+        const bool refactor = fresh_jac || h != m_w_h;
 
-        // ── Stage 1: W k₁ = f(t, y) ─────────────────────────────────────────
-        ws.k[0] = lu.solve(f0);
+        if (refactor)
+        {
+            m_jac.factor(1.0 / (Cf::gamma * h));
+            m_w_h = h;
+            ++stats.lu_decompositions;
+        }
 
-        // ── Stage 2: W k₂ = f(t + c₂h, Y₂) + (Γ₂₁/h) k₁ ──────────────────
+        // Right-hand sides are assembled in ws.stage before each solve so
+        // that no expression temporaries are created.
+
+        // ── Stage 1: W u₁ = f(t, y) + d₁h f_t ───────────────────────────────
         {
-            Vec<N> f2;
-            rhs(t + Cf::c2 * h, y + Cf::a21 * ws.k[0], f2);
+            ws.stage.noalias() = f0 + (Cf::d1 * h) * m_ft;
+            m_jac.solve(ws.stage, ws.k[0]);
+        }
+
+        // ── Stage 2: W u₂ = f(t + c₂h, Y₂) + (c₂₁/h) u₁ + d₂h f_t ─────────
+        {
+            ws.stage.noalias() = y + Cf::a21 * ws.k[0];
+            rhs(t + Cf::c2 * h, ws.stage, m_f);
             ++stats.rhs_evals;
-            ws.k[1] = lu.solve(f2 + (Cf::g21 / h) * ws.k[0]);
+            ws.stage.noalias() = m_f + (Cf::c21 / h) * ws.k[0] + (Cf::d2 * h) * m_ft;
+            m_jac.solve(ws.stage, ws.k[1]);
         }
 
-        // ── Stage 3: W k₃ = f(t + c₃h, Y₃) + (Γ₃₁/h) k₁ + (Γ₃₂/h) k₂ ────
-        const Vec<N> Y3 = y + (Cf::a31 * ws.k[0] + Cf::a32 * ws.k[1]);
-        Vec<N> f3;
+        // ── Stage 3: W u₃ = f(t + c₃h, Y₃) + (c₃₁/h) u₁ + (c₃₂/h) u₂ + d₃h f_t
         {
-            rhs(t + Cf::c3 * h, Y3, f3);
+            ws.stage.noalias() = y + (Cf::a31 * ws.k[0] + Cf::a32 * ws.k[1]);  // Y₃
+            rhs(t + Cf::c3 * h, ws.stage, m_f3);
             ++stats.rhs_evals;
-            ws.k[2] = lu.solve(f3 + (Cf::g31 / h) * ws.k[0] + (Cf::g32 / h) * ws.k[1]);
+            ws.stage.noalias() = m_f3 + (Cf::c31 / h) * ws.k[0] + (Cf::c32 / h) * ws.k[1] + (Cf::d3 * h) * m_ft;
+            m_jac.solve(ws.stage, ws.k[2]);
         }
 
-        // ── Stage 4: W k₄ = f(t + c₃h, Y₃) + (Γ₄₁/h) k₁ + (Γ₄₂/h) k₂ + (Γ₄₃/h) k₃ ────
-        // GRK4A property: a₄ = a₃ ⟹ Y₄ = Y₃, so the stage-4 y-argument is
+        // ── Stage 4: W u₄ = f(t + c₄h, Y₄) + Σⱼ (c₄ⱼ/h) uⱼ + d₄h f_t ────────
+        // GRK4A property: α₄ = α₃ ⟹ Y₄ = Y₃, so the stage-4 y-argument is
         // identical to stage 3 and we can reuse f3 without another RHS call.
         {
-            ws.k[3] = lu.solve(f3 + (Cf::g41 / h) * ws.k[0] + (Cf::g42 / h) * ws.k[1] + (Cf::g43 / h) * ws.k[2]);
+            if constexpr (!Cf::y4_is_y3)
+            {
+                ws.stage.noalias() = y + (Cf::a41 * ws.k[0] + Cf::a42 * ws.k[1] + Cf::a43 * ws.k[2]);  // Y₄
+                rhs(t + Cf::c4 * h, ws.stage, m_f3);
+                ++stats.rhs_evals;
+            }
+            ws.stage.noalias() = m_f3 + (Cf::c41 / h) * ws.k[0] + (Cf::c42 / h) * ws.k[1] + (Cf::c43 / h) * ws.k[2] + (Cf::d4 * h) * m_ft;
+            m_jac.solve(ws.stage, ws.k[3]);
         }
 
-        // ── 4th-order solution ───────────────────────────────────────────────
-        ws.next = y + (Cf::b1 * ws.k[0] + Cf::b2 * ws.k[1] + Cf::b3 * ws.k[2] + Cf::b4 * ws.k[3]);
+        // ── Solution ─────────────────────────────────────────────────────────
+        ws.next = y + (Cf::m1 * ws.k[0] + Cf::m2 * ws.k[1] + Cf::m3 * ws.k[2] + Cf::m4 * ws.k[3]);
 
-        // ── Error estimate: e₁k₁ + e₂k₂ + e₃k₃ + e₄k₄ ─────────────────────
+        // ── Error estimate: e₁u₁ + e₂u₂ + e₃u₃ + e₄u₄ ─────────────────────
         ws.error = (Cf::e1 * ws.k[0] + Cf::e2 * ws.k[1] + Cf::e3 * ws.k[2] + Cf::e4 * ws.k[3]);
 
-        // ── Dense output: generic Hermite cubic from f₀ and f₁ = f(t+h, y_new) ──────
-        // This is library-level dense output, not a Rosenbrock-specific interpolant.
-        // f₁ is stored in ws.fsal (has_fsal=false, so solve_impl never reads it
-        // as a recycled stage).  The pending segment is committed only on
-        // acceptance, in after_step().
-        rhs(t + h, ws.next, ws.fsal);
-        ++stats.rhs_evals;
+        // ── Dense output from the stages (GRK4A: W v = u₁/(γ²h) + h f_t) ──
+        // No RHS call; committed only on acceptance, in after_step().
+        if constexpr (Cf::dense_uses_v)
+        {
+            ws.stage.noalias() = (1.0 / (Cf::gamma * Cf::gamma * h)) * ws.k[0] + h * m_ft;
+            m_jac.solve(ws.stage, m_v);
+        }
+        else
+        {
+            m_v.setZero();
+        }
 
-        m_pending = hermite_segment<N>(t, y, h, ws.next, f0, ws.fsal);
+        const double inv_h = 1.0 / h;
+        m_pending.t0 = t;
+        m_pending.h = h;
+        m_pending.y0 = y;
+        m_pending.valid = true;
+        m_pending.order = 3;
+        for (int k = 0; k < 3; ++k)
+        {
+            const double *pk = Cf::p[k];
+            m_pending.q[k].noalias() = inv_h * (pk[0] * ws.k[0] + pk[1] * ws.k[1] + pk[2] * ws.k[2] + pk[3] * ws.k[3] + pk[4] * m_v);
+        }
+        m_pending.q[3].setZero();
     }
 
   private:
+    // AutoSwitch drives compute_step() itself and binds the system here
+    template <int, int>
+    friend class AutoSwitch;
+
     DenseSegment<N> m_last{};
     DenseSegment<N> m_pending{};
-    std::vector<DenseSegment<N>> m_dense_hist{};
-
-    // Type-erased Jacobian function.  Null ⟹ use finite differences.
-    // Set once per solve() call by setup_jacobian(); valid for its duration.
-    std::function<void(double, const Vec<N> &, JacMat &)> m_jac_fn;
+    DenseHistory<N> m_dense_hist{};
+
+    // J and the factored W = (1/γh)·I − J
+    IterationMatrix<N> m_jac{};
+
+    // Per-step scratch, sized in before_solve()
+    Vec<N> m_f0{};
+    Vec<N> m_f{};
+    Vec<N> m_f3{};
+    Vec<N> m_ft{};
+    Vec<N> m_v{};
+
+    // Reuse state: accepted steps since J was evaluated (−1: none yet), the
+    // h that W was last factored for, and whether the next compute_step()
+    // retries a rejected attempt
+    int m_jac_age = -1;
+    double m_w_h = 0.0;
+    bool m_retry = false;
+
+    // Type-erased ∂f/∂t function.  Null ⟹ forward difference (or zero f_t
+    // when `autonomous` is set).  Set once per solve() call by
+    // setup_jacobian(); valid for its duration.
+    std::function<void(double, const Vec<N> &, Vec<N> &)> m_dfdt_fn;
 
     // ── Jacobian setup ───────────────────────────────────────────────────────
     //
-    // Detects at compile time whether System provides .jacobian().
-    // If so, captures it by reference (the reference is valid for the duration
-    // of the solve() call that owns this solver).
+    // Binds the system's Jacobian sources (see IterationMatrix) and detects
+    // .time_derivative() at compile time, captured by reference for the
+    // duration of the solve() call.
 
     template <typename System>
-    void setup_jacobian(System &sys)
+    void setup_jacobian(System &sys, Eigen::Index n)
     {
-        if constexpr (HasJacobian<System, N>::value)
+        m_jac.bind(sys, n, sparse_jacobian, "Rosenbrock4");
+
+        if constexpr (HasTimeDerivative<System, N>::value)
         {
-            m_jac_fn = [&sys](double t, const Vec<N> &y, JacMat &J) { sys.jacobian(t, y, J); };
+            m_dfdt_fn = [&sys](double t, const Vec<N> &y, Vec<N> &dfdt) { sys.time_derivative(t, y, dfdt); };
         }
         else
         {
-            m_jac_fn = nullptr;  // compute_step will use finite differences
+            m_dfdt_fn = nullptr;
         }
     }
 
-    // ── Finite-difference Jacobian ───────────────────────────────────────────
-    //
-    // Forward-difference column by column:
-    //   J[:,j] ≈ (f(t, y + ε eⱼ) − f(t, y)) / ε
-    //   ε = fd_eps · max(|y[j]|, 1)
-    //
-    // Cost: N extra RHS evaluations counted in stats.rhs_evals.
-    // For DDEs: the rhs lambda fixes max_query_time = t (step start), so
-    // perturbing y does not change the delay query window — correct.
+    // ── J and f_t at (t, y) ─────────────────────────────────────────────────
 
     template <typename RhsEval>
-    void compute_jac_fd(double t, const Vec<N> &y, const Vec<N> &f0, RhsEval &rhs, JacMat &J, SolverStats &stats)
+    void evaluate_jacobian(double t, const Vec<N> &y, const Vec<N> &f0, RhsEval &rhs, SolverStats &stats)
     {
-        Vec<N> y_pert, f_pert;
-        for (int j = 0; j < N; ++j)
+        m_jac.evaluate(t, y, f0, rhs, fd_eps, stats);
+
+        if (m_dfdt_fn)
+        {
+            m_dfdt_fn(t, y, m_ft);
+        }
+        else if (autonomous)
+        {
+            m_ft.setZero();
+        }
+        else
         {
-            const double eps_j = fd_eps * std::max(std::abs(y[j]), 1.0);
-            y_pert = y;
-            y_pert[j] += eps_j;
-            rhs(t, y_pert, f_pert);
+            const double eps_t = fd_eps * std::max(std::abs(t), 1.0);
+            rhs(t + eps_t, y, m_ft);
             ++stats.rhs_evals;
-            J.col(j) = (f_pert - f0) * (1.0 / eps_j);
+            m_ft = (m_ft - f0) * (1.0 / eps_t);
         }
     }
 };
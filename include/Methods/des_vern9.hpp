@@ -0,0 +1,482 @@
+#pragma once
+
+/*  des_vern9.hpp  –  DES namespace
+ *
+ *  Verner 9(8) explicit Runge–Kutta pair.
+ *
+ *  Reference: J. H. Verner, Numerically optimal Runge–Kutta pairs with
+ *  interpolants, Numer. Algorithms 53 (2010) 383–396 (the "most efficient"
+ *  9(8) pair, 16 stages).
+ *
+ *  Properties
+ *  ──────────
+ *  • 16 stages, 9th-order solution (b weights using stages 1, 8–15)
+ *  • 8th-order embedded estimate (b̂ weights using stages 1, 8–13, 16)
+ *  • FSAL: stage 17 = f(t+h, y_{n+1}) (a₁₇ⱼ = bⱼ) is reused as stage 1 of
+ *    the next step, so a step costs 16 evaluations as in Verner's scheme
+ *    and the endpoint slope for dense output is free
+ *  • Dense output: Vern9<N, H, DenseMode::HighOrder> (the default) has a
+ *    9th-order continuous extension, O(h¹⁰), from stages 1, 8–15, 17 and
+ *    eleven extra stages 18–28.  The extra stages are only evaluated for
+ *    steps a dense query hits (events, uniform output, interpolate with
+ *    the system); see refine_dense_step().  DenseMode::Standard keeps the
+ *    Hermite cubic from f₀ and the FSAL stage (three coefficient vectors
+ *    per segment instead of nine)
+ *  • Breaking-point enforcement and event detection via AdaptiveDES
+ *  • Recommended tolerances: rtol = atol = 1e-7 … 1e-14
+ *
+ *  The tableau was checked in 50-digit arithmetic: rows 8–16 have stage
+ *  order 5, b satisfies all 486 order-9 conditions and b̂ the 200 order-8
+ *  ones.
+ *
+ *  Continuous extension (DenseMode::HighOrder)
+ *  ───────────────────────────────────────────
+ *  Verner's published interpolant is not reproduced here; this one is
+ *  bootstrapped like DoPri87's.  Stage 18 (c = 0.4) evaluates the
+ *  minimum-norm 6th-order extension over stages 1–17, stages 19–22
+ *  (c = 0.35, 0.6, 0.3, 0.1) 7th-order extensions and stages 23–28
+ *  (c = 0.55, 0.85, 0.05, 0.7, 0.95, 0.15) 8th-order extensions over the
+ *  stages before them; stages 2–7 never enter.  The weights p are then the
+ *  unique solution of the order-9 continuous order conditions (all 486
+ *  trees); they give y(t+h) = y_{n+1}, y'(t) = f₀ and y'(t+h) = stage 17,
+ *  so the interpolant is C¹ across steps.  The nodes keep Σ|pᵢⱼ| small
+ *  (rounding in the Horner sum) while max_θ Σᵢ |bᵢ(θ)| stays below 2.4.
+ */
+
+#include "../des_adaptive.hpp"
+#include "../des_dense_output.hpp"
+#include "../des_tableau.hpp"
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace DES {
+
+template <int N, int HistoryPoints = 500, DenseMode Mode = DenseMode::HighOrder>
+class Vern9 : public AdaptiveDES<Vern9<N, HistoryPoints, Mode>, N, HistoryPoints, 17> {
+    using Base = AdaptiveDES<Vern9<N, HistoryPoints, Mode>, N, HistoryPoints, 17>;
+    using WorkspaceT = Workspace<N, 17>;
+
+    // Coefficient vectors per segment: the Hermite cubic needs 3, the
+    // 9th-order extension 9
+    static constexpr bool kHighOrder = Mode == DenseMode::HighOrder;
+    static constexpr std::size_t kDenseQ = kHighOrder ? 9 : 3;
+    static constexpr std::size_t kExtra = kHighOrder ? 11 : 0;
+    using Segment = DenseSegment<N, kDenseQ>;
+
+    // ── Butcher tableau (Verner 2010, checked in 50-digit arithmetic) ──────
+    struct Tableau {
+        static constexpr int stages = 17;
+
+        // Abscissae (c₁₅ = c₁₆ = c₁₇ = 1)
+        static constexpr double c[17] = {0.0, 0.03462, 0.09702435063878044, 0.14553652595817068, 0.561, 0.229007911590485, 0.544992088409515, 0.645, 0.48375, 0.06757, 0.25, 0.6590650618730999, 0.8206, 0.9012, 1.0, 1.0, 1.0};
+
+        // Row 17 = b: stage 17 is f(t+h, y_{n+1}) (FSAL).  Stages 2–7 enter
+        // neither b nor b̂
+        static constexpr double a[17][17] = {{},
+                                             {0.03462},
+                                             {-0.038933543885728734, 0.13595789452450918},
+                                             {0.03638413148954267, 0.0, 0.109152394468628},
+                                             {2.02576391439397, 0.0, -7.638023836496292, 6.173259922102322},
+                                             {0.05112275589406061, 0.0, 0.0, 0.17708237945550215, 0.0008027762409222502},
+                                             {0.13160063579752163, 0.0, 0.0, -0.29572762526696367, 0.08781378035642952, 0.6213052975225275},
+                                             {0.07166666666666667, 0.0, 0.0, 0.0, 0.0, 0.33055335789153195, 0.24277997544180138},
+                                             {0.071806640625, 0.0, 0.0, 0.0, 0.0, 0.3294380283228177, 0.11651900292718229, -0.034013671875},
+                                             {0.04836757646340647, 0.0, 0.0, 0.0, 0.0, 0.03928989925676164, 0.10547409458903446, -0.021438652846483126, -0.10412291746271944},
+                                             {-0.026645614872014785, 0.0, 0.0, 0.0, 0.0, 0.03333333333333333, -0.1631072244872467, 0.033960816841277615, 0.1572319413814626, 0.21522674780318796},
+                                             {0.036890092487086225, 0.0, 0.0, 0.0, 0.0, -0.1465181576725543, 0.22425777681720244, 0.022944057170660725, -0.003585005290572876, 0.08669223316444385, 0.43838406519683376},
+                                             {-0.48660122151133406, 0.0, 0.0, 0.0, 0.0, -6.304602650282853, -0.2812456182894726, -2.6790192362198493, 0.5188156639241576, 1.3653531876033418, 5.8850910885039465, 2.8028087862720628},
+                                             {0.41853674577534716, 0.0, 0.0, 0.0, 0.0, 6.724547581906459, -0.4254442801646118, 3.3432791530012658, 0.6170816631175378, -0.9299661239399328, -6.099948804751011, -3.002206187889399, 0.2553202529443446},
+                                             {-0.7793740861228846, 0.0, 0.0, 0.0, 0.0, -13.937342538107776, 1.2520488533793572, -14.69150040801687, -0.4947050585331417, 2.2429749091462368, 13.367893803828643, 14.396650486650687, -0.79758133317768, 0.4409353709534278},
+                                             {2.0580513374668863, 0.0, 0.0, 0.0, 0.0, 22.357937727968032, 0.9094981099755634, 35.89110098240264, -3.4425150276244536, -4.8654813580363685, -18.909803813543427, -34.26354448030452, 1.2647565216956427},
+                                             {0.014611976858423152, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.3915211862331339, 0.23109325002895065, 0.12747667699928525, 0.2246434176204158, 0.5684352689748513, 0.058258715572158275, 0.13643174034822156, 0.030570139830827976}};
+
+        // 9th-order solution weights (b₁₆ = b₁₇ = 0)
+        static constexpr double b[17] = {0.014611976858423152, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.3915211862331339, 0.23109325002895065, 0.12747667699928525, 0.2246434176204158, 0.5684352689748513, 0.058258715572158275, 0.13643174034822156, 0.030570139830827976, 0.0, 0.0};
+
+        // Error weights e = b − b̂  (embedded 8th-order, b̂₁₄ = b̂₁₅ = 0)
+        static constexpr double e[17] = {-0.005357988290444578, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -2.583020491182464, 0.14252253154686625, 0.013420653512688676, -0.028672962914094935, 2.624999655215792, -0.2825509643291537, 0.13643174034822156, 0.030570139830827976, -0.048342313738239585, 0.0};
+    };
+
+    // ── Continuous extension (DenseMode::HighOrder) ─────────────────────────
+    // Stages 18–28 and the weights p over all 28 stages
+    struct Dense {
+        static constexpr int stages = 28;
+
+        // Abscissae of stages 18–28
+        static constexpr double c[11] = {0.4, 0.35, 0.6, 0.3, 0.1, 0.55, 0.85, 0.05, 0.7, 0.95, 0.15};
+
+        // Row of stage 18 + i over stages 1 … 17 + i
+        static constexpr double a[11][27] = {{0.009054339309058468, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.009824434944806976, 0.06040667875045027, 0.13897042520782446, 0.20978722329537106, -0.012198754727103736, -0.0029069483870785167, 0.01020510498097406, -0.00116454449489636, -0.00116454449489636, -0.00116454449489636},
+                                             {0.01396924021396525, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.005687585349407023, 0.04746127529610383, 0.12945669207448707, 0.2136941082882772, -0.006153565701385361, 0.0028706516644587095, -0.00033203620386304853, 0.010645020593252053, 0.006343511035791418, -0.017157079272077054, -0.045110232639603044},
+                                             {0.003717380741205133, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.033030146515502214, 0.0908472663328861, 0.15524164028615184, 0.1410515445365641, 0.026947273148642373, -0.011696285160147823, 0.0003345068548734857, -0.008867880078622504, -0.011060240654420635, 0.021078432592384642, 0.07200294702780495, 0.0873732678571761},
+                                             {0.011660014608852345, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.010806768535139247, 0.029298893949009072, 0.13588556504406302, 0.17981922522122962, -0.010994334465144997, 0.00030906001147631214, 0.0013977294227064388, 0.01013261691887438, 0.00513229022133714, -0.015670313924398743, -0.071502096029392, 0.011213840770444787, 0.024124276786081866},
+                                             {0.025481824412096562, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0002019748216165057, 0.001298201806849639, 0.07407527037942858, 0.006518185550556322, -0.0009973758350833915, -0.005310427507796099, 0.004662472052052623, -0.0018943136248867922, -0.004249189100308476, 0.0051557507610286565, 0.00013750003152421364, -0.004494028569062532, 0.003671922596659846, -0.004257767774675665},
+                                             {0.079765686518145, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.0762726551796206, -0.40244340157063907, -0.49111063790658405, -0.6774303688592199, -0.06822187559102881, -0.06816997541772186, 0.04788066942328092, 0.025331370429980505, -0.009349483128175545, -0.023813122184935843, 0.0, 0.5048126860910185, 0.4348956518431003, 0.49109765706000574, 0.7830277984723948},
+                                             {0.004408580197982551, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.05086596943103812, 0.17949477646954393, 0.17524813933145683, 0.2619250110280143, 0.04714015908825941, 0.05703945212363349, 0.026196588050022493, 0.0019630414494706924, 0.005642502112926196, -0.012814656269097445, 0.0, 0.31027155695583297, 0.4487009250194703, -0.24831553531349496, -0.0365876984766017, -0.4211788111984572},
+                                             {0.02783873371598724, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.008470801293118968, -0.004756968529318938, 0.013748846237458189, 0.009947709634921443, -0.008224028494904556, -0.012705399147063264, -0.02066653027962387, -0.005621887367645591, -0.000768996208140928, 0.00858589129487296, 0.0, 0.03207942195013897, 0.005032051406760959, -0.04575377875446391, 0.013983391170414384, 0.009779746041730032, 0.03597259862199586},
+                                             {0.015683421565205354, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.01846027837739941, 0.06875959315041037, 0.06975291406668724, 0.1027417574506356, 0.01707453699703553, 0.02025415528780986, 0.0071901037669240275, -4.146573453535676e-05, 0.00207302535293558, -0.002961441329272675, 0.0, 0.06301735285440234, 0.09777510013985775, 0.09458949646345488, 0.06415900757791017, 0.06698687404322456, -0.02009066927949103, 0.014575959249406389},
+                                             {0.0193101122453288, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.045051651085909104, 0.09513978933334949, 0.04593457387039184, 0.0957122528692069, 0.042879162763626424, 0.05879469451352947, 0.06486975580496245, 0.015258920553712377, 0.004570143930152523, -0.014794101643151918, 0.0, 0.05570785320748051, 0.05854194187965786, 0.09798400332700256, 0.0892997588649228, 0.046378487269863725, 0.06280322074362499, 0.014301789839661815, 0.052255989540768266},
+                                             {0.017025668457968136, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, -0.0007134482747264843, 0.009761056900795439, 0.018507037106260404, 0.022486392580923276, -0.0008374021746656189, -0.0023618038414158315, -0.00832298846260591, -0.0026116552555524833, 4.44370191976451e-06, 0.0009998990373869697, 0.0, -0.012310969160624186, -0.00098768512464831, -0.0038506738610148772, 0.05428671054906107, -0.00551143063271917, 0.004907410529692135, 0.049335590286266884, 0.00379533120782207, 0.006398516429876724}};
+
+        // Dense-output polynomial: contributes p[i][j]*k[i] to the j-th degree
+        // term (j = 1..9); p[i][0] = δᵢ₀, and rows 2–7, 16 and 18–22 are zero
+        static constexpr double p[28][9] = {{1.0, -18.098371893538545, 141.2654713956803, -577.7108571646826, 1365.0502141531706, -1935.839082361116, 1628.2944595608915, -749.4909601552905, 145.5437384417436},
+                                            {},
+                                            {},
+                                            {},
+                                            {},
+                                            {},
+                                            {},
+                                            {0.0, -7.161392465445887, 158.23107194260083, -1155.0316427966634, 3797.3645154531227, -6627.772922242192, 6414.787639523185, -3263.3367352225505, 682.5279446217099},
+                                            {0.0, 4.226972939817563, -93.39502932800877, 681.7511429923478, -2241.373744965447, 3912.0069076997593, -3786.2935033616295, 1926.1667531636197, -402.8584058904302},
+                                            {0.0, 2.3317014411556305, -51.51897766591556, 376.0705699462947, -1236.3964628384608, 2157.9584904766393, -2088.6119083619096, 1062.520592916669, -222.2265292374733},
+                                            {0.0, 4.108997762897339, -90.78836605731442, 662.7234101785298, -2178.816811701034, 3802.822459722446, -3680.6177272706036, 1872.4072740475453, -391.61459326484606},
+                                            {0.0, 10.39736340067745, -229.7298973913343, 1676.9481336742585, -5513.254443533038, 9622.620732242105, -9313.395201856702, 4737.919070711984, -990.9373219789771},
+                                            {0.0, 1.0656218396737709, -23.544930233973528, 171.8697795180485, -565.0513612253347, 986.2187568154718, -954.5263492439598, 485.5875323188749, -101.56079107322873},
+                                            {0.0, 2.495500299173179, -55.138115844998275, 402.4890164952155, -1323.2516343862828, 2309.5521422840334, -2235.3340570011355, 1137.1612208581357, -237.8376409637931},
+                                            {0.0, 0.5591645529030412, -12.35474902751954, 90.1853592369831, -296.49982761571965, 517.4993132536958, -500.8693322882432, 254.80271264663534, -53.29207061890412},
+                                            {},
+                                            {0.0, -1.0422007743263988, 23.97805873430647, -191.00871964924568, 718.2844800670065, -1456.5863452212318, 1642.9457962198373, -971.7998257833304, 235.22875640698416},
+                                            {},
+                                            {},
+                                            {},
+                                            {},
+                                            {},
+                                            {0.0, -7.141864255121975, 160.68323017105917, -1219.627974826876, 4246.577484557922, -7824.711898432159, 7935.039287994809, -4198.219276030951, 907.4010108213175},
+                                            {0.0, -5.3192946510765085, 120.87796487233521, -938.1956989747629, 3393.032089051198, -6580.87590287751, 7076.772077472499, -3980.099034319923, 913.8077994272394},
+                                            {0.0, 23.34658859158544, -236.1423639013884, 1008.4946036104607, -2357.176851049041, 3257.1278523884953, -2661.8549400280763, 1191.9887723017584, -225.78366191379456},
+                                            {0.0, 1.0781595005371991, -27.577982362771277, 263.2308953687773, -1196.5519154866518, 2743.5191780089854, -3297.5143408315384, 1992.4451104117081, -478.6291046090466},
+                                            {0.0, 0.6887840597171716, -17.736776425548015, 171.6949017595265, -801.5539402845578, 1923.7536511970993, -2452.705143717544, 1583.489756319657, -407.6312329083501},
+                                            {0.0, -11.535730348628471, 232.89139112279014, -1423.8829193682118, 4189.618209803148, -6807.293332954522, 6273.883243190118, -3081.542964184543, 627.8621027398494}};
+    };
+
+    using RK = ExplicitRK<Tableau>;
+    static_assert(RK::fsal, "Vern9: stage 17 must be the FSAL stage");
+
+    // Row of extra stage 18 + I for ExplicitRK::combine
+    template <int I>
+    struct XRow {
+        static constexpr int size = 17 + I;
+        [[nodiscard]] static constexpr double at(int j)
+        {
+            return Dense::a[I][j];
+        }
+    };
+
+    // Stages 1–28 of one step as a sequence for ExplicitRK::combine.  Stage 1
+    // comes from the segment: after an accepted step solve_impl has already
+    // recycled ws.k[0] as the next step's FSAL stage.
+    struct DenseStages {
+        const Vec<N> &f0;
+        const std::array<Vec<N>, 17> &k;
+        const std::array<Vec<N>, kExtra> &x;
+
+        [[nodiscard]] const Vec<N> &operator[](int j) const
+        {
+            return j == 0 ? f0 : (j < 17 ? k[static_cast<std::size_t>(j)] : x[static_cast<std::size_t>(j - 17)]);
+        }
+    };
+
+    // Stage differences kᵢ − f₀ as a sequence for ExplicitRK::combine
+    struct StageDiffs {
+        const DenseStages &k;
+
+        [[nodiscard]] auto operator[](int j) const
+        {
+            return k[j] - k.f0;
+        }
+    };
+
+    // Column D ≥ 1 of p without stage 1, whose difference is zero
+    template <int D>
+    struct DRow {
+        static constexpr int size = Dense::stages;
+        [[nodiscard]] static constexpr double at(int j)
+        {
+            return j == 0 ? 0.0 : Dense::p[j][D];
+        }
+    };
+
+  public:
+    Vern9()
+    {
+        // With 0.8 the PI controller settles at an error norm near 1e-3,
+        // which at rtol ≤ 1e-14 asks for less than a rounding error per step
+        this->options.controller.kind = ControllerKind::PI;
+        this->options.controller.safety = 0.9;
+        this->options.controller.min_factor = 0.1;
+        this->options.controller.max_factor = 5.0;
+    }
+
+    // ── CRTP capability queries ─────────────────────────────────────────────
+
+    [[nodiscard]] static constexpr int method_order()
+    {
+        return 9;
+    }
+    [[nodiscard]] static constexpr int adaptive_order()
+    {
+        return 8;
+    }
+    [[nodiscard]] static constexpr bool has_fsal()
+    {
+        return true;
+    }
+
+    // ── Dense output (9th order, or the Hermite cubic with DenseMode::Standard)
+
+    [[nodiscard]] bool has_dense_output() const noexcept
+    {
+        return m_last.valid;
+    }
+
+    [[nodiscard]] const Segment &last_dense_step() const noexcept
+    {
+        return m_last;
+    }
+
+    [[nodiscard]] int dense_history_size() const noexcept
+    {
+        return static_cast<int>(m_dense_hist.size());
+    }
+
+    [[nodiscard]] const DenseHistory<N, kDenseQ> &dense_history() const noexcept
+    {
+        return m_dense_hist;
+    }
+
+    [[nodiscard]] const Segment &dense_segment(int i) const
+    {
+        if (i < 0 || i >= dense_history_size())
+        {
+            throw std::out_of_range("Vern9: dense history index out of range");
+        }
+        return m_dense_hist[static_cast<std::size_t>(i)];
+    }
+
+    [[nodiscard]] Vec<N> dense_eval_theta(double theta) const
+    {
+        return m_last.eval_theta(theta);
+    }
+
+    [[nodiscard]] Vec<N> dense_eval(double t) const
+    {
+        return m_last.eval(t);
+    }
+
+    // Lookup in the retained dense history (see DenseRetention) — O(1)
+    // expected.  Segments no query has refined yet still hold the Hermite
+    // cubic; the overloads taking the system refine them first.
+    [[nodiscard]] Vec<N> interpolate(double t) const
+    {
+        if (m_dense_hist.empty())
+        {
+            throw std::out_of_range("Vern9: no dense segments stored");
+        }
+        if (const Segment *seg = m_dense_hist.find(t))
+        {
+            return seg->eval(t);
+        }
+        throw std::out_of_range("Vern9: interpolation time outside stored dense history");
+    }
+
+    // interpolate() at every time in sorted_t (ordered in the integration
+    // direction), column j of `out` for sorted_t[j] — O(n + m) merge walk
+    void interpolate_many(ColumnView sorted_t, Eigen::Matrix<double, N, Eigen::Dynamic> &out) const
+    {
+        if (m_dense_hist.empty())
+        {
+            throw std::out_of_range("Vern9: no dense segments stored");
+        }
+        if (m_dense_hist.eval_many(sorted_t.data, sorted_t.size, out) != sorted_t.size)
+        {
+            throw std::out_of_range("Vern9: interpolation times unsorted or outside stored dense history");
+        }
+    }
+
+    // interpolate() after refining the segment containing t to 9th order
+    // (DenseMode::HighOrder).  Recomputes that step's stages from the
+    // stored start point: 28 evaluations of the ODE system `sys`, once per
+    // segment.  Not for use inside solve(); DDE systems are not supported.
+    template <typename System>
+    [[nodiscard]] Vec<N> interpolate(double t, System &sys)
+    {
+        if (m_dense_hist.empty())
+        {
+            throw std::out_of_range("Vern9: no dense segments stored");
+        }
+        if (Segment *seg = m_dense_hist.find(t))
+        {
+            refine_stored(*seg, sys);
+            return seg->eval(t);
+        }
+        throw std::out_of_range("Vern9: interpolation time outside stored dense history");
+    }
+
+    template <typename System>
+    void interpolate_many(ColumnView sorted_t, Eigen::Matrix<double, N, Eigen::Dynamic> &out, System &sys)
+    {
+        if constexpr (kHighOrder)
+        {
+            for (double t : sorted_t)
+            {
+                if (Segment *seg = m_dense_hist.find(t))
+                {
+                    refine_stored(*seg, sys);
+                }
+            }
+        }
+        interpolate_many(sorted_t, out);
+    }
+
+    [[nodiscard]] double interpolate_component(double t, int component) const
+    {
+        return interpolate(t)[component];
+    }
+
+    // ── Lifecycle hooks ──────────────────────────────────────────────────────
+
+    void before_solve()
+    {
+        m_last.reset(this->dimension());
+        m_pending.reset(this->dimension());
+        for (auto &k : m_kx)
+        {
+            k.resize(this->dimension());
+        }
+        m_dense_hist.reset(this->options.dense_retention, static_cast<std::size_t>(this->options.reserve_steps));
+    }
+
+    void after_step(double /*t*/)
+    {
+        m_last = m_pending;
+        m_dense_hist.push(m_pending);
+    }
+
+    // Called by the base class before events or uniform output read
+    // last_dense_step().  Stages 2–17 of the accepted step are still in
+    // m_ws, so only the eleven extra stages are evaluated.
+    template <typename RhsEval>
+    void refine_dense_step(RhsEval &&rhs, SolverStats &stats)
+    {
+        if constexpr (kHighOrder)
+        {
+            if (m_last.order >= 9)
+            {
+                return;
+            }
+            extend_dense(m_last, this->m_ws, rhs, stats);
+            if (!m_dense_hist.empty() && m_dense_hist.back().t0 == m_last.t0)
+            {
+                m_dense_hist.back() = m_last;
+            }
+        }
+    }
+
+    // ── Step computation ─────────────────────────────────────────────────────
+    //
+    // solve_impl guarantees ws.k[0] = f(t, y) on entry (FSAL or fresh eval).
+
+    // Reduced by ExplicitRK in the pass that wrote ws.error
+    [[nodiscard]] double step_error_norm() const noexcept
+    {
+        return m_err_norm;
+    }
+
+    template <typename RhsEval>
+    void compute_step(double t, const Vec<N> &y, double h, RhsEval &&rhs, WorkspaceT &ws, SolverStats &stats)
+    {
+        // Stages 2–17, y_{n+1}, error and ws.fsal = k[16] (recycled by
+        // solve_impl as k[0] of the next step)
+        if (this->owns_error_norm())
+        {
+            auto norm = this->error_norm_sum();
+            m_err_norm = RK::step(t, y, h, rhs, ws, stats, norm);
+        }
+        else
+        {
+            RK::step(t, y, h, rhs, ws, stats);
+        }
+
+        // Hermite cubic from f₀ and the FSAL stage, no extra evaluation.
+        // Committed in after_step() only if the step is accepted.
+        build_hermite<N>(m_pending, t, y, h, ws.next, ws.k[0], ws.k[16]);
+    }
+
+  private:
+    Segment m_last{};
+    Segment m_pending{};
+    DenseHistory<N, kDenseQ> m_dense_hist{};
+    double m_err_norm = 0.0;
+    std::array<Vec<N>, kExtra> m_kx{};  // extra stages 18–28
+
+    // Extra stages 18–28 and the 9th-order coefficients.  Expects ws.k[1..16]
+    // to hold stages 2–17 of the step `seg` describes and seg to hold its
+    // Hermite cubic (q[0] = f₀).  HighOrder only.
+    template <typename RhsEval>
+    void extend_dense(Segment &seg, WorkspaceT &ws, RhsEval &&rhs, SolverStats &stats)
+    {
+        extra_stages(seg, ws, rhs, stats, std::make_index_sequence<kExtra>{});
+
+        // q[0] = f₀ already (p[i][0] = δᵢ₀)
+        const DenseStages k{seg.q[0], ws.k, m_kx};
+        coefficients(seg, k, std::make_index_sequence<kDenseQ - 1>{});
+        seg.order = 9;
+    }
+
+    template <typename RhsEval, std::size_t... Is>
+    void extra_stages(const Segment &seg, WorkspaceT &ws, RhsEval &rhs, SolverStats &stats, std::index_sequence<Is...>)
+    {
+        (extra_stage<static_cast<int>(Is)>(seg, ws, rhs, stats), ...);
+    }
+
+    template <int I, typename RhsEval>
+    void extra_stage(const Segment &seg, WorkspaceT &ws, RhsEval &rhs, SolverStats &stats)
+    {
+        const DenseStages k{seg.q[0], ws.k, m_kx};
+        RK::template combine<XRow<I>>(ws.stage, seg.y0, seg.h, k);
+        rhs(seg.t0 + Dense::c[I] * seg.h, ws.stage, m_kx[static_cast<std::size_t>(I)]);
+        ++stats.rhs_evals;
+    }
+
+    // q[D] = Σᵢ p[i][D]·(kᵢ − f₀) for D ≥ 1.  Those columns of p sum to
+    // zero, so the differences give the same polynomial, but the rounding
+    // of the large coefficients then scales with |kᵢ − f₀| = O(h) instead
+    // of |f|.
+    template <std::size_t... Is>
+    static void coefficients(Segment &seg, const DenseStages &k, std::index_sequence<Is...>)
+    {
+        const StageDiffs d{k};
+        (RK::template combine<DRow<static_cast<int>(Is) + 1>>(seg.q[Is + 1], 1.0, d), ...);
+    }
+
+    // Refine a stored segment after solve(): rebuild stages 1–17 from its
+    // start point, then extend.  Uses m_ws and m_pending as scratch.
+    template <typename System>
+    void refine_stored(Segment &seg, System &sys)
+    {
+        if constexpr (kHighOrder)
+        {
+            if (seg.order >= 9)
+            {
+                return;
+            }
+            auto rhs = [&](double ts, const Vec<N> &ys, Vec<N> &out) { sys(ts, ys, out); };
+            SolverStats scratch;
+            rhs(seg.t0, seg.y0, this->m_ws.k[0]);
+            compute_step(seg.t0, seg.y0, seg.h, rhs, this->m_ws, scratch);
+            extend_dense(seg, this->m_ws, rhs, scratch);
+            if (m_last.valid && m_last.t0 == seg.t0 && m_last.h == seg.h)
+            {
+                m_last = seg;
+            }
+        }
+    }
+};
+
+}  // namespace DES
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "DES.hpp"
+#include "des_dense_output.hpp"
+#include "des_output.hpp"
 #include "history.hpp"
 
 #include <algorithm>
@@ -60,8 +62,10 @@ class DelayHistoryView {
     // Return the full N-dimensional state vector at a past time
     [[nodiscard]] Vec<N> state(double t) const
     {
+        const auto n = static_cast<Eigen::Index>(m_history ? m_history->size() : 0);
         Vec<N> out;
-        for (int i = 0; i < N; ++i)
+        out.resize(n);
+        for (Eigen::Index i = 0; i < n; ++i)
         {
             out[i] = (*this)(static_cast<std::size_t>(i), t);
         }
@@ -99,7 +103,7 @@ class DelayHistoryView {
 };
 
 // ---------------------------------------------------------------------------
-// AdaptiveDES<Derived, N, HistoryPoints, MaxStages>
+// AdaptiveDES<Derived, N, HistoryPoints, MaxStages, WorkspaceT>
 //
 // CRTP base class for explicit adaptive Runge–Kutta solvers.
 //
@@ -108,13 +112,41 @@ class DelayHistoryView {
 //   static constexpr int  adaptive_order()
 //   static constexpr bool has_fsal()
 //   void compute_step(double t, const Vec<N>&, double h,
-//                     RhsEval&&, Workspace<N,MaxStages>&, SolverStats&)
+//                     RhsEval&&, WorkspaceT&, SolverStats&)
+//
+// WorkspaceT defaults to Workspace<N,MaxStages>; LowStorageWorkspace<N>
+// drops the fsal register and returns the FSAL value in k[0].
 //
 // Optional hooks Derived MAY override:
 //   void before_solve()
 //   void after_step(double t)
 //   void after_capture(double t)
 //   void after_solve()
+//   void refine_dense_step(RhsEval&&, SolverStats&)
+//        — called before events or uniform output evaluate
+//          last_dense_step(); lets a solver finish a lazily built
+//          dense segment while the step's stages are still in m_ws
+//   void after_breaking_point(double t)
+//        — an accepted step ended on a DDE breaking point; solvers that
+//          carry information across steps restart from (t, y) there
+//   double next_step_size(double err_norm, bool accepted, double h_abs)
+//        — replaces the StepController (see HasNextStepSize); the
+//          result is still clipped to h_min / h_max / min_delay
+//   double step_failure() const
+//        — nonzero when compute_step() could not produce a step (Radau5's
+//          Newton iteration failed); the step is rejected and retried
+//          with h scaled by the returned factor (see HasStepFailure)
+//   double hold_step_size(double next_h, double h_abs) const
+//        — after an accepted step, may replace the proposed step size
+//          (see HasHoldStepSize); Rosenbrock4 under JacobianPolicy::Reuse
+//          keeps h while the growth is small so its W stays factored
+//   int controller_order() const
+//        — order the StepController uses for the step just computed;
+//          defaults to adaptive_order(), a solver that changes method
+//          mid-solve (AutoSwitch) reports the active one
+//   double step_error_norm() const
+//        — scaled error norm of the step just computed, when compute_step
+//          reduced it alongside ws.error (see HasStepErrorNorm)
 //
 // Features
 // ────────
@@ -128,7 +160,7 @@ class DelayHistoryView {
 //   • Observer callbacks (adaptive or uniform-grid output)
 // ---------------------------------------------------------------------------
 
-template <typename Derived, int N, int HistoryPoints = 5000, int MaxStages = 16>
+template <typename Derived, int N, int HistoryPoints = 5000, int MaxStages = 16, typename WorkspaceT = Workspace<N, MaxStages>>
 class AdaptiveDES {
   public:
     using DelayHistoryStorage = DES::History<double, double>;
@@ -156,7 +188,7 @@ class AdaptiveDES {
         // Tolerances
         double rtol = 1.0e-9;
         double atol = 1.0e-9;
-        std::array<double, N> atol_vec{};
+        ComponentArray<N> atol_vec{};  // one entry per component
         bool use_vector_atol = false;
 
         // Step-size bounds
@@ -172,6 +204,25 @@ class AdaptiveDES {
         bool uniform_output = false;
         int output_points = HistoryPoints;
 
+        // Capacity hint for step-wise output and dense history (0 → grow on
+        // demand).  With a large enough hint, and fixed N, the accepted-step
+        // path performs no heap allocation.
+        long reserve_steps = 0;
+
+        // Streaming output (des_output.hpp).  When set, recorded points go
+        // to the sink in batches of sink_batch instead of OutputHistory.
+        // The sink must outlive every solve() that uses it.
+        OutputSink<N> *sink = nullptr;
+        int sink_batch = 256;
+
+        // Recorded-state layout.  SoA columns grow in whole multiples of
+        // history_chunk points.
+        HistoryLayout history_layout = HistoryLayout::AoS;
+        int history_chunk = 4096;
+
+        // Dense segments kept for interpolate() (des_dense_output.hpp)
+        DenseRetention dense_retention{};
+
         // DDE: cap step size so α(t,y) stays before step start
         double min_delay = std::numeric_limits<double>::infinity();
 
@@ -195,11 +246,52 @@ class AdaptiveDES {
     // OutputHistory — recorded solution points
     // -----------------------------------------------------------------------
 
+    // With HistoryLayout::AoS the states are in y; with SoA they are in
+    // components (one contiguous series per state component) and y stays
+    // empty.  state(j) reads point j in either layout.
+
     struct OutputHistory {
         std::vector<double> t{};
         std::vector<double> h{};
         std::vector<double> error{};
         std::vector<Vec<N>> y{};
+        std::vector<std::vector<double>> components{};
+        HistoryLayout layout = HistoryLayout::AoS;
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return t.size();
+        }
+
+        // Component i over all recorded points (SoA only)
+        [[nodiscard]] ColumnView component(std::size_t i) const
+        {
+            if (layout != HistoryLayout::SoA)
+            {
+                throw std::logic_error("DES: OutputHistory::component() requires HistoryLayout::SoA");
+            }
+            const std::vector<double> &c = components.at(i);
+            return ColumnView{c.data(), c.size()};
+        }
+
+        // State at point j, gathered from the columns in SoA mode
+        [[nodiscard]] Vec<N> state(std::size_t j) const
+        {
+            if (layout == HistoryLayout::AoS)
+            {
+                return y.at(j);
+            }
+            if (j >= t.size())
+            {
+                throw std::out_of_range("DES: OutputHistory::state() index out of range");
+            }
+            Vec<N> out(static_cast<Eigen::Index>(components.size()));
+            for (std::size_t i = 0; i < components.size(); ++i)
+            {
+                out[static_cast<Eigen::Index>(i)] = components[i][j];
+            }
+            return out;
+        }
     };
 
     Options options{};
@@ -219,6 +311,40 @@ class AdaptiveDES {
         return static_cast<int>(m_hist.t.size());
     }
 
+    // Bytes currently held by the step registers, dense history, recorded
+    // output and, if given, the DDE history used with this solver
+    [[nodiscard]] MemoryUsage memory_usage(const DelayHistoryStorage *dh = nullptr) const
+    {
+        MemoryUsage mu{};
+        mu.workspace = static_cast<std::size_t>(WorkspaceT::registers) * static_cast<std::size_t>(m_ws.next.size()) * sizeof(double);
+        if constexpr (HasDenseHistory<Derived>::value)
+        {
+            mu.dense_history = static_cast<const Derived *>(this)->dense_history().memory_bytes();
+        }
+
+        std::size_t out = (m_hist.t.capacity() + m_hist.h.capacity() + m_hist.error.capacity()) * sizeof(double);
+        out += m_hist.y.capacity() * sizeof(Vec<N>) + m_hist.components.capacity() * sizeof(std::vector<double>);
+        for (const auto &c : m_hist.components)
+        {
+            out += c.capacity() * sizeof(double);
+        }
+        out += m_stage.memory_bytes();
+        if constexpr (N == Eigen::Dynamic)
+        {
+            for (const auto &v : m_hist.y)
+            {
+                out += static_cast<std::size_t>(v.size()) * sizeof(double);
+            }
+        }
+        mu.output_history = out;
+
+        if (dh)
+        {
+            mu.delay_history = dh->memory_bytes();
+        }
+        return mu;
+    }
+
     // Default no-op lifecycle hooks (Derived may override)
     void before_solve()
     {}
@@ -228,6 +354,26 @@ class AdaptiveDES {
     {}
     void after_solve()
     {}
+    void after_breaking_point(double)
+    {}
+    template <typename RhsEval>
+    void refine_dense_step(RhsEval &&, SolverStats &)
+    {}
+    [[nodiscard]] int controller_order() const noexcept
+    {
+        return adaptive_order();
+    }
+
+    // Size the workspace and run before_solve() without integrating, so a
+    // composite solver can drive this one's compute_step() and after_step()
+    // directly (see AutoSwitch).  Uses this solver's own options.
+    void prepare_embedded(Eigen::Index n)
+    {
+        m_embedded = true;
+        reset_workspace(n);
+        m_stats = {};
+        static_cast<Derived *>(this)->before_solve();
+    }
 
     // -----------------------------------------------------------------------
     // solve() overloads — ODE, DDE, with/without observer
@@ -267,7 +413,7 @@ class AdaptiveDES {
     }
 
   protected:
-    Workspace<N, MaxStages> m_ws{};
+    WorkspaceT m_ws{};
     SolverStats m_stats{};
 
     // ── Order queries ───────────────────────────────────────────────────────
@@ -312,8 +458,102 @@ class AdaptiveDES {
         return v.array().isFinite().all();
     }
 
+    // ── Scaled error norms (Eigen array ops for SIMD) ──────────────────────
+
+    // ‖err / sc‖ with sc = atol + rtol·max(|y0|, |y1|), accumulated over the
+    // whole state or over consecutive blocks of it, so a fused step kernel
+    // can fold the norm into the pass that writes ws.error (ExplicitRK::step).
+    // The absolute tolerances come precomputed per component; y0 and y1 must
+    // be finite (the step loop checks ws.next first), and a non-finite err
+    // yields +∞.
+    class ErrorNormSum {
+      public:
+        ErrorNormSum(const Vec<N> &atol, double rtol, ErrorNorm kind) noexcept
+            : m_atol(atol)
+            , m_rtol(rtol)
+            , m_max(kind == ErrorNorm::Infinity)
+        {}
+
+        template <typename Y0, typename Y1, typename E>
+        void add(const Y0 &y0, const Y1 &y1, const E &err)
+        {
+            accumulate(m_atol, y0, y1, err);
+        }
+
+        // Entries [offset, offset + err.size()) of the state
+        template <typename Y0, typename Y1, typename E>
+        void add(Eigen::Index offset, const Y0 &y0, const Y1 &y1, const E &err)
+        {
+            accumulate(m_atol.segment(offset, err.size()), y0, y1, err);
+        }
+
+        [[nodiscard]] double result() const noexcept
+        {
+            const double r = m_max ? m_acc : std::sqrt(m_acc / static_cast<double>(m_count));
+            return std::isfinite(r) ? r : std::numeric_limits<double>::infinity();
+        }
+
+      private:
+        const Vec<N> &m_atol;
+        double m_rtol;
+        bool m_max;
+        double m_acc = 0.0;
+        Eigen::Index m_count = 0;
+
+        template <typename A, typename Y0, typename Y1, typename E>
+        void accumulate(const A &atol, const Y0 &y0, const Y1 &y1, const E &err)
+        {
+            const auto q = err.array() / (atol.array() + m_rtol * y0.array().abs().max(y1.array().abs()));
+            if (m_max)
+            {
+                const double v = q.abs().template maxCoeff<Eigen::PropagateNaN>();
+                if (!(v <= m_acc))  // keeps a NaN
+                {
+                    m_acc = v;
+                }
+            }
+            else
+            {
+                m_acc += q.square().sum();
+            }
+            m_count += err.size();
+        }
+    };
+
+    [[nodiscard]] ErrorNormSum error_norm_sum() const noexcept
+    {
+        return ErrorNormSum(m_atol, options.rtol, options.error_norm);
+    }
+
+    // One pass over y0, y1 and err; no scale vector is materialised
+    [[nodiscard]] double scaled_error(const Vec<N> &y0, const Vec<N> &y1, const Vec<N> &err) const
+    {
+        ErrorNormSum norm = error_norm_sum();
+        norm.add(y0, y1, err);
+        return norm.result();
+    }
+
+    // False while another solver drives this one through prepare_embedded();
+    // its own tolerances then do not decide acceptance, so fused kernels
+    // need not compute an error norm
+    [[nodiscard]] bool owns_error_norm() const noexcept
+    {
+        return !m_embedded;
+    }
+
+    // State dimension of the current solve (N, or the runtime size for
+    // N = Eigen::Dynamic).  Valid from before_solve() onwards.
+    [[nodiscard]] Eigen::Index dimension() const noexcept
+    {
+        return m_ws.next.size();
+    }
+
   private:
     OutputHistory m_hist{};
+    OutputStage<N> m_stage{};  // pending batch for options.sink
+    bool m_sink_open = false;  // begin() called, end() still owed
+    Vec<N> m_atol{};           // per-component atol, filled by reset_workspace()
+    bool m_embedded = false;   // set by prepare_embedded()
 
     // ── System signature detection ──────────────────────────────────────────
 
@@ -336,12 +576,6 @@ class AdaptiveDES {
         v.setZero();
     }
 
-    // Eigen column vectors are contiguous — avoid per-element copy
-    static std::vector<double> to_std_vector(const Vec<N> &v)
-    {
-        return std::vector<double>(v.data(), v.data() + N);
-    }
-
     [[nodiscard]] double declared_min_delay(const DelayHistoryStorage *dh) const
     {
         if (!dh)
@@ -384,119 +618,194 @@ class AdaptiveDES {
 
     // ── Workspace and output storage reset ─────────────────────────────────
 
-    void reset_workspace()
+    void reset_workspace(Eigen::Index n)
     {
-        for (auto &k : m_ws.k)
+        m_ws.resize(n);
+        m_atol.resize(n);
+        if (options.use_vector_atol)
+        {
+            for (Eigen::Index i = 0; i < n; ++i)
+            {
+                m_atol[i] = options.atol_vec[static_cast<std::size_t>(i)];
+            }
+        }
+        else
         {
-            k.setZero();
+            m_atol.setConstant(options.atol);
         }
-        m_ws.next.setZero();
-        m_ws.error.setZero();
-        m_ws.fsal.setZero();
+        m_ws.set_zero();
     }
 
     void reset_output_storage()
     {
+        const bool soa = options.history_layout == HistoryLayout::SoA;
+        m_hist.layout = options.history_layout;
         m_hist.t.clear();
         m_hist.h.clear();
         m_hist.error.clear();
         m_hist.y.clear();
+        m_hist.components.resize(soa ? static_cast<std::size_t>(dimension()) : 0);
+        for (auto &c : m_hist.components)
+        {
+            c.clear();
+        }
+
+        std::size_t n = 0;
+        if (options.uniform_output && options.output_points > 0)
+        {
+            n = static_cast<std::size_t>(options.output_points);
+        }
+        else if (options.reserve_steps > 0)
+        {
+            n = static_cast<std::size_t>(options.reserve_steps) + 1;
+        }
 
-        if (options.save_history && options.uniform_output && options.output_points > 0)
+        if (options.save_history && !options.sink && n > 0)
         {
-            const auto n = static_cast<std::size_t>(options.output_points);
             m_hist.t.reserve(n);
             m_hist.h.reserve(n);
             m_hist.error.reserve(n);
-            m_hist.y.reserve(n);
+            if (soa)
+            {
+                for (auto &c : m_hist.components)
+                {
+                    c.reserve(n);
+                }
+            }
+            else
+            {
+                m_hist.y.reserve(n);
+            }
         }
-    }
 
-    // ── Recording and observer dispatch ────────────────────────────────────
+        m_event_hits.clear();
+        m_event_hits.reserve(options.events.size());
 
-    void record(double t, double h, double err, const Vec<N> &y)
+        if (options.save_history && options.sink)
+        {
+            m_stage.reset(static_cast<std::size_t>(options.sink_batch), dimension());
+            options.sink->begin(dimension());
+            m_sink_open = true;
+        }
+    }
+
+    // Hand the partially filled batch to the sink and close the stream.
+    void finish_output()
     {
-        if (!options.save_history)
+        if (m_sink_open)
         {
-            return;
+            m_sink_open = false;
+            flush_stage();
+            options.sink->end();
         }
-        m_hist.t.push_back(t);
-        m_hist.h.push_back(h);
-        m_hist.error.push_back(err);
-        m_hist.y.push_back(y);
-        ++m_stats.history_writes;
-        static_cast<Derived *>(this)->after_capture(t);
     }
 
-    template <typename Observer>
-    void notify(Observer &obs, double t, const Vec<N> &y, const Vec<N> &err)
+    // finish_output() for a solve that is unwinding: the points recorded so
+    // far still reach the sink and end() is still called, but a failure
+    // there must not replace the exception in flight.
+    void abort_output() noexcept
     {
-        if constexpr (std::is_invocable_v<Observer, double, const Vec<N> &, const Vec<N> &, const SolverStats &>)
+        if (!m_sink_open)
         {
-            obs(t, y, err, m_stats);
+            return;
         }
-        else if constexpr (std::is_invocable_v<Observer, double, const Vec<N> &, const Vec<N> &>)
+        m_sink_open = false;
+        try
         {
-            obs(t, y, err);
+            flush_stage();
         }
-        else
+        catch (...)
         {
-            static_assert(std::is_invocable_v<Observer, double, const Vec<N> &, const Vec<N> &, const SolverStats &> || std::is_invocable_v<Observer, double, const Vec<N> &, const Vec<N> &>, "Observer must be callable as (t,y,err) or (t,y,err,stats)");
+            m_stage.clear();
         }
+        try
+        {
+            options.sink->end();
+        }
+        catch (...)
+        {}
     }
 
-    // ── Scaled error norms (Eigen array ops for SIMD) ──────────────────────
-
-    // Build sc[i] = atol[i] + rtol·max(|y0[i]|, |y1[i]|)
-    [[nodiscard]] Vec<N> scale_vec(const Vec<N> &y0, const Vec<N> &y1) const
+    void flush_stage()
     {
-        Vec<N> sc;
-        for (int i = 0; i < N; ++i)
+        if (!m_stage.empty())
         {
-            sc[i] = component_atol(i) + options.rtol * std::max(std::abs(y0[i]), std::abs(y1[i]));
+            options.sink->consume(m_stage.view());
+            m_stage.clear();
         }
-        return sc;
     }
 
-    [[nodiscard]] double scaled_error(const Vec<N> &y0, const Vec<N> &y1, const Vec<N> &err) const
+    // ── Recording and observer dispatch ────────────────────────────────────
+
+    void record(double t, double h, double err, const Vec<N> &y)
     {
-        if (!is_finite(err))
+        if (!options.save_history)
         {
-            return std::numeric_limits<double>::infinity();
+            return;
         }
-
-        const Vec<N> sc = scale_vec(y0, y1);
-        if (!(sc.array() > 0.0).all() || !sc.array().isFinite().all())
+        if (options.sink)
         {
-            return std::numeric_limits<double>::infinity();
+            m_stage.push(t, h, err, y);
+            if (m_stage.full())
+            {
+                flush_stage();
+            }
         }
+        else
+        {
+            m_hist.t.push_back(t);
+            m_hist.h.push_back(h);
+            m_hist.error.push_back(err);
+            if (m_hist.layout == HistoryLayout::SoA)
+            {
+                for (std::size_t i = 0; i < m_hist.components.size(); ++i)
+                {
+                    push_chunked(m_hist.components[i], y[static_cast<Eigen::Index>(i)]);
+                }
+            }
+            else
+            {
+                m_hist.y.push_back(y);
+            }
+        }
+        ++m_stats.history_writes;
+        static_cast<Derived *>(this)->after_capture(t);
+    }
 
-        const Vec<N> q = err.array() / sc.array();  // Eigen element-wise
-
-        if (options.error_norm == ErrorNorm::Infinity)
+    // Append to an SoA column; capacity grows geometrically, rounded up to
+    // a whole number of history_chunk points.
+    void push_chunked(std::vector<double> &column, double v)
+    {
+        if (column.size() == column.capacity())
         {
-            return q.array().abs().maxCoeff();
+            const auto chunk = static_cast<std::size_t>(options.history_chunk);
+            column.reserve((2 * column.size() / chunk + 1) * chunk);
         }
-        return std::sqrt(q.squaredNorm() / static_cast<double>(N));
+        column.push_back(v);
     }
 
-    [[nodiscard]] double weighted_norm(const Vec<N> &v, const Vec<N> &ref) const
+    template <typename Observer>
+    void notify(Observer &obs, double t, const Vec<N> &y, const Vec<N> &err)
     {
-        Vec<N> sc;
-        for (int i = 0; i < N; ++i)
+        if constexpr (std::is_invocable_v<Observer, double, const Vec<N> &, const Vec<N> &, const SolverStats &>)
         {
-            sc[i] = component_atol(i) + options.rtol * std::abs(ref[i]);
+            obs(t, y, err, m_stats);
         }
-        if (!(sc.array() > 0.0).all() || !sc.array().isFinite().all())
+        else if constexpr (std::is_invocable_v<Observer, double, const Vec<N> &, const Vec<N> &>)
         {
-            return std::numeric_limits<double>::infinity();
+            obs(t, y, err);
         }
-        const Vec<N> q = v.array() / sc.array();
-        if (options.error_norm == ErrorNorm::Infinity)
+        else
         {
-            return q.array().abs().maxCoeff();
+            static_assert(std::is_invocable_v<Observer, double, const Vec<N> &, const Vec<N> &, const SolverStats &> || std::is_invocable_v<Observer, double, const Vec<N> &, const Vec<N> &>, "Observer must be callable as (t,y,err) or (t,y,err,stats)");
         }
-        return std::sqrt(q.squaredNorm() / static_cast<double>(N));
+    }
+
+    [[nodiscard]] double weighted_norm(const Vec<N> &v, const Vec<N> &ref) const
+    {
+        const auto q = v.array() / (m_atol.array() + options.rtol * ref.array().abs());
+        const double r = (options.error_norm == ErrorNorm::Infinity) ? q.abs().template maxCoeff<Eigen::PropagateNaN>() : std::sqrt(q.square().sum() / static_cast<double>(v.size()));
+        return std::isfinite(r) ? r : std::numeric_limits<double>::infinity();
     }
 
     // ── Automatic initial step (Hairer & Wanner §II.4) ─────────────────────
@@ -531,9 +840,11 @@ class AdaptiveDES {
             h0 = std::min(h0, md);
         }
 
-        // Euler trial step to estimate curvature
-        Vec<N> f_trial;
-        call_rhs(t + dir * h0, y + (dir * h0) * m_ws.k[0], sys, f_trial, dh, t);
+        // Euler trial step to estimate curvature (next and stage are free
+        // here, and every workspace has them besides k[0])
+        Vec<N> &f_trial = m_ws.next;
+        m_ws.stage.noalias() = y + (dir * h0) * m_ws.k[0];
+        call_rhs(t + dir * h0, m_ws.stage, sys, f_trial, dh, t);
         ++m_stats.rhs_evals;
 
         if (!is_finite(f_trial))
@@ -583,6 +894,14 @@ class AdaptiveDES {
         {
             throw std::invalid_argument("DES: invalid controller factor bounds");
         }
+        if (!(options.history_chunk > 0))
+        {
+            throw std::invalid_argument("DES: history_chunk must be positive");
+        }
+        if (options.sink && !(options.sink_batch > 0))
+        {
+            throw std::invalid_argument("DES: sink_batch must be positive");
+        }
         if (options.use_vector_atol)
         {
             for (double a : options.atol_vec)
@@ -685,14 +1004,19 @@ class AdaptiveDES {
 
     // ── Uniform-output flush ────────────────────────────────────────────────
 
-    template <typename Observer>
-    void flush_uniform(Observer &obs, double t1, double out_t0, double &next_out_t, double out_dt, int &next_out_i, double h, double err)
+    template <typename Observer, typename RhsEval>
+    void flush_uniform(Observer &obs, double t1, double out_t0, double &next_out_t, double out_dt, int &next_out_i, double h, double err, RhsEval &&rhs)
     {
         if constexpr (HasLastDenseStep<Derived>::value)
         {
             const auto &seg = static_cast<Derived *>(this)->last_dense_step();
             const double d = (t1 >= seg.t0) ? 1.0 : -1.0;
 
+            if (next_out_i < options.output_points && seg.contains(next_out_t))
+            {
+                static_cast<Derived *>(this)->refine_dense_step(rhs, m_stats);
+            }
+
             while (next_out_i < options.output_points && seg.contains(next_out_t))
             {
                 const Vec<N> val = seg.eval(next_out_t);
@@ -719,7 +1043,7 @@ class AdaptiveDES {
 
     [[nodiscard]] SolveResult make_result(SolveStatus st, double t, double h, double err) const
     {
-        return SolveResult{st, t, h, err, static_cast<long>(m_hist.t.size()), -1, m_stats.breaking_points_crossed};
+        return SolveResult{st, t, h, err, m_stats.history_writes, -1, m_stats.breaking_points_crossed};
     }
 
     // ── Event detection on a single accepted step ───────────────────────────
@@ -731,8 +1055,10 @@ class AdaptiveDES {
     // Non-terminal events are counted in m_stats but do not stop integration.
 
     using EventHit = std::tuple<double, Vec<N>, int>;
+    std::vector<EventHit> m_event_hits{};  // per-step scratch, capacity kept across steps
 
-    [[nodiscard]] std::optional<EventHit> detect_events(double t_old, double t_new, const Vec<N> &y_new, std::vector<double> &g_prev)
+    template <typename RhsEval>
+    [[nodiscard]] std::optional<EventHit> detect_events(double t_old, double t_new, const Vec<N> &y_new, std::vector<double> &g_prev, RhsEval &&rhs)
     {
         if (options.events.empty())
         {
@@ -746,7 +1072,8 @@ class AdaptiveDES {
         const auto &seg = static_cast<const Derived *>(this)->last_dense_step();
         const double dir = (t_new > t_old) ? 1.0 : -1.0;
 
-        std::vector<EventHit> hits;
+        auto &hits = m_event_hits;
+        hits.clear();
 
         for (int ei = 0; ei < static_cast<int>(options.events.size()); ++ei)
         {
@@ -775,6 +1102,7 @@ class AdaptiveDES {
             if (triggered)
             {
                 ++m_stats.events_triggered;
+                static_cast<Derived *>(this)->refine_dense_step(rhs, m_stats);
 
                 // Bisect on dense polynomial to locate g = 0
                 double la = t_old, lb = t_new;
@@ -833,9 +1161,33 @@ class AdaptiveDES {
 
     template <typename System, typename Observer>
     SolveResult solve_impl(Vec<N> &y, double t0, double t1, System &sys, DelayHistoryStorage *dh, Observer &&obs)
+    {
+        try
+        {
+            const SolveResult res = integrate(y, t0, t1, sys, dh, obs);
+            finish_output();
+            return res;
+        }
+        catch (...)
+        {
+            abort_output();
+            throw;
+        }
+    }
+
+    template <typename System, typename Observer>
+    SolveResult integrate(Vec<N> &y, double t0, double t1, System &sys, DelayHistoryStorage *dh, Observer &obs)
     {
         validate_options();
-        reset_workspace();
+        if (options.use_vector_atol && static_cast<Eigen::Index>(options.atol_vec.size()) != y.size())
+        {
+            throw std::invalid_argument("DES: atol_vec size must match the state dimension");
+        }
+        if (dh && static_cast<Eigen::Index>(dh->size()) > y.size())
+        {
+            throw std::invalid_argument("DES: delay history has more variables than the state");
+        }
+        reset_workspace(y.size());
         reset_output_storage();
         m_stats = {};
 
@@ -959,34 +1311,79 @@ class AdaptiveDES {
                     return make_result(SolveStatus::NonFiniteRhs, t, h, std::numeric_limits<double>::infinity());
                 }
 
-                if (dh && !dde_seeded)
-                {
-                    dh->set_initial_derivatives(to_std_vector(m_ws.k[0]));
-                    dde_seeded = true;
-                }
                 have_rhs = true;
             }
 
+            // choose_initial_step() may already have filled k[0] = f(t0, y0)
+            if (dh && !dde_seeded)
+            {
+                dh->set_initial_derivatives(m_ws.k[0].data());
+                dde_seeded = true;
+            }
+
             // Lambda wraps call_rhs so max_query_time = t (step start)
             auto rhs = [&](double ts, const Vec<N> &ys, Vec<N> &out) { call_rhs(ts, ys, sys, out, dh, t); };
 
             static_cast<Derived *>(this)->compute_step(t, y, h, rhs, m_ws, m_stats);
             ++m_stats.steps;
 
+            // ── Failed step: reject and shrink h without an error norm ───
+            if constexpr (HasStepFailure<Derived>::value)
+            {
+                const double shrink = static_cast<const Derived *>(this)->step_failure();
+                if (shrink > 0.0)
+                {
+                    ++m_stats.rejects;
+                    ctrl.previous_rejected = true;
+                    fsal_valid = false;
+                    have_rhs = false;
+
+                    const double floor = options.h_min * (1.0 + 16.0 * std::numeric_limits<double>::epsilon());
+                    if (h_abs <= floor)
+                    {
+                        return make_result(SolveStatus::StepSizeUnderflow, t, h, std::numeric_limits<double>::infinity());
+                    }
+                    h_abs = std::max(shrink * h_abs, options.h_min);
+                    continue;
+                }
+            }
+
             if (!is_finite(m_ws.next))
             {
                 return make_result(SolveStatus::NonFiniteState, t, h, std::numeric_limits<double>::infinity());
             }
 
-            err_norm = scaled_error(y, m_ws.next, m_ws.error);
+            if constexpr (HasStepErrorNorm<Derived>::value)
+            {
+                err_norm = static_cast<const Derived *>(this)->step_error_norm();
+            }
+            else
+            {
+                err_norm = scaled_error(y, m_ws.next, m_ws.error);
+            }
             if (!std::isfinite(err_norm))
             {
                 return make_result(SolveStatus::NonFiniteError, t, h, err_norm);
             }
 
             const bool accepted = (err_norm <= 1.0);
-            const double factor = options.controller.propose(err_norm, h_abs, adaptive_order(), ctrl, accepted);
-            double next_h = std::clamp(h_abs * factor, options.h_min, options.h_max);
+            double next_h = 0.0;
+            if constexpr (HasNextStepSize<Derived>::value)
+            {
+                next_h = static_cast<Derived *>(this)->next_step_size(err_norm, accepted, h_abs);
+            }
+            else
+            {
+                next_h = h_abs * options.controller.propose(err_norm, h_abs, static_cast<const Derived *>(this)->controller_order(), ctrl, accepted);
+            }
+            next_h = std::clamp(next_h, options.h_min, options.h_max);
+            if constexpr (HasHoldStepSize<Derived>::value)
+            {
+                if (accepted)
+                {
+                    next_h = static_cast<const Derived *>(this)->hold_step_size(next_h, h_abs);
+                }
+            }
             if (dh && std::isfinite(md))
             {
                 next_h = std::min(next_h, md);
@@ -1031,23 +1428,23 @@ class AdaptiveDES {
             // ── Save endpoint to DDE history ──────────────────────────────
             if (dh)
             {
-                Vec<N> ep_rhs;
-                if (has_fsal())
-                {
-                    ep_rhs = m_ws.fsal;
-                }
-                else
+                // m_ws.stage is free between steps; reuse it for f(t, y_new)
+                if (!has_fsal())
                 {
-                    call_rhs(t, y, sys, ep_rhs, dh, t);
+                    call_rhs(t, y, sys, m_ws.stage, dh, t);
                     ++m_stats.rhs_evals;
                 }
-                dh->save(t, to_std_vector(y), to_std_vector(ep_rhs));
+                const Vec<N> &ep_rhs = has_fsal() ? m_ws.endpoint_rhs() : m_ws.stage;
+                dh->save(t, y.data(), ep_rhs.data());
             }
 
             // ── FSAL: recycle k[last] as k[0] of next step ────────────────
             if (has_fsal())
             {
-                m_ws.k[0] = m_ws.fsal;
+                if (&m_ws.endpoint_rhs() != &m_ws.k[0])
+                {
+                    m_ws.k[0] = m_ws.endpoint_rhs();
+                }
                 fsal_valid = true;
                 have_rhs = true;
             }
@@ -1079,6 +1476,7 @@ class AdaptiveDES {
                 {
                     fsal_valid = false;
                     have_rhs = false;
+                    static_cast<Derived *>(this)->after_breaking_point(t);
                 }
             }
 
@@ -1095,12 +1493,15 @@ class AdaptiveDES {
             // ── after_step hook (DoPri54 commits dense segment here) ──────
             static_cast<Derived *>(this)->after_step(t);
 
+            // Dense queries on this step see the RHS as its stages did
+            auto dense_rhs = [&](double ts, const Vec<N> &ys, Vec<N> &out) { call_rhs(ts, ys, sys, out, dh, t_old); };
+
             // ── Event detection ───────────────────────────────────────────
             if (!options.events.empty())
             {
                 if constexpr (HasLastDenseStep<Derived>::value)
                 {
-                    if (auto ev = detect_events(t_old, t, y, g_prev))
+                    if (auto ev = detect_events(t_old, t, y, g_prev, dense_rhs))
                     {
                         const auto [t_ev, y_ev, ei] = *ev;
 
@@ -1124,7 +1525,7 @@ class AdaptiveDES {
             // ── Output recording ──────────────────────────────────────────
             if (uniform)
             {
-                flush_uniform(obs, t1, t0, next_out, out_dt, out_idx, h, err_norm);
+                flush_uniform(obs, t1, t0, next_out, out_dt, out_idx, h, err_norm, dense_rhs);
             }
             else
             {
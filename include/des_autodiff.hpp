@@ -0,0 +1,448 @@
+#pragma once
+
+/*  des_autodiff.hpp  –  DES namespace
+ *
+ *  Forward-mode automatic differentiation for exact Jacobians.
+ *
+ *  Dual<W> carries a value and W tangent components.  Evaluating f on
+ *  y + Σ_k ε_k e_{j_k} propagates ∂f/∂y_{j_k} exactly (to rounding) through
+ *  every arithmetic operation and elementary function, so one pass over a
+ *  Dual<W> state yields W columns of J.  The tangents are a fixed-size
+ *  Eigen::Array, so each operation is a few packet instructions.
+ *
+ *  A system opts in by writing its RHS as a template over the state type:
+ *
+ *      template <typename Vector>
+ *      void operator()(double t, const Vector &y, Vector &dydt) const
+ *      {
+ *          using std::exp;           // unqualified calls find DES::exp for Dual
+ *          dydt[0] = -k * exp(y[0]) * y[1];
+ *          ...
+ *      }
+ *
+ *  (Eigen::Matrix<T, N, 1> with a template T works too.)  Scalar locals
+ *  should be `typename Vector::Scalar` or `auto`, and branches can compare a
+ *  Dual with a double directly or go through DES::value().
+ *
+ *  Classes:
+ *    DES::Dual<W>              – value + W tangents, arithmetic and <cmath>
+ *    DES::HasDualRhs<S, N>     – detects an RHS callable with Dual states
+ *    DES::DualJacobian<N>      – J = ∂f/∂y in ⌈N / width⌉ Dual passes
+ *
+ *  Requires C++17.
+ */
+
+#include "DES.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+namespace DES {
+
+// ---------------------------------------------------------------------------
+// Dual<W>
+// ---------------------------------------------------------------------------
+
+template <int W>
+struct Dual {
+    static_assert(W > 0, "DES: Dual needs at least one tangent component");
+
+    using Tangent = Eigen::Array<double, W, 1>;
+
+    double val = 0.0;
+    Tangent eps = Tangent::Zero();
+
+    Dual() = default;
+    Dual(double v) : val(v) {}  // implicit, so literals mix with Dual
+    Dual(double v, const Tangent &t) : val(v), eps(t) {}
+
+    // ── Arithmetic ───────────────────────────────────────────────────────────
+
+    friend Dual operator+(const Dual &a)
+    {
+        return a;
+    }
+    friend Dual operator-(const Dual &a)
+    {
+        return Dual(-a.val, -a.eps);
+    }
+
+    Dual &operator+=(const Dual &b)
+    {
+        val += b.val;
+        eps += b.eps;
+        return *this;
+    }
+    Dual &operator-=(const Dual &b)
+    {
+        val -= b.val;
+        eps -= b.eps;
+        return *this;
+    }
+    Dual &operator*=(const Dual &b)
+    {
+        eps = eps * b.val + val * b.eps;
+        val *= b.val;
+        return *this;
+    }
+    Dual &operator/=(const Dual &b)
+    {
+        const double inv = 1.0 / b.val;
+        val *= inv;
+        eps = (eps - val * b.eps) * inv;
+        return *this;
+    }
+
+    Dual &operator+=(double b)
+    {
+        val += b;
+        return *this;
+    }
+    Dual &operator-=(double b)
+    {
+        val -= b;
+        return *this;
+    }
+    Dual &operator*=(double b)
+    {
+        val *= b;
+        eps *= b;
+        return *this;
+    }
+    Dual &operator/=(double b)
+    {
+        return *this *= (1.0 / b);
+    }
+
+    friend Dual operator+(Dual a, const Dual &b)
+    {
+        return a += b;
+    }
+    friend Dual operator-(Dual a, const Dual &b)
+    {
+        return a -= b;
+    }
+    friend Dual operator*(Dual a, const Dual &b)
+    {
+        return a *= b;
+    }
+    friend Dual operator/(Dual a, const Dual &b)
+    {
+        return a /= b;
+    }
+
+    friend Dual operator+(Dual a, double b)
+    {
+        return a += b;
+    }
+    friend Dual operator+(double a, Dual b)
+    {
+        return b += a;
+    }
+    friend Dual operator-(Dual a, double b)
+    {
+        return a -= b;
+    }
+    friend Dual operator-(double a, const Dual &b)
+    {
+        return Dual(a - b.val, -b.eps);
+    }
+    friend Dual operator*(Dual a, double b)
+    {
+        return a *= b;
+    }
+    friend Dual operator*(double a, Dual b)
+    {
+        return b *= a;
+    }
+    friend Dual operator/(Dual a, double b)
+    {
+        return a /= b;
+    }
+    friend Dual operator/(double a, const Dual &b)
+    {
+        // d(a/b) = −a/b² db
+        const double inv = 1.0 / b.val;
+        return Dual::chain(b, a * inv, -a * inv * inv);
+    }
+
+    // ── Comparisons (on the value) ──────────────────────────────────────────
+
+    friend bool operator==(const Dual &a, const Dual &b)
+    {
+        return a.val == b.val;
+    }
+    friend bool operator!=(const Dual &a, const Dual &b)
+    {
+        return a.val != b.val;
+    }
+    friend bool operator<(const Dual &a, const Dual &b)
+    {
+        return a.val < b.val;
+    }
+    friend bool operator>(const Dual &a, const Dual &b)
+    {
+        return a.val > b.val;
+    }
+    friend bool operator<=(const Dual &a, const Dual &b)
+    {
+        return a.val <= b.val;
+    }
+    friend bool operator>=(const Dual &a, const Dual &b)
+    {
+        return a.val >= b.val;
+    }
+
+    // f(x) with f'(x) = df: value f, tangents df · x.eps
+    static Dual chain(const Dual &x, double f, double df)
+    {
+        return Dual(f, df * x.eps);
+    }
+};
+
+// ── Value access for branching in scalar-generic code ───────────────────────
+
+inline double value(double x)
+{
+    return x;
+}
+template <int W>
+double value(const Dual<W> &x)
+{
+    return x.val;
+}
+
+// ── Elementary functions (found by ADL on unqualified calls) ─────────────────
+
+template <int W>
+Dual<W> abs(const Dual<W> &x)
+{
+    return x.val < 0.0 ? -x : x;
+}
+template <int W>
+Dual<W> fabs(const Dual<W> &x)
+{
+    return abs(x);
+}
+template <int W>
+Dual<W> sqrt(const Dual<W> &x)
+{
+    const double s = std::sqrt(x.val);
+    return Dual<W>::chain(x, s, 0.5 / s);
+}
+template <int W>
+Dual<W> cbrt(const Dual<W> &x)
+{
+    const double c = std::cbrt(x.val);
+    return Dual<W>::chain(x, c, 1.0 / (3.0 * c * c));
+}
+template <int W>
+Dual<W> exp(const Dual<W> &x)
+{
+    const double e = std::exp(x.val);
+    return Dual<W>::chain(x, e, e);
+}
+template <int W>
+Dual<W> log(const Dual<W> &x)
+{
+    return Dual<W>::chain(x, std::log(x.val), 1.0 / x.val);
+}
+template <int W>
+Dual<W> pow(const Dual<W> &x, double p)
+{
+    const double xp = std::pow(x.val, p);
+    return Dual<W>::chain(x, xp, p == 0.0 ? 0.0 : p * std::pow(x.val, p - 1.0));
+}
+template <int W>
+Dual<W> pow(double a, const Dual<W> &p)
+{
+    const double ap = std::pow(a, p.val);
+    return Dual<W>::chain(p, ap, ap * std::log(a));
+}
+template <int W>
+Dual<W> pow(const Dual<W> &x, const Dual<W> &p)
+{
+    return exp(p * log(x));
+}
+template <int W>
+Dual<W> sin(const Dual<W> &x)
+{
+    return Dual<W>::chain(x, std::sin(x.val), std::cos(x.val));
+}
+template <int W>
+Dual<W> cos(const Dual<W> &x)
+{
+    return Dual<W>::chain(x, std::cos(x.val), -std::sin(x.val));
+}
+template <int W>
+Dual<W> tan(const Dual<W> &x)
+{
+    const double t = std::tan(x.val);
+    return Dual<W>::chain(x, t, 1.0 + t * t);
+}
+template <int W>
+Dual<W> asin(const Dual<W> &x)
+{
+    return Dual<W>::chain(x, std::asin(x.val), 1.0 / std::sqrt(1.0 - x.val * x.val));
+}
+template <int W>
+Dual<W> acos(const Dual<W> &x)
+{
+    return Dual<W>::chain(x, std::acos(x.val), -1.0 / std::sqrt(1.0 - x.val * x.val));
+}
+template <int W>
+Dual<W> atan(const Dual<W> &x)
+{
+    return Dual<W>::chain(x, std::atan(x.val), 1.0 / (1.0 + x.val * x.val));
+}
+template <int W>
+Dual<W> sinh(const Dual<W> &x)
+{
+    return Dual<W>::chain(x, std::sinh(x.val), std::cosh(x.val));
+}
+template <int W>
+Dual<W> cosh(const Dual<W> &x)
+{
+    return Dual<W>::chain(x, std::cosh(x.val), std::sinh(x.val));
+}
+template <int W>
+Dual<W> tanh(const Dual<W> &x)
+{
+    const double th = std::tanh(x.val);
+    return Dual<W>::chain(x, th, 1.0 - th * th);
+}
+
+// ---------------------------------------------------------------------------
+// dual_width<N> — tangent components per pass
+//
+// Small fixed-size systems take every column in a single pass; larger or
+// dynamic ones run ⌈N / dual_chunk⌉ passes of dual_chunk columns, which
+// keeps Dual at a few cache lines.
+// ---------------------------------------------------------------------------
+
+inline constexpr int dual_chunk = 8;
+inline constexpr int dual_max_width = 16;
+
+template <int N>
+inline constexpr int dual_width = (N != Eigen::Dynamic && N <= dual_max_width) ? N : dual_chunk;
+
+template <int N>
+using DualVec = Eigen::Matrix<Dual<dual_width<N>>, N, 1>;
+
+// ---------------------------------------------------------------------------
+// HasDualRhs<System, N>
+//
+// True when System can be called as
+//   sys(double t, const DualVec<N>& y, DualVec<N>& dydt)
+// i.e. its RHS is a template over the state (or scalar) type.
+// ---------------------------------------------------------------------------
+
+template <typename System, int N, typename = void>
+struct HasDualRhs : std::false_type {};
+
+template <typename System, int N>
+struct HasDualRhs<System, N, std::void_t<decltype(std::declval<System &>()(std::declval<double>(), std::declval<const DualVec<N> &>(), std::declval<DualVec<N> &>()))>> : std::true_type {};
+
+// ---------------------------------------------------------------------------
+// DualJacobian<N>
+//
+// Seeds width() columns of the identity into the tangents of a Dual copy of
+// y, evaluates the RHS once, and reads the columns back from the tangents
+// of dydt.  resize() is the only call that allocates (and only for
+// N = Eigen::Dynamic).
+// ---------------------------------------------------------------------------
+
+template <int N>
+class DualJacobian {
+  public:
+    static constexpr int W = dual_width<N>;
+    using Scalar = Dual<W>;
+
+    void resize(Eigen::Index n)
+    {
+        m_y.resize(n);
+        m_f.resize(n);
+    }
+
+    [[nodiscard]] static constexpr int width() noexcept
+    {
+        return W;
+    }
+    [[nodiscard]] static Eigen::Index passes(Eigen::Index n) noexcept
+    {
+        return (n + W - 1) / W;
+    }
+
+    template <typename System>
+    void operator()(System &sys, double t, const Vec<N> &y, Eigen::Matrix<double, N, N> &J)
+    {
+        const Eigen::Index n = y.size();
+        for (Eigen::Index i = 0; i < n; ++i)
+        {
+            m_y[i] = Scalar(y[i]);
+        }
+
+        for (Eigen::Index j0 = 0; j0 < n; j0 += W)
+        {
+            const int cols = static_cast<int>(std::min<Eigen::Index>(W, n - j0));
+            for (int k = 0; k < cols; ++k)
+            {
+                m_y[j0 + k].eps[k] = 1.0;
+            }
+
+            sys(t, static_cast<const DualVec<N> &>(m_y), m_f);
+
+            for (int k = 0; k < cols; ++k)
+            {
+                for (Eigen::Index i = 0; i < n; ++i)
+                {
+                    J(i, j0 + k) = m_f[i].eps[k];
+                }
+                m_y[j0 + k].eps[k] = 0.0;
+            }
+        }
+    }
+
+  private:
+    DualVec<N> m_y{};
+    DualVec<N> m_f{};
+};
+
+}  // namespace DES
+
+// ---------------------------------------------------------------------------
+// Eigen integration: Dual<W> as a real scalar, mixing with double
+// ---------------------------------------------------------------------------
+
+namespace Eigen {
+
+template <int W>
+struct NumTraits<DES::Dual<W>> : NumTraits<double> {
+    using Real = DES::Dual<W>;
+    using NonInteger = DES::Dual<W>;
+    using Nested = DES::Dual<W>;
+    using Literal = DES::Dual<W>;
+    enum {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        RequireInitialization = 1,
+        ReadCost = W + 1,
+        AddCost = W + 1,
+        MulCost = 2 * W + 1
+    };
+};
+
+template <int W, typename BinaryOp>
+struct ScalarBinaryOpTraits<DES::Dual<W>, double, BinaryOp> {
+    using ReturnType = DES::Dual<W>;
+};
+
+template <int W, typename BinaryOp>
+struct ScalarBinaryOpTraits<double, DES::Dual<W>, BinaryOp> {
+    using ReturnType = DES::Dual<W>;
+};
+
+}  // namespace Eigen
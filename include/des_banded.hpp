@@ -0,0 +1,223 @@
+#pragma once
+
+/*  des_banded.hpp  –  DES namespace
+ *
+ *  Banded Jacobians for implicit solvers.
+ *
+ *  A system with ∂f_i/∂y_j = 0 for j < i − lower and j > i + upper (method
+ *  of lines in 1-D, chains, tridiagonal couplings) declares
+ *
+ *      DES::Bandwidth jacobian_bandwidth() const { return {lower, upper}; }
+ *
+ *  A finite-difference Jacobian then needs lower + upper + 1 RHS calls:
+ *  columns j ≡ g (mod lower + upper + 1) touch disjoint rows and are
+ *  perturbed together.  BandedLU factors and solves the iteration matrix in
+ *  O(N·lower·(lower + upper)) / O(N·(2·lower + upper)) instead of O(N³) / O(N²).
+ *
+ *  Classes:
+ *    DES::Bandwidth                 – lower / upper bandwidth
+ *    DES::HasJacobianBandwidth<S>   – detects .jacobian_bandwidth()
+ *    DES::BandedLU                  – LU with partial pivoting in band storage
+ *
+ *  Requires C++17.
+ */
+
+#include "DES.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace DES {
+
+// ---------------------------------------------------------------------------
+// Bandwidth / HasJacobianBandwidth<System>
+//
+// True when System has a member:
+//   DES::Bandwidth jacobian_bandwidth()
+// ---------------------------------------------------------------------------
+
+struct Bandwidth {
+    int lower = 0;
+    int upper = 0;
+};
+
+template <typename System, typename = void>
+struct HasJacobianBandwidth : std::false_type {};
+
+template <typename System>
+struct HasJacobianBandwidth<System, std::void_t<decltype(Bandwidth{std::declval<System &>().jacobian_bandwidth()})>> : std::true_type {};
+
+// ---------------------------------------------------------------------------
+// BandedLU — Gaussian elimination with partial pivoting on a band matrix
+//
+// Storage follows LAPACK's ?gbtrf: an (2·kl + ku + 1) × n column-major
+// array with A(i, j) at row kl + ku + i − j of column j.  The top kl rows
+// receive the fill-in that row interchanges push above the original upper
+// band.  resize() is the only call that allocates; clear()/at()/
+// factorize()/solve() work in place.
+//
+// Usage:  resize(n, kl, ku) → clear() → at(i, j) = v… → factorize() → solve(b)
+// ---------------------------------------------------------------------------
+
+class BandedLU {
+  public:
+    void resize(Eigen::Index n, int kl, int ku)
+    {
+        if (kl < 0 || ku < 0)
+        {
+            throw std::invalid_argument("DES: BandedLU bandwidths must be non-negative");
+        }
+        m_n = n;
+        m_kl = kl;
+        m_ku = ku;
+        m_ld = 2 * kl + ku + 1;
+        m_ab.assign(static_cast<std::size_t>(m_ld) * static_cast<std::size_t>(n), 0.0);
+        m_piv.assign(static_cast<std::size_t>(n), 0);
+        m_ok = false;
+    }
+
+    void clear() noexcept
+    {
+        std::fill(m_ab.begin(), m_ab.end(), 0.0);
+        m_ok = false;
+    }
+
+    // A(i, j) for |i − j| inside the band (unchecked)
+    double &at(Eigen::Index i, Eigen::Index j) noexcept
+    {
+        return m_ab[static_cast<std::size_t>((m_kl + m_ku + i - j) + j * m_ld)];
+    }
+
+    // In-place factorization; false if a zero pivot makes A singular
+    bool factorize() noexcept
+    {
+        const Eigen::Index kv = m_kl + m_ku;
+        const Eigen::Index ld = m_ld;
+        double *ab = m_ab.data();
+        Eigen::Index ju = 0;
+
+        for (Eigen::Index j = 0; j < m_n; ++j)
+        {
+            double *col = ab + kv + j * ld;  // A(j, j)
+            const Eigen::Index km = std::min<Eigen::Index>(m_kl, m_n - 1 - j);
+
+            Eigen::Index jp = 0;
+            double amax = std::abs(col[0]);
+            for (Eigen::Index i = 1; i <= km; ++i)
+            {
+                if (std::abs(col[i]) > amax)
+                {
+                    amax = std::abs(col[i]);
+                    jp = i;
+                }
+            }
+            m_piv[static_cast<std::size_t>(j)] = static_cast<int>(j + jp);
+            if (amax == 0.0)
+            {
+                m_ok = false;
+                return false;
+            }
+
+            ju = std::max(ju, std::min<Eigen::Index>(j + m_ku + jp, m_n - 1));
+
+            // Walking along a row of A moves by ld − 1 in band storage
+            if (jp != 0)
+            {
+                for (Eigen::Index c = 0; c <= ju - j; ++c)
+                {
+                    std::swap(col[jp + c * (ld - 1)], col[c * (ld - 1)]);
+                }
+            }
+
+            if (km > 0)
+            {
+                const double inv = 1.0 / col[0];
+                for (Eigen::Index i = 1; i <= km; ++i)
+                {
+                    col[i] *= inv;
+                }
+                for (Eigen::Index c = 1; c <= ju - j; ++c)
+                {
+                    double *cc = col + c * (ld - 1);  // A(j, j + c)
+                    const double u = cc[0];
+                    if (u != 0.0)
+                    {
+                        for (Eigen::Index i = 1; i <= km; ++i)
+                        {
+                            cc[i] -= col[i] * u;
+                        }
+                    }
+                }
+            }
+        }
+        m_ok = true;
+        return true;
+    }
+
+    // Solve A x = b in place (b ← x) after a successful factorize()
+    template <typename Vector>
+    void solve(Vector &b) const noexcept
+    {
+        const Eigen::Index kv = m_kl + m_ku;
+        const Eigen::Index ld = m_ld;
+        const double *ab = m_ab.data();
+
+        // L: apply the row interchanges and unit-lower multipliers
+        for (Eigen::Index j = 0; j + 1 < m_n; ++j)
+        {
+            const Eigen::Index jp = m_piv[static_cast<std::size_t>(j)];
+            if (jp != j)
+            {
+                std::swap(b[j], b[jp]);
+            }
+            const Eigen::Index lm = std::min<Eigen::Index>(m_kl, m_n - 1 - j);
+            const double *col = ab + kv + j * ld;
+            const double bj = b[j];
+            for (Eigen::Index i = 1; i <= lm; ++i)
+            {
+                b[j + i] -= col[i] * bj;
+            }
+        }
+
+        // U: upper bandwidth kl + ku after pivoting
+        for (Eigen::Index j = m_n; j-- > 0;)
+        {
+            const double *col = ab + kv + j * ld;
+            b[j] /= col[0];
+            const Eigen::Index um = std::min<Eigen::Index>(kv, j);
+            const double bj = b[j];
+            for (Eigen::Index i = 1; i <= um; ++i)
+            {
+                b[j - i] -= col[-i] * bj;
+            }
+        }
+    }
+
+    [[nodiscard]] bool ok() const noexcept
+    {
+        return m_ok;
+    }
+    [[nodiscard]] int lower() const noexcept
+    {
+        return m_kl;
+    }
+    [[nodiscard]] int upper() const noexcept
+    {
+        return m_ku;
+    }
+
+  private:
+    Eigen::Index m_n = 0;
+    int m_kl = 0;
+    int m_ku = 0;
+    Eigen::Index m_ld = 1;
+    std::vector<double> m_ab{};
+    std::vector<int> m_piv{};
+    bool m_ok = false;
+};
+
+}  // namespace DES
@@ -0,0 +1,469 @@
+#pragma once
+
+/*  des_batch.hpp  –  DES namespace
+ *
+ *  Lockstep ensemble integration: many independent trajectories of the same
+ *  system advanced together, one SIMD lane per trajectory.
+ *
+ *  BatchState<N, Lanes> — Lanes × N array, column-major.  Column i holds
+ *                         component i of every lane contiguously (SoA), so
+ *                         every stage sum is a straight vector loop.
+ *  BatchDoPri54<N, Lanes> — Dormand–Prince 5(4) over BatchState.
+ *  propose_lanes()       — StepController::propose evaluated across lanes.
+ *
+ *  Every lane keeps its own time, step size, controller state and status.
+ *  A lane that rejects its trial step keeps (t, y, f(t,y)) unchanged while
+ *  the accepted lanes move on; a lane that has reached t1 (or failed) is
+ *  masked by running it with h = 0, which leaves its state bit-identical.
+ *
+ *  The system is called once per stage for all lanes:
+ *
+ *      void operator()(const LaneArray<Lanes> &t,
+ *                      const BatchState<N, Lanes> &y,
+ *                      BatchState<N, Lanes> &dydt) const;
+ *
+ *  Per-lane parameters (parameter sweeps) live in the system itself as
+ *  LaneArray members, so the RHS stays a pure array expression; its exp,
+ *  log and pow can go through des_vmath.hpp.
+ *
+ *  C++17.  Requires DES.hpp (Eigen).
+ */
+
+#include "DES.hpp"
+#include "des_vmath.hpp"
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace DES {
+
+// ---------------------------------------------------------------------------
+// Lane types
+// ---------------------------------------------------------------------------
+
+template <int Lanes>
+using LaneArray = Eigen::Array<double, Lanes, 1>;
+
+template <int Lanes>
+using LaneMask = Eigen::Array<bool, Lanes, 1>;
+
+// Column i = component i across all lanes (structure of arrays)
+template <int N, int Lanes>
+using BatchState = Eigen::Array<double, Lanes, N, (Lanes == 1 && N != 1) ? Eigen::RowMajor : Eigen::ColMajor>;
+
+// ---------------------------------------------------------------------------
+// LaneControllerState — ControllerState with one entry per lane
+// ---------------------------------------------------------------------------
+
+template <int Lanes>
+struct LaneControllerState {
+    LaneArray<Lanes> prev_error = LaneArray<Lanes>::Ones();
+    LaneArray<Lanes> accepted_error = LaneArray<Lanes>::Ones();
+    LaneArray<Lanes> accepted_h = LaneArray<Lanes>::Zero();
+    LaneMask<Lanes> has_prev_error = LaneMask<Lanes>::Constant(false);
+    LaneMask<Lanes> has_accepted_reference = LaneMask<Lanes>::Constant(false);
+    LaneMask<Lanes> previous_rejected = LaneMask<Lanes>::Constant(false);
+};
+
+// ---------------------------------------------------------------------------
+// propose_lanes
+//
+// Branch-free transcription of StepController::propose: every branch is
+// evaluated for all lanes and merged with select(), so the whole controller
+// runs as a handful of packet operations; the powers go through vmath.
+// Lane-for-lane identical to calling propose() once per lane, up to the
+// last-ulp rounding of Eigen's packet pow against std::pow.
+// ---------------------------------------------------------------------------
+
+template <int Lanes>
+[[nodiscard]] LaneArray<Lanes> propose_lanes(const StepController &ctl, const LaneArray<Lanes> &error_norm, const LaneArray<Lanes> &h_abs, int adaptive_order, const LaneControllerState<Lanes> &state, const LaneMask<Lanes> &accepted)
+{
+    using Arr = LaneArray<Lanes>;
+
+    if (adaptive_order < 0)
+    {
+        return Arr::Constant(ctl.min_factor);
+    }
+
+    const double inv_q = 1.0 / static_cast<double>(adaptive_order + 1);
+    Arr factor = ctl.safety * vmath::pow(error_norm, -inv_q);
+
+    if (ctl.kind == ControllerKind::PI)
+    {
+        const double a = (ctl.alpha >= 0.0) ? ctl.alpha : 0.7 * inv_q;
+        const double b = (ctl.beta >= 0.0) ? ctl.beta : 0.4 * inv_q;
+        const Arr pi = ctl.safety * vmath::pow(error_norm, -a) * vmath::pow(state.prev_error.max(1.0e-16), b);
+        factor = state.has_prev_error.select(pi, factor);
+    }
+    else if (ctl.kind == ControllerKind::Gustafsson)
+    {
+        const LaneMask<Lanes> use = accepted && !state.previous_rejected && state.has_accepted_reference && (state.accepted_h > 0.0);
+        const Arr ratio = (use).select(h_abs / state.accepted_h, Arr::Ones());
+        const Arr gust = ctl.safety * ratio * vmath::pow(state.accepted_error.max(1.0e-16) / (error_norm * error_norm).max(1.0e-32), inv_q);
+        factor = use.select(factor.min(gust), factor);
+    }
+
+    factor = (!accepted || state.previous_rejected).select(factor.min(1.0), factor);
+    factor = factor.max(ctl.min_factor).min(ctl.max_factor);
+    factor = (factor >= ctl.steady_min && factor <= ctl.steady_max).select(Arr::Ones(), factor);
+
+    // Special cases last so they override everything above
+    factor = (error_norm <= 0.0).select(Arr::Constant(ctl.max_factor), factor);
+    factor = error_norm.isFinite().select(factor, Arr::Constant(ctl.min_factor));
+    return factor;
+}
+
+// ---------------------------------------------------------------------------
+// BatchDoPri54<N, Lanes>
+// ---------------------------------------------------------------------------
+
+template <int N, int Lanes>
+class BatchDoPri54 {
+  public:
+    using State = BatchState<N, Lanes>;
+    using Times = LaneArray<Lanes>;
+    using Mask = LaneMask<Lanes>;
+
+    struct Options {
+        double rtol = 1.0e-9;
+        double atol = 1.0e-9;
+
+        double h_init = 0.0;  // 0 → auto-select per lane
+        double h_min = 1.0e-12;
+        double h_max = 1.0;
+
+        long max_steps = 1'000'000;  // per lane
+
+        ErrorNorm error_norm = ErrorNorm::Rms;
+        StepController controller{};
+    };
+
+    Options options{};
+
+    BatchDoPri54()
+    {
+        options.controller.kind = ControllerKind::PI;
+        options.controller.safety = 0.9;
+        options.controller.min_factor = 0.2;
+        options.controller.max_factor = 10.0;
+    }
+
+    [[nodiscard]] static constexpr int method_order()
+    {
+        return 5;
+    }
+    [[nodiscard]] static constexpr int adaptive_order()
+    {
+        return 4;
+    }
+    [[nodiscard]] static constexpr int lanes()
+    {
+        return Lanes;
+    }
+
+    // Lockstep counters: steps = batched trial steps, rhs_evals = batched
+    // RHS calls (each one evaluates all Lanes trajectories).
+    [[nodiscard]] const SolverStats &stats() const noexcept
+    {
+        return m_stats;
+    }
+
+    // Per-lane counters: steps / accepts / rejects of that trajectory.
+    [[nodiscard]] const SolverStats &lane_stats(int lane) const
+    {
+        if (lane < 0 || lane >= Lanes)
+        {
+            throw std::out_of_range("BatchDoPri54: lane index out of range");
+        }
+        return m_lane_stats[static_cast<std::size_t>(lane)];
+    }
+
+    struct NoOpObserver {
+        void operator()(const Times &, const State &, const Mask &) const
+        {}
+    };
+
+    // Integrate every lane of y from t0 to t1.  y is overwritten with the
+    // final states; the result of lane i is element i of the returned array.
+    template <typename System>
+    std::array<SolveResult, Lanes> solve(State &y, double t0, double t1, System &sys)
+    {
+        NoOpObserver obs;
+        return solve(y, t0, t1, sys, obs);
+    }
+
+    // Observer is called after every lockstep iteration as
+    // obs(t, y, accepted) — accepted marks the lanes that advanced.
+    template <typename System, typename Observer>
+    std::array<SolveResult, Lanes> solve(State &y, double t0, double t1, System &sys, Observer &&obs)
+    {
+        static_assert(std::is_invocable_v<System &, const Times &, const State &, State &>, "Batch system must be callable as f(t_lanes, y_batch, dydt_batch)");
+
+        validate_options();
+        m_stats = {};
+        m_lane_stats.fill(SolverStats{});
+
+        std::array<SolveResult, Lanes> res{};
+        for (auto &r : res)
+        {
+            r.t_final = t0;
+        }
+        if (!y.isFinite().all())
+        {
+            for (int l = 0; l < Lanes; ++l)
+            {
+                if (!y.row(l).isFinite().all())
+                {
+                    res[static_cast<std::size_t>(l)].status = SolveStatus::NonFiniteState;
+                }
+            }
+            return res;
+        }
+
+        const double span = t1 - t0;
+        if (span == 0.0)
+        {
+            return res;
+        }
+        const double dir = (span >= 0.0) ? 1.0 : -1.0;
+
+        Times t = Times::Constant(t0);
+        Mask running = Mask::Constant(true);
+
+        auto rhs = [&](const Times &ts, const State &ys, State &out) {
+            sys(ts, ys, out);
+            ++m_stats.rhs_evals;
+        };
+
+        rhs(t, y, m_k[0]);
+        Times h_abs = (options.h_init > 0.0) ? Times::Constant(std::clamp(options.h_init, options.h_min, options.h_max)) : initial_step(t, y, t1, dir, rhs);
+
+        LaneControllerState<Lanes> ctrl{};
+        Times err_norm = Times::Zero();
+
+        while (running.any())
+        {
+            // ── Per-lane step size; finished lanes run with h = 0 ─────────
+            h_abs = h_abs.min((t1 - t).abs()).max(options.h_min).min(options.h_max);
+            const Times h = running.select(dir * h_abs, Times::Zero());
+
+            trial_step(t, y, h, rhs);
+            ++m_stats.steps;
+
+            err_norm = scaled_error(y, m_next, m_err);
+
+            // ── Non-finite lanes fail individually ────────────────────────
+            const Mask state_ok = m_next.isFinite().rowwise().all();
+            const Mask error_ok = err_norm.isFinite();
+            const Mask accepted = running && state_ok && error_ok && (err_norm <= 1.0);
+            const Mask rejected = running && state_ok && error_ok && !(err_norm <= 1.0);
+
+            const Times factor = propose_lanes(options.controller, err_norm, h_abs, adaptive_order(), ctrl, accepted);
+            const Times next_h = (h_abs * factor).max(options.h_min).min(options.h_max);
+
+            // ── Controller state (same update order as AdaptiveDES) ───────
+            const Times clipped = err_norm.max(1.0e-16);
+            ctrl.prev_error = (accepted || rejected).select(clipped, ctrl.prev_error);
+            ctrl.has_prev_error = ctrl.has_prev_error || accepted || rejected;
+            ctrl.accepted_error = accepted.select(err_norm.max(1.0e-2), ctrl.accepted_error);
+            ctrl.accepted_h = accepted.select(h_abs, ctrl.accepted_h);
+            ctrl.has_accepted_reference = ctrl.has_accepted_reference || accepted;
+            ctrl.previous_rejected = rejected || (ctrl.previous_rejected && !accepted);
+
+            // ── Commit accepted lanes; FSAL keeps k[0] valid per lane ─────
+            for (int i = 0; i < N; ++i)
+            {
+                y.col(i) = accepted.select(m_next.col(i), y.col(i));
+                m_k[0].col(i) = accepted.select(m_k[6].col(i), m_k[0].col(i));
+            }
+            t = accepted.select(t + h, t);
+
+            // ── Per-lane bookkeeping and termination ─────────────────────
+            const double floor = options.h_min * (1.0 + 16.0 * std::numeric_limits<double>::epsilon());
+            for (int l = 0; l < Lanes; ++l)
+            {
+                if (!running[l])
+                {
+                    continue;
+                }
+                auto &st = m_lane_stats[static_cast<std::size_t>(l)];
+                auto &r = res[static_cast<std::size_t>(l)];
+                ++st.steps;
+                st.rhs_evals = m_stats.rhs_evals;
+                r.last_h = h[l];
+                r.last_error_norm = err_norm[l];
+                r.t_final = t[l];
+
+                if (!state_ok[l])
+                {
+                    r.status = SolveStatus::NonFiniteState;
+                    running[l] = false;
+                }
+                else if (!error_ok[l])
+                {
+                    r.status = SolveStatus::NonFiniteError;
+                    running[l] = false;
+                }
+                else if (accepted[l])
+                {
+                    ++st.accepts;
+                    if (dir * (t1 - t[l]) <= 0.0)
+                    {
+                        running[l] = false;
+                    }
+                }
+                else
+                {
+                    ++st.rejects;
+                    if (h_abs[l] <= floor && next_h[l] <= floor)
+                    {
+                        r.status = SolveStatus::StepSizeUnderflow;
+                        running[l] = false;
+                    }
+                }
+
+                if (running[l] && st.steps >= options.max_steps)
+                {
+                    r.status = SolveStatus::MaxStepsExceeded;
+                    running[l] = false;
+                }
+            }
+            m_stats.accepts += accepted.count();
+            m_stats.rejects += rejected.count();
+
+            h_abs = next_h;
+            obs(t, y, accepted);
+        }
+
+        return res;
+    }
+
+  private:
+    // ── Butcher tableau (Dormand & Prince 1980), as in DoPri54 ─────────────
+    struct C {
+        static constexpr double c2 = 1.0 / 5.0, c3 = 3.0 / 10.0, c4 = 4.0 / 5.0, c5 = 8.0 / 9.0;
+
+        static constexpr double a21 = 1.0 / 5.0, a31 = 3.0 / 40.0, a32 = 9.0 / 40.0, a41 = 44.0 / 45.0, a42 = -56.0 / 15.0, a43 = 32.0 / 9.0, a51 = 19372.0 / 6561.0, a52 = -25360.0 / 2187.0, a53 = 64448.0 / 6561.0, a54 = -212.0 / 729.0, a61 = 9017.0 / 3168.0, a62 = -355.0 / 33.0,
+                                a63 = 46732.0 / 5247.0, a64 = 49.0 / 176.0, a65 = -5103.0 / 18656.0;
+
+        static constexpr double b1 = 35.0 / 384.0, b3 = 500.0 / 1113.0, b4 = 125.0 / 192.0, b5 = -2187.0 / 6784.0, b6 = 11.0 / 84.0;
+
+        static constexpr double e1 = -71.0 / 57600.0, e3 = 71.0 / 16695.0, e4 = -71.0 / 1920.0, e5 = 17253.0 / 339200.0, e6 = -22.0 / 525.0, e7 = 1.0 / 40.0;
+    };
+
+    std::array<State, 7> m_k{};
+    State m_stage{};
+    State m_next{};
+    State m_err{};
+    SolverStats m_stats{};
+    std::array<SolverStats, Lanes> m_lane_stats{};
+
+    void validate_options() const
+    {
+        if (!(options.rtol > 0.0) || !(options.atol > 0.0))
+        {
+            throw std::invalid_argument("DES: rtol and atol must be positive");
+        }
+        if (!(options.h_min > 0.0) || !(options.h_max >= options.h_min))
+        {
+            throw std::invalid_argument("DES: invalid step-size bounds");
+        }
+        if (!(options.max_steps > 0))
+        {
+            throw std::invalid_argument("DES: max_steps must be positive");
+        }
+        if (!(options.controller.safety > 0.0))
+        {
+            throw std::invalid_argument("DES: controller safety must be positive");
+        }
+        if (!(options.controller.min_factor > 0.0) || !(options.controller.max_factor >= options.controller.min_factor))
+        {
+            throw std::invalid_argument("DES: invalid controller factor bounds");
+        }
+    }
+
+    // ── One DoPri54 trial step for all lanes ───────────────────────────────
+    //
+    // m_k[0] = f(t, y) on entry.  Each term is kⱼ scaled per lane by
+    // (aᵢⱼ·h), summed left to right from y: the association ExplicitRK uses,
+    // so every lane rounds exactly as a scalar DoPri54 step would.
+
+    template <typename Rhs>
+    void trial_step(const Times &t, const State &y, const Times &h, Rhs &rhs)
+    {
+        const auto &k = m_k;
+
+        m_stage = y + k[0].colwise() * (C::a21 * h);
+        rhs(t + C::c2 * h, m_stage, m_k[1]);
+
+        m_stage = y + k[0].colwise() * (C::a31 * h) + k[1].colwise() * (C::a32 * h);
+        rhs(t + C::c3 * h, m_stage, m_k[2]);
+
+        m_stage = y + k[0].colwise() * (C::a41 * h) + k[1].colwise() * (C::a42 * h) + k[2].colwise() * (C::a43 * h);
+        rhs(t + C::c4 * h, m_stage, m_k[3]);
+
+        m_stage = y + k[0].colwise() * (C::a51 * h) + k[1].colwise() * (C::a52 * h) + k[2].colwise() * (C::a53 * h) + k[3].colwise() * (C::a54 * h);
+        rhs(t + C::c5 * h, m_stage, m_k[4]);
+
+        m_stage = y + k[0].colwise() * (C::a61 * h) + k[1].colwise() * (C::a62 * h) + k[2].colwise() * (C::a63 * h) + k[3].colwise() * (C::a64 * h) + k[4].colwise() * (C::a65 * h);
+        rhs(t + h, m_stage, m_k[5]);
+
+        m_next = y + k[0].colwise() * (C::b1 * h) + k[2].colwise() * (C::b3 * h) + k[3].colwise() * (C::b4 * h) + k[4].colwise() * (C::b5 * h) + k[5].colwise() * (C::b6 * h);
+        rhs(t + h, m_next, m_k[6]);
+
+        m_err = k[0].colwise() * (C::e1 * h) + k[2].colwise() * (C::e3 * h) + k[3].colwise() * (C::e4 * h) + k[4].colwise() * (C::e5 * h) + k[5].colwise() * (C::e6 * h) + k[6].colwise() * (C::e7 * h);
+    }
+
+    // ── Per-lane scaled error norm ─────────────────────────────────────────
+    // sc = atol + rtol·max(|y0|,|y1|); the row reduction yields one norm per lane.
+
+    [[nodiscard]] Times scaled_error(const State &y0, const State &y1, const State &err) const
+    {
+        const State q = err / (options.atol + options.rtol * y0.abs().max(y1.abs()));
+        if (options.error_norm == ErrorNorm::Infinity)
+        {
+            return q.abs().rowwise().maxCoeff();
+        }
+        return (q.square().rowwise().sum() / static_cast<double>(N)).sqrt();
+    }
+
+    [[nodiscard]] Times weighted_norm(const State &v, const State &ref) const
+    {
+        const State q = v / (options.atol + options.rtol * ref.abs());
+        if (options.error_norm == ErrorNorm::Infinity)
+        {
+            return q.abs().rowwise().maxCoeff();
+        }
+        return (q.square().rowwise().sum() / static_cast<double>(N)).sqrt();
+    }
+
+    // ── Automatic initial step per lane (Hairer & Wanner §II.4) ────────────
+    // m_k[0] = f(t0, y) on entry.
+
+    template <typename Rhs>
+    Times initial_step(const Times &t, const State &y, double t1, double dir, Rhs &rhs)
+    {
+        const double span = std::abs(t1 - t[0]);
+        const Times d0 = weighted_norm(y, y);
+        const Times d1 = weighted_norm(m_k[0], y);
+
+        Times h0 = (d0 >= 1.0e-5 && d1 >= 1.0e-5 && d0.isFinite() && d1.isFinite()).select(0.01 * d0 / d1, Times::Constant(1.0e-6));
+        h0 = h0.min(span).max(options.h_min).min(options.h_max);
+
+        m_stage = y + m_k[0].colwise() * (dir * h0);
+        rhs(t + dir * h0, m_stage, m_k[1]);
+
+        const Times d2 = weighted_norm(m_k[1] - m_k[0], y) / h0;
+        const Times denom = d1.max(d2);
+        const double order = static_cast<double>(adaptive_order() + 1);
+        const Times h1 = (denom.isFinite() && denom > 1.0e-15).select(vmath::pow(0.01 / denom, 1.0 / order), (h0 * 1.0e-3).max(1.0e-6));
+
+        return (100.0 * h0).min(h1).min(span).max(options.h_min).min(options.h_max);
+    }
+};
+
+}  // namespace DES
@@ -4,8 +4,12 @@
  *
  *  Shared dense-output infrastructure.
  *
- *  DenseSegment<N>    — polynomial evaluated via Horner's method
+ *  DenseSegment<N,Q>  — polynomial with Q coefficient vectors, evaluated via
+ *                       Horner's method (Q = 4 unless a solver needs more)
  *  hermite_segment<N> — Hermite-cubic segment from endpoint (y,f) pairs
+ *  build_hermite<N>   — same, written into an existing segment (no allocation
+ *                       once the segment is sized, also for Eigen::Dynamic)
+ *  DenseHistory<N,Q>  — retained segments of a solve, with a retention window
  *
  *  All DES solvers that expose last_dense_step() include this header.
  *  C++17.  Requires DES.hpp (Eigen).
@@ -15,32 +19,62 @@
 
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <limits>
 #include <stdexcept>
+#include <vector>
 
 namespace DES {
 
 // ---------------------------------------------------------------------------
-// DenseSegment<N>
+// DenseSegment<N, Q>
 //
 // Stores one accepted step's dense-output polynomial in Horner form:
 //
-//   y(t₀ + θ·h) = y₀ + h·θ·(q[0] + θ·(q[1] + θ·(q[2] + θ·q[3])))
+//   y(t₀ + θ·h) = y₀ + h·θ·(q[0] + θ·(q[1] + … + θ·q[Q−1]))
 //   θ ∈ [0, 1]
 //
-// Coefficient vectors q[0..3] are solver-specific:
-//   DoPri54   – 4th-order continuous extension (7 stage evals)
-//   DoPri87   – Hermite cubic, O(h⁴)
-//   Rosenbrock4 – Hermite cubic, O(h⁴)
+// Coefficient vectors q[0..Q−1] are solver-specific:
+//   DoPri54, Tsit5 – 4th-order continuous extension (7 stage evals)
+//   DoPri87   – Hermite cubic, O(h⁴) (Q = 3), or with DenseMode::HighOrder
+//               the 7th-order continuous extension, O(h⁸) (Q = 7)
+//   Vern9     – 9th-order continuous extension, O(h¹⁰) (Q = 9), or with
+//               DenseMode::Standard the Hermite cubic (Q = 3)
+//   Rosenbrock4 – 3rd-order extension from the stage increments, O(h⁴),
+//               bounded on stiff components
+//   Radau5      – the collocation cubic through the three stages
+//   BDF         – the Nordsieck interpolating polynomial of the current
+//               order k, shifted to the step start (Q = 5)
+//   LowStorageRK – Hermite cubic from the FSAL endpoint derivatives (Q = 3)
+//
+// `order` is the order of the continuous extension (local error
+// O(h^(order+1))), so callers can tell a refined segment from a cubic one.
 // ---------------------------------------------------------------------------
 
-template <int N>
+template <int N, std::size_t Q = 4>
 struct DenseSegment {
+    static_assert(Q >= 3, "DenseSegment: need room for at least a cubic");
+
     double t0 = 0.0;
     double h = 0.0;
     bool valid = false;
+    int order = 0;
     Vec<N> y0{};
-    std::array<Vec<N>, 4> q{};
+    std::array<Vec<N>, Q> q{};
+
+    // Invalidate and size the coefficient vectors for an n-dimensional state
+    void reset(Eigen::Index n)
+    {
+        t0 = 0.0;
+        h = 0.0;
+        valid = false;
+        order = 0;
+        y0.resize(n);
+        for (auto &c : q)
+        {
+            c.resize(n);
+        }
+    }
 
     // True iff t ∈ [t0, t0+h] in the direction of h, with ε tolerance
     [[nodiscard]] bool contains(double t) const noexcept
@@ -54,7 +88,7 @@ struct DenseSegment {
         return (h >= 0.0) ? (t >= t0 - eps && t <= t1 + eps) : (t <= t0 + eps && t >= t1 - eps);
     }
 
-    // Evaluate at θ ∈ [0,1]: 8 multiplications via Horner's method
+    // Evaluate at θ ∈ [0,1]: 2Q multiplications via Horner's method
     [[nodiscard]] Vec<N> eval_theta(double theta) const
     {
         if (!valid)
@@ -62,7 +96,12 @@ struct DenseSegment {
             throw std::logic_error("DenseSegment: dense output not available");
         }
         theta = std::clamp(theta, 0.0, 1.0);
-        return y0 + (h * theta) * (q[0] + theta * (q[1] + theta * (q[2] + theta * q[3])));
+        Vec<N> acc = q[Q - 1];
+        for (std::size_t c = Q - 1; c-- > 0;)
+        {
+            acc = q[c] + theta * acc;
+        }
+        return y0 + (h * theta) * acc;
     }
 
     // Evaluate at absolute time t ∈ [t0, t0+h]
@@ -74,6 +113,17 @@ struct DenseSegment {
         }
         return eval_theta((t - t0) / h);
     }
+
+    // Bytes held, including the heap storage of Eigen::Dynamic vectors
+    [[nodiscard]] std::size_t memory_bytes() const noexcept
+    {
+        std::size_t bytes = sizeof(*this);
+        if constexpr (N == Eigen::Dynamic)
+        {
+            bytes += static_cast<std::size_t>(y0.size()) * (1 + q.size()) * sizeof(double);
+        }
+        return bytes;
+    }
 };
 
 // ---------------------------------------------------------------------------
@@ -90,28 +140,451 @@ struct DenseSegment {
 //   q₀ = f₀
 //   q₁ = 3(y₁−y₀)/h − 2f₀ − f₁
 //   q₂ = −2(y₁−y₀)/h + f₀ + f₁
-//   q₃ = 0
+//   q₃ … q[Q−1] = 0
 //
 // Interpolation error O(h⁴).
 // ---------------------------------------------------------------------------
 
-template <int N>
-[[nodiscard]] DenseSegment<N> hermite_segment(double t0, const Vec<N> &y0, double h, const Vec<N> &y1, const Vec<N> &f0, const Vec<N> &f1) noexcept
+template <int N, std::size_t Q>
+void build_hermite(DenseSegment<N, Q> &seg, double t0, const Vec<N> &y0, double h, const Vec<N> &y1, const Vec<N> &f0, const Vec<N> &f1) noexcept
 {
-    DenseSegment<N> seg;
     seg.t0 = t0;
     seg.h = h;
     seg.y0 = y0;
     seg.valid = true;
+    seg.order = 3;
 
-    const Vec<N> slope = (y1 - y0) * (1.0 / h);  // (y₁−y₀) / h
+    const double inv_h = 1.0 / h;  // slope = (y₁−y₀) / h, folded into each term
 
     seg.q[0] = f0;
-    seg.q[1] = 3.0 * slope - 2.0 * f0 - f1;
-    seg.q[2] = -2.0 * slope + f0 + f1;
-    seg.q[3].setZero();  // cubic: q[3] = 0
+    seg.q[1] = (3.0 * inv_h) * (y1 - y0) - 2.0 * f0 - f1;
+    seg.q[2] = (-2.0 * inv_h) * (y1 - y0) + f0 + f1;
+    for (std::size_t c = 3; c < Q; ++c)
+    {
+        seg.q[c].setZero(y0.size());  // cubic: higher terms vanish
+    }
+}
 
+template <int N>
+[[nodiscard]] DenseSegment<N> hermite_segment(double t0, const Vec<N> &y0, double h, const Vec<N> &y1, const Vec<N> &f0, const Vec<N> &f1) noexcept
+{
+    DenseSegment<N> seg;
+    build_hermite(seg, t0, y0, h, y1, f0, f1);
     return seg;
 }
 
-}  // namespace DES
\ No newline at end of file
+// ---------------------------------------------------------------------------
+// DenseRetention — which accepted segments a solver keeps for interpolate()
+//
+//   All       every segment of the solve (default)
+//   Time      segments overlapping the last `time_window` time units
+//   Segments  the last `segments` segments
+//   None      nothing; only the most recent step stays available through
+//             last_dense_step(), which events and uniform output use
+// ---------------------------------------------------------------------------
+
+struct DenseRetention {
+    enum class Kind {
+        All,
+        Time,
+        Segments,
+        None
+    };
+
+    Kind kind = Kind::All;
+    double time_window = 0.0;
+    std::size_t segments = 0;
+};
+
+// ---------------------------------------------------------------------------
+// DenseMode — which polynomial DoPri87 and Vern9 build for dense output,
+// chosen by their third template parameter
+//
+//   Standard   the Hermite cubic (segments hold 3 coefficient vectors);
+//              DoPri87's default
+//   HighOrder  the high-order continuous extension: 7th order (7 vectors,
+//              four extra stages) for DoPri87, 9th order (9 vectors,
+//              eleven extra stages) for Vern9, whose default it is.  The
+//              extra stages are evaluated lazily, for a step that a dense
+//              query actually hits
+// ---------------------------------------------------------------------------
+
+enum class DenseMode {
+    Standard,
+    HighOrder
+};
+
+// ---------------------------------------------------------------------------
+// DenseHistory<N, Q>
+//
+// Chronological segments of the current solve.  Evicted segments are
+// skipped with a head index and compacted away once they outnumber the
+// live ones, so eviction is amortised O(1) and never reallocates.
+//
+// find() goes through a uniform bucket table built as segments are pushed:
+// bucket b starts at t₀ + b·w in the integration direction and stores the
+// segment containing that start, so a query only searches the few segments
+// between two neighbouring buckets.  The width w starts at the first step
+// and doubles whenever buckets outnumber stored segments by about 2:1,
+// keeping the table O(n) with O(1) expected lookup for any step-size
+// profile.  Queries the table cannot answer fall back to binary search.
+// ---------------------------------------------------------------------------
+
+template <int N, std::size_t Q = 4>
+class DenseHistory {
+  public:
+    using Segment = DenseSegment<N, Q>;
+
+    void reset(const DenseRetention &policy, std::size_t reserve_hint)
+    {
+        if (policy.kind == DenseRetention::Kind::Time && !(policy.time_window >= 0.0))
+        {
+            throw std::invalid_argument("DES: dense retention time window must be non-negative");
+        }
+        if (policy.kind == DenseRetention::Kind::Segments && policy.segments == 0)
+        {
+            throw std::invalid_argument("DES: dense retention must keep at least one segment");
+        }
+
+        m_policy = policy;
+        m_segs.clear();
+        m_head = 0;
+        m_seg_base = 0;
+        m_bucket.clear();
+        m_bucket_base = 0;
+        m_width = 0.0;
+
+        switch (m_policy.kind)
+        {
+            case DenseRetention::Kind::None:
+                break;
+            case DenseRetention::Kind::Segments:
+                m_segs.reserve(2 * m_policy.segments + 1);  // bound before compaction
+                break;
+            default:
+                m_segs.reserve(reserve_hint);
+                break;
+        }
+        if (m_policy.kind != DenseRetention::Kind::None)
+        {
+            m_bucket.reserve(2 * m_segs.capacity() + kBucketSlack + 1);
+        }
+    }
+
+    void push(const Segment &seg)
+    {
+        if (m_policy.kind == DenseRetention::Kind::None)
+        {
+            return;
+        }
+        m_segs.push_back(seg);
+        index_back();
+        evict();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_segs.size() - m_head;
+    }
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    // i = 0 is the oldest retained segment
+    [[nodiscard]] const Segment &operator[](std::size_t i) const noexcept
+    {
+        return m_segs[m_head + i];
+    }
+    [[nodiscard]] const Segment &back() const noexcept
+    {
+        return m_segs.back();
+    }
+
+    // Mutable access for solvers that refine a stored segment in place
+    // (DoPri87 and Vern9 with DenseMode::HighOrder).  t0 and h must not
+    // change.
+    [[nodiscard]] Segment &back() noexcept
+    {
+        return m_segs.back();
+    }
+    [[nodiscard]] Segment *find(double t)
+    {
+        return const_cast<Segment *>(static_cast<const DenseHistory &>(*this).find(t));
+    }
+
+    // Segment containing t, or nullptr.  Checks the newest segment first,
+    // then the bucket table, then binary-searches the whole history.
+    [[nodiscard]] const Segment *find(double t) const
+    {
+        if (empty())
+        {
+            return nullptr;
+        }
+        if (back().contains(t))
+        {
+            return &back();
+        }
+
+        const double off = (m_width > 0.0) ? m_dir * (t - m_origin) / m_width : -1.0;
+        if (off >= static_cast<double>(m_bucket_base) && off < static_cast<double>(m_bucket_base + m_bucket.size()))
+        {
+            // Buckets hold logical segment numbers; m_seg_base maps them to m_segs
+            const std::size_t k = static_cast<std::size_t>(off) - m_bucket_base;
+            const std::size_t live = m_seg_base + m_head;
+            const std::size_t first = std::max(m_bucket[k], live);
+            const std::size_t last = (k + 1 < m_bucket.size()) ? m_bucket[k + 1] : m_seg_base + m_segs.size() - 1;
+            if (first <= last)
+            {
+                if (const Segment *seg = search(first - m_seg_base, last - m_seg_base + 1, t))
+                {
+                    return seg;
+                }
+            }
+        }
+        return search(m_head, m_segs.size(), t);
+    }
+
+    // Evaluate at the sorted times t[0..m) into the columns of `out`, one
+    // Horner pass per block of kEvalBlock θ values.  Returns how many
+    // leading queries were evaluated; fewer than m if a query is out of
+    // order or outside the retained segments.
+    static constexpr int kEvalBlock = 64;
+
+    std::size_t eval_many(const double *t, std::size_t m, Eigen::Matrix<double, N, Eigen::Dynamic> &out) const
+    {
+        if (empty())
+        {
+            return 0;
+        }
+        out.resize(back().y0.size(), static_cast<Eigen::Index>(m));
+
+        const double dir = (back().h >= 0.0) ? 1.0 : -1.0;
+        Eigen::Matrix<double, 1, Eigen::Dynamic, Eigen::RowMajor, 1, kEvalBlock> theta;
+
+        // Start the walk at t[0]'s segment, located through the bucket index
+        const Segment *start = (m > 0) ? find(t[0]) : nullptr;
+        std::size_t si = start ? static_cast<std::size_t>(start - m_segs.data()) : m_head;
+        std::size_t j = 0;
+        while (j < m)
+        {
+            // Advance to the first segment whose end is not before t[j]
+            while (si < m_segs.size() && dir * (t[j] - seg_end(m_segs[si])) > seg_eps(m_segs[si]))
+            {
+                ++si;
+            }
+            if (si == m_segs.size())
+            {
+                return j;
+            }
+            const Segment &seg = m_segs[si];
+            const double end = seg_end(seg);
+            const double eps = seg_eps(seg);
+            if (dir * (seg.t0 - t[j]) > eps)
+            {
+                return j;  // before this segment: outside history or unsorted
+            }
+
+            // Queries [j, j_end) in this segment, processed in blocks
+            std::size_t j_end = j + 1;
+            while (j_end < m && dir * (t[j_end] - t[j_end - 1]) >= 0.0 && dir * (t[j_end] - end) <= eps)
+            {
+                ++j_end;
+            }
+
+            for (std::size_t b = j; b < j_end; b += kEvalBlock)
+            {
+                const auto cnt = static_cast<Eigen::Index>(std::min<std::size_t>(kEvalBlock, j_end - b));
+                theta.resize(cnt);
+                for (Eigen::Index k = 0; k < cnt; ++k)
+                {
+                    theta[k] = (seg.h == 0.0) ? 0.0 : std::clamp((t[b + static_cast<std::size_t>(k)] - seg.t0) / seg.h, 0.0, 1.0);
+                }
+                eval_block(seg, theta, out.middleCols(static_cast<Eigen::Index>(b), cnt));
+            }
+            j = j_end;
+        }
+        return m;
+    }
+
+    [[nodiscard]] std::size_t memory_bytes() const noexcept
+    {
+        std::size_t bytes = m_segs.capacity() * sizeof(Segment) + m_bucket.capacity() * sizeof(std::size_t);
+        if constexpr (N == Eigen::Dynamic)
+        {
+            for (const auto &seg : m_segs)
+            {
+                bytes += seg.memory_bytes() - sizeof(Segment);
+            }
+        }
+        return bytes;
+    }
+
+  private:
+    static constexpr std::size_t kBucketSlack = 16;
+
+    std::vector<Segment> m_segs{};
+    std::size_t m_head = 0;      // first retained segment
+    std::size_t m_seg_base = 0;  // logical number of m_segs[0]
+    DenseRetention m_policy{};
+
+    // ── bucket index ──
+    std::vector<std::size_t> m_bucket{};  // logical segment containing each bucket start
+    std::size_t m_bucket_base = 0;        // bucket number of m_bucket[0]
+    double m_origin = 0.0;
+    double m_dir = 1.0;
+    double m_width = 0.0;  // 0 until the first segment
+
+    // Binary search over m_segs[lo, hi)
+    [[nodiscard]] const Segment *search(std::size_t lo, std::size_t hi, double t) const
+    {
+        while (lo < hi)
+        {
+            const std::size_t mid = lo + (hi - lo) / 2;
+            const auto &seg = m_segs[mid];
+            const double t1 = seg.t0 + seg.h;
+            const double eps = 64.0 * std::numeric_limits<double>::epsilon() * std::max(1.0, std::max(std::abs(seg.t0), std::abs(t1)));
+            const bool fwd = seg.h >= 0.0;
+            if (fwd ? (t < seg.t0 - eps) : (t > seg.t0 + eps))
+            {
+                hi = mid;
+            }
+            else if (fwd ? (t > t1 + eps) : (t < t1 - eps))
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                return &seg;
+            }
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] static double seg_end(const Segment &seg) noexcept
+    {
+        return seg.t0 + seg.h;
+    }
+
+    // Same tolerance as DenseSegment::contains()
+    [[nodiscard]] static double seg_eps(const Segment &seg) noexcept
+    {
+        return 64.0 * std::numeric_limits<double>::epsilon() * std::max(1.0, std::max(std::abs(seg.t0), std::abs(seg_end(seg))));
+    }
+
+    // Horner over a block of θ values: columns of `out` become
+    // y₀ + hθ(q₀ + θ(q₁ + …)), each step a rank-1 update across the block.
+    template <typename Theta, typename Block>
+    static void eval_block(const Segment &seg, const Theta &theta, Block &&out)
+    {
+        out.noalias() = seg.q[Q - 1] * theta;
+        for (std::size_t c = Q - 1; c-- > 0;)
+        {
+            out.colwise() += seg.q[c];
+            out.array().rowwise() *= theta.array();
+        }
+        out *= seg.h;
+        out.colwise() += seg.y0;
+    }
+
+    // Extend the bucket table over the newest segment
+    void index_back()
+    {
+        const Segment &seg = m_segs.back();
+        const std::size_t id = m_seg_base + m_segs.size() - 1;
+        if (m_width == 0.0)
+        {
+            if (!(std::abs(seg.h) > 0.0))
+            {
+                return;
+            }
+            m_origin = seg.t0;
+            m_dir = (seg.h >= 0.0) ? 1.0 : -1.0;
+            m_width = std::abs(seg.h);
+        }
+
+        const double end = m_dir * (seg_end(seg) - m_origin);
+        if (!(end >= 0.0))
+        {
+            return;
+        }
+        const std::size_t limit = 2 * m_segs.size() + kBucketSlack;
+        auto wanted = [&] {
+            const double last = std::floor(end / m_width);
+            const double have = static_cast<double>(m_bucket_base + m_bucket.size());
+            return (last >= have) ? last - have + 1.0 : 0.0;
+        };
+        while (static_cast<double>(m_bucket.size()) + wanted() > static_cast<double>(limit))
+        {
+            coarsen();
+        }
+        for (double n = wanted(); n > 0.0; n -= 1.0)
+        {
+            m_bucket.push_back(id);
+        }
+    }
+
+    // Double the bucket width: new bucket b covers old buckets 2b and 2b + 1
+    void coarsen()
+    {
+        const std::size_t base = (m_bucket_base + 1) / 2;
+        std::size_t n = 0;
+        for (std::size_t old = 2 * base - m_bucket_base; old < m_bucket.size(); old += 2)
+        {
+            m_bucket[n++] = m_bucket[old];
+        }
+        m_bucket.resize(n);
+        m_bucket_base = base;
+        m_width *= 2.0;
+    }
+
+    void evict()
+    {
+        switch (m_policy.kind)
+        {
+            case DenseRetention::Kind::Segments:
+                if (size() > m_policy.segments)
+                {
+                    m_head = m_segs.size() - m_policy.segments;
+                }
+                break;
+            case DenseRetention::Kind::Time:
+            {
+                // Keep every segment that reaches into [t_end − window, t_end]
+                const Segment &last = m_segs.back();
+                const double dir = (last.h >= 0.0) ? 1.0 : -1.0;
+                const double cutoff = last.t0 + last.h - dir * m_policy.time_window;
+                while (size() > 1)
+                {
+                    const Segment &old = m_segs[m_head];
+                    if (dir * (old.t0 + old.h - cutoff) >= 0.0)
+                    {
+                        break;
+                    }
+                    ++m_head;
+                }
+                break;
+            }
+            default:
+                return;
+        }
+
+        if (m_head > 0 && m_head >= size())
+        {
+            m_segs.erase(m_segs.begin(), m_segs.begin() + static_cast<std::ptrdiff_t>(m_head));
+            m_seg_base += m_head;
+            m_head = 0;
+
+            // Drop buckets that end before the first retained segment
+            std::size_t drop = 0;
+            while (drop + 1 < m_bucket.size() && m_bucket[drop + 1] < m_seg_base)
+            {
+                ++drop;
+            }
+            m_bucket.erase(m_bucket.begin(), m_bucket.begin() + static_cast<std::ptrdiff_t>(drop));
+            m_bucket_base += drop;
+        }
+    }
+};
+
+}  // namespace DES
@@ -0,0 +1,320 @@
+#pragma once
+
+/*  des_ensemble.hpp  –  DES namespace
+ *
+ *  Ensemble<Solver> — runs many independent solves on a persistent
+ *  work-stealing thread pool.
+ *
+ *  Each worker owns one Solver instance copied from a prototype.  The
+ *  instance is reused for every task the worker executes, so workspaces,
+ *  dense history and output vectors keep their capacity from task to task
+ *  instead of being reallocated per solve.
+ *
+ *  Scheduling
+ *  ──────────
+ *  Task indices [0, count) are split into one contiguous range per worker.
+ *  A worker pops indices from the front of its own range; when that runs
+ *  dry it steals the back half of another worker's range.  Stiff and
+ *  non-stiff trajectories can differ in cost by orders of magnitude, so the
+ *  initial partition is only a starting point — stealing keeps every core
+ *  busy until the last task is taken.
+ *
+ *  Usage
+ *  ─────
+ *      DES::Ensemble<DES::DoPri54<3>> ens(prototype);
+ *      auto out = ens.run(count, [&](std::size_t i, DES::DoPri54<3> &s) {
+ *          DES::Vec<3> y = y0[i];
+ *          Lorenz sys{rho[i]};
+ *          return s.solve(y, 0.0, 50.0, sys);
+ *      });
+ *      // out[i].result, out[i].stats
+ *
+ *  The task runs concurrently on different workers; anything it shares
+ *  across indices must be safe to read concurrently.  The first exception
+ *  thrown by a task cancels the remaining tasks and is rethrown by run().
+ *
+ *  C++17.
+ */
+
+#include "DES.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace DES {
+
+// ---------------------------------------------------------------------------
+// EnsembleResult — outcome of one task
+// ---------------------------------------------------------------------------
+
+struct EnsembleResult {
+    SolveResult result{};
+    SolverStats stats{};
+};
+
+// ---------------------------------------------------------------------------
+// Ensemble<Solver>
+// ---------------------------------------------------------------------------
+
+template <typename Solver>
+class Ensemble {
+  public:
+    // threads = 0 → std::thread::hardware_concurrency()
+    explicit Ensemble(const Solver &prototype = Solver{}, unsigned threads = 0)
+    {
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        m_solvers.reserve(threads);
+        m_ranges.reserve(threads);
+        for (unsigned w = 0; w < threads; ++w)
+        {
+            m_solvers.push_back(prototype);
+            m_ranges.push_back(std::make_unique<Range>());
+        }
+
+        m_threads.reserve(threads);
+        try
+        {
+            for (unsigned w = 0; w < threads; ++w)
+            {
+                m_threads.emplace_back([this, w] { worker_loop(w); });
+            }
+        }
+        catch (...)
+        {
+            // A joinable std::thread destroyed during unwinding would call
+            // std::terminate: stop and join the workers already started
+            shutdown();
+            throw;
+        }
+    }
+
+    Ensemble(const Ensemble &) = delete;
+    Ensemble &operator=(const Ensemble &) = delete;
+
+    ~Ensemble()
+    {
+        shutdown();
+    }
+
+    [[nodiscard]] unsigned workers() const noexcept
+    {
+        return static_cast<unsigned>(m_solvers.size());
+    }
+
+    // Worker-owned solver; only safe to touch while no run() is in flight.
+    [[nodiscard]] Solver &solver(unsigned worker)
+    {
+        return m_solvers.at(worker);
+    }
+
+    // Run task(i, solver) for every i in [0, count).  The task returns the
+    // SolveResult of its solve; the worker's SolverStats are captured with it.
+    template <typename Task>
+    [[nodiscard]] std::vector<EnsembleResult> run(std::size_t count, Task &&task)
+    {
+        std::vector<EnsembleResult> out;
+        run(count, std::forward<Task>(task), out);
+        return out;
+    }
+
+    // As above, writing into a caller-owned buffer so repeated ensembles
+    // reuse its capacity.
+    template <typename Task>
+    void run(std::size_t count, Task &&task, std::vector<EnsembleResult> &out)
+    {
+        static_assert(std::is_invocable_r_v<SolveResult, Task &, std::size_t, Solver &>, "Ensemble task must be callable as task(std::size_t index, Solver &) -> SolveResult");
+
+        out.resize(count);
+        if (count == 0)
+        {
+            return;
+        }
+
+        std::function<void(unsigned, std::size_t)> job = [&task, &out, this](unsigned w, std::size_t i) {
+            Solver &s = m_solvers[w];
+            out[i].result = task(i, s);
+            out[i].stats = s.stats();
+        };
+
+        dispatch(count, job);
+    }
+
+    // Convenience: integrate every state in place over [t0, t1] with a
+    // shared system.  sys must be safe to call concurrently.
+    template <typename State, typename System>
+    [[nodiscard]] std::vector<EnsembleResult> solve(std::vector<State> &states, double t0, double t1, System &sys)
+    {
+        return run(states.size(), [&](std::size_t i, Solver &s) { return s.solve(states[i], t0, t1, sys); });
+    }
+
+  private:
+    // Half-open index range owned by one worker; thieves shrink it from the back.
+    struct alignas(64) Range {
+        std::mutex mutex;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+    };
+
+    std::vector<Solver> m_solvers;
+    std::vector<std::unique_ptr<Range>> m_ranges;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::function<void(unsigned, std::size_t)> *m_job = nullptr;
+    unsigned long m_generation = 0;
+    unsigned m_busy = 0;
+    bool m_stop = false;
+
+    std::atomic<bool> m_cancel{false};
+    std::exception_ptr m_error;
+
+    void shutdown() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto &th : m_threads)
+        {
+            th.join();
+        }
+    }
+
+    void dispatch(std::size_t count, std::function<void(unsigned, std::size_t)> &job)
+    {
+        const std::size_t nw = m_ranges.size();
+        for (std::size_t w = 0; w < nw; ++w)
+        {
+            Range &r = *m_ranges[w];
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.begin = count * w / nw;
+            r.end = count * (w + 1) / nw;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_error = nullptr;
+        m_cancel.store(false, std::memory_order_relaxed);
+        m_busy = static_cast<unsigned>(nw);
+        ++m_generation;
+        m_wake.notify_all();
+        m_done.wait(lock, [this] { return m_busy == 0; });
+        m_job = nullptr;
+
+        if (m_error)
+        {
+            std::rethrow_exception(m_error);
+        }
+    }
+
+    void worker_loop(unsigned w)
+    {
+        unsigned long seen = 0;
+        for (;;)
+        {
+            std::function<void(unsigned, std::size_t)> *job = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+                if (m_stop)
+                {
+                    return;
+                }
+                seen = m_generation;
+                job = m_job;
+            }
+
+            while (const auto i = next_index(w))
+            {
+                if (m_cancel.load(std::memory_order_relaxed))
+                {
+                    continue;  // drain without executing
+                }
+                try
+                {
+                    (*job)(w, *i);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (!m_error)
+                    {
+                        m_error = std::current_exception();
+                    }
+                    m_cancel.store(true, std::memory_order_relaxed);
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_busy == 0)
+            {
+                m_done.notify_one();
+            }
+        }
+    }
+
+    // Pop from the front of the own range, otherwise steal.
+    [[nodiscard]] std::optional<std::size_t> next_index(unsigned w)
+    {
+        {
+            Range &own = *m_ranges[w];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (own.begin < own.end)
+            {
+                return own.begin++;
+            }
+        }
+        return steal(w);
+    }
+
+    // Take the back half of the first non-empty victim range, keep its first
+    // index for immediate execution and publish the rest as the own range.
+    [[nodiscard]] std::optional<std::size_t> steal(unsigned w)
+    {
+        const std::size_t nw = m_ranges.size();
+        for (std::size_t k = 1; k < nw; ++k)
+        {
+            Range &victim = *m_ranges[(w + k) % nw];
+            std::size_t lo = 0, hi = 0;
+            {
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                const std::size_t left = victim.end - victim.begin;
+                if (left == 0)
+                {
+                    continue;
+                }
+                hi = victim.end;
+                lo = victim.end - (left + 1) / 2;
+                victim.end = lo;
+            }
+
+            Range &own = *m_ranges[w];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.begin = lo + 1;
+            own.end = hi;
+            return lo;
+        }
+        return std::nullopt;
+    }
+};
+
+}  // namespace DES
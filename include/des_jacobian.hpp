@@ -0,0 +1,519 @@
+#pragma once
+
+/*  des_jacobian.hpp  –  DES namespace
+ *
+ *  Jacobian information for the implicit solvers (Rosenbrock4, BDF,
+ *  Radau5): compile-time detection of what a system provides, and the
+ *  Jacobian / iteration-matrix machinery they share.
+ *
+ *  Classes:
+ *    DES::HasJacobian<S, N>         – detects .jacobian(t, y, J)
+ *    DES::HasTimeDerivative<S, N>   – detects .time_derivative(t, y, dfdt)
+ *    DES::IterationMatrix<N, S>     – J = ∂f/∂y from the system's sources
+ *                                     and the factored W = σ·I − J
+ *
+ *  Requires C++17.
+ */
+
+#include "DES.hpp"
+#include "des_autodiff.hpp"
+#include "des_banded.hpp"
+#include "des_sparsity.hpp"
+
+#include <Eigen/SparseLU>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace DES {
+
+// ---------------------------------------------------------------------------
+// HasJacobian<System, N>
+//
+// True when System has a member:
+//   void jacobian(double t, const Vec<N>&, Eigen::Matrix<double,N,N>&)
+// ---------------------------------------------------------------------------
+
+template <typename System, int N, typename = void>
+struct HasJacobian : std::false_type {};
+
+template <typename System, int N>
+struct HasJacobian<System, N, std::void_t<decltype(std::declval<System &>().jacobian(std::declval<double>(), std::declval<const Vec<N> &>(), std::declval<Eigen::Matrix<double, N, N> &>()))>> : std::true_type {};
+
+// ---------------------------------------------------------------------------
+// HasTimeDerivative<System, N>
+//
+// True when System has a member:
+//   void time_derivative(double t, const Vec<N>&, Vec<N>& dfdt)
+// ---------------------------------------------------------------------------
+
+template <typename System, int N, typename = void>
+struct HasTimeDerivative : std::false_type {};
+
+template <typename System, int N>
+struct HasTimeDerivative<System, N, std::void_t<decltype(std::declval<System &>().time_derivative(std::declval<double>(), std::declval<const Vec<N> &>(), std::declval<Vec<N> &>()))>> : std::true_type {};
+
+// ---------------------------------------------------------------------------
+// IterationMatrix<N, Structure>
+//
+// J = ∂f/∂y at (t, y) and the factored iteration matrix W = σ·I − J, for a
+// diagonal shift σ chosen by the solver (Rosenbrock4: 1/(γh), BDF: 1/c,
+// Radau5: γ̂/h).  Source of J, in order of preference: analytical
+// .jacobian(), declared band (BandedLU) or sparsity pattern (CPR-colored
+// differences, Eigen::SparseLU), forward-mode autodiff through a
+// Dual-templated RHS, dense finite differences.
+//
+// JacobianStructure::Dense ignores declared bands and sparsity patterns and
+// always keeps J as a dense matrix, for solvers that need J itself (Radau5
+// builds its complex matrix from it).  A fixed N ≤ kSparseMinN never takes
+// the sparse path either: W is small enough that a dense LU is cheaper, and
+// Eigen::SparseLU is not instantiated for it.
+//
+// Per solve: bind() once with the system, resize() and set_fd_floor()
+// from before_solve(), then evaluate() / factor() / solve() from the step.
+// After the first step nothing allocates.
+// ---------------------------------------------------------------------------
+
+enum class JacobianStructure { Detect, Dense };
+
+template <int N, JacobianStructure Structure = JacobianStructure::Detect>
+class IterationMatrix {
+  public:
+    using JacMat = Eigen::Matrix<double, N, N>;
+
+    static constexpr int kSparseMinN = 16;
+    static constexpr bool kSparse = (Structure == JacobianStructure::Detect) && (N == Eigen::Dynamic || N > kSparseMinN);
+
+    // ── Setup ───────────────────────────────────────────────────────────────
+    //
+    // Detects the system's Jacobian sources at compile time.  An analytical
+    // .jacobian() is captured by reference (valid for the duration of the
+    // solve() call that binds it).  `probe_sparsity` takes the sparse path
+    // with a pattern found by structural probing when the system declares
+    // none; `solver` names the caller in error messages.
+
+    template <typename System>
+    void bind(System &sys, Eigen::Index n, bool probe_sparsity, const char *solver)
+    {
+        constexpr bool structured = (Structure == JacobianStructure::Detect);
+
+        if constexpr (HasJacobian<System, N>::value)
+        {
+            m_jac_fn = [&sys](double t, const Vec<N> &y, JacMat &J) { sys.jacobian(t, y, J); };
+        }
+        else
+        {
+            m_jac_fn = nullptr;  // finite differences, or autodiff below
+        }
+
+        m_sparse_declared = false;
+        if constexpr (kSparse && HasJacobianSparsity<System>::value && !HasJacobian<System, N>::value)
+        {
+            m_sparsity.reset(n);
+            sys.jacobian_sparsity(m_sparsity);
+            m_sparsity.finalize();
+            m_sparse_declared = true;
+        }
+
+        m_use_banded = false;
+        if constexpr (structured && HasJacobianBandwidth<System>::value && !HasJacobian<System, N>::value)
+        {
+            const Bandwidth bw = sys.jacobian_bandwidth();
+            if (bw.lower < 0 || bw.upper < 0)
+            {
+                throw std::invalid_argument(std::string("DES: ") + solver + " jacobian_bandwidth() must be non-negative");
+            }
+            const int max_bw = static_cast<int>(std::max<Eigen::Index>(n - 1, 0));
+            m_band = {std::min(bw.lower, max_bw), std::min(bw.upper, max_bw)};
+            m_use_banded = true;
+        }
+
+        m_use_autodiff = false;
+        if constexpr (HasDualRhs<System, N>::value && !HasJacobian<System, N>::value)
+        {
+            if (!m_use_banded && !m_sparse_declared)
+            {
+                m_jac_fn = [this, &sys](double t, const Vec<N> &y, JacMat &J) { m_autodiff(sys, t, y, J); };
+                m_use_autodiff = true;
+            }
+        }
+        m_use_sparse = kSparse && !m_jac_fn && !m_use_banded && (m_sparse_declared || probe_sparsity);
+    }
+
+    // Sizes the storage of the path chosen by bind().  The sparse path lays
+    // out J and W once the pattern is known, at the first evaluate(); the
+    // dense N×N pair is only sized when used.
+    void resize(Eigen::Index n)
+    {
+        if (m_use_banded)
+        {
+            m_Jb.resize(m_band.lower + m_band.upper + 1, n);
+            m_Jb.setZero();
+            m_blu.resize(n, m_band.lower, m_band.upper);
+        }
+        else if (m_use_sparse)
+        {
+            if (!m_sparse_declared)
+            {
+                m_sparsity.reset(n);  // probed again at the first step
+            }
+            m_sparse_init = false;
+        }
+        else
+        {
+            m_J.resize(n, n);
+            m_W.resize(n, n);
+            if constexpr (N == Eigen::Dynamic)
+            {
+                // fixed N: the default-constructed LU already has its size
+                m_lu = LU_t(n);
+            }
+            if (m_use_autodiff)
+            {
+                m_autodiff.resize(n);
+            }
+        }
+        m_y_pert.resize(n);
+        m_f_pert.resize(n);
+        m_fd_floor.resize(n);
+        m_fd_floor.setOnes();
+    }
+
+    // Finite differences perturb component j by fd_eps · max(|y[j]|, s_j)
+    // with s_j = min(1, atol_j), the magnitude below which the component
+    // only matters to its absolute tolerance.  The perturbation then scales
+    // with the component even when it is far below 1; a fixed s_j = 1
+    // probes a component that lives at 1e-13 with a step a million times
+    // its size, and the error that leaves in J on quadratic terms stalls
+    // Newton once h is large.  atol_of(j) gives atol_j.
+    template <typename AtolOf>
+    void set_fd_floor(AtolOf &&atol_of)
+    {
+        for (Eigen::Index j = 0; j < m_fd_floor.size(); ++j)
+        {
+            const double atol = atol_of(j);
+            m_fd_floor[j] = (atol > 0.0) ? std::min(1.0, atol) : 1.0;
+        }
+    }
+
+    // ── Queries ─────────────────────────────────────────────────────────────
+
+    // True when evaluate() differences the RHS, and so needs f(t, y) exact
+    [[nodiscard]] bool finite_differences() const noexcept
+    {
+        return !m_jac_fn;
+    }
+
+    // Pattern and coloring used by the sparse path (empty otherwise)
+    [[nodiscard]] const JacobianSparsity &sparsity() const noexcept
+    {
+        return m_sparsity;
+    }
+
+    // J on the dense path (the only path for JacobianStructure::Dense)
+    [[nodiscard]] const JacMat &dense() const noexcept
+    {
+        return m_J;
+    }
+
+    // ── J at (t, y) ─────────────────────────────────────────────────────────
+    //
+    // f0 = f(t, y).  Finite differences perturb component j by
+    // fd_eps · max(|y[j]|, s_j) (see set_fd_floor()).  For DDEs the rhs
+    // lambda fixes the delay query window at the step start, so perturbing
+    // y does not move it.
+
+    template <typename RhsEval>
+    void evaluate(double t, const Vec<N> &y, const Vec<N> &f0, RhsEval &rhs, double fd_eps, SolverStats &stats)
+    {
+        if (m_jac_fn)
+        {
+            m_jac_fn(t, y, m_J);
+        }
+        else if (m_use_banded)
+        {
+            jac_fd_banded(t, y, f0, rhs, fd_eps, stats);
+        }
+        else if (m_use_sparse)
+        {
+            if (!m_sparse_init)
+            {
+                init_sparse(t, y, rhs, stats);
+            }
+            jac_fd_colored(t, y, f0, rhs, fd_eps, stats);
+        }
+        else
+        {
+            jac_fd(t, y, f0, rhs, fd_eps, stats);
+        }
+        ++stats.jacobian_evals;
+    }
+
+    // ── W = σ·I − J and its solves ──────────────────────────────────────────
+
+    void factor(double shift)
+    {
+        if (m_use_banded)
+        {
+            const Eigen::Index n = m_Jb.cols();
+            const int kl = m_band.lower;
+            const int ku = m_band.upper;
+            m_blu.clear();
+            for (Eigen::Index j = 0; j < n; ++j)
+            {
+                const Eigen::Index i0 = std::max<Eigen::Index>(0, j - ku);
+                const Eigen::Index i1 = std::min<Eigen::Index>(n - 1, j + kl);
+                for (Eigen::Index i = i0; i <= i1; ++i)
+                {
+                    m_blu.at(i, j) = -m_Jb(ku + i - j, j);
+                }
+                m_blu.at(j, j) += shift;
+            }
+            m_blu.factorize();
+        }
+        else if (m_use_sparse)
+        {
+            factor_sparse(shift);
+        }
+        else
+        {
+            m_W = -m_J;
+            m_W.diagonal().array() += shift;
+            m_lu.compute(m_W);
+        }
+    }
+
+    // x = W⁻¹ b.  A failed sparse or banded factorization (singular W)
+    // yields NaN, which the callers treat as a failed step.  x may alias b
+    // on the dense and banded paths.
+    void solve(const Vec<N> &b, Vec<N> &x)
+    {
+        if (m_use_banded)
+        {
+            if (m_blu.ok())
+            {
+                x = b;
+                m_blu.solve(x);
+            }
+            else
+            {
+                x.setConstant(std::numeric_limits<double>::quiet_NaN());
+            }
+        }
+        else if (m_use_sparse)
+        {
+            solve_sparse(b, x);
+        }
+        else
+        {
+            x = m_lu.solve(b);
+        }
+    }
+
+  private:
+    using LU_t = Eigen::PartialPivLU<JacMat>;
+
+    // Dense path
+    JacMat m_J{};
+    JacMat m_W{};
+    LU_t m_lu{};
+
+    // Sparse path: pattern/coloring, J and W sharing its layout, positions
+    // of the diagonal in m_Ws' value array, and the factorization (an empty
+    // placeholder unless kSparse)
+    struct NoSparseLU {};
+    using SparseLU_t = std::conditional_t<kSparse, Eigen::SparseLU<Eigen::SparseMatrix<double>>, NoSparseLU>;
+
+    JacobianSparsity m_sparsity{};
+    Eigen::SparseMatrix<double> m_Js{};
+    Eigen::SparseMatrix<double> m_Ws{};
+    std::vector<Eigen::Index> m_diag_pos{};
+    SparseLU_t m_slu{};
+    bool m_use_sparse = false;
+    bool m_sparse_declared = false;
+    bool m_sparse_init = false;
+    bool m_slu_ok = false;
+
+    // Banded path: J in (lower + upper + 1) × N band storage, J(i, j) at row
+    // upper + i − j of column j, and the banded factorization of W
+    Bandwidth m_band{};
+    Eigen::MatrixXd m_Jb{};
+    BandedLU m_blu{};
+    bool m_use_banded = false;
+
+    // Autodiff path: Dual copies of y and f, sized in resize()
+    DualJacobian<N> m_autodiff{};
+    bool m_use_autodiff = false;
+
+    // Finite-difference scratch and the per-component perturbation floor
+    Vec<N> m_y_pert{};
+    Vec<N> m_f_pert{};
+    Vec<N> m_fd_floor{};
+
+    // Type-erased analytical or autodiff Jacobian.  Null ⟹ finite
+    // differences.  Set by bind(); valid for the solve() that called it.
+    std::function<void(double, const Vec<N> &, JacMat &)> m_jac_fn;
+
+    // ── Sparse setup: probe if needed, lay out J and W, analyze once ─────────
+    //
+    // The sparse helpers are only reached with m_use_sparse, which bind()
+    // never sets unless kSparse; otherwise their bodies are discarded.
+
+    template <typename RhsEval>
+    void init_sparse(double t, const Vec<N> &y, RhsEval &rhs, SolverStats &stats)
+    {
+        if constexpr (kSparse)
+        {
+            if (!m_sparsity.ready())
+            {
+                stats.rhs_evals += m_sparsity.probe(t, y, rhs);
+            }
+            m_Js = m_sparsity.pattern();
+            m_Ws = m_sparsity.pattern();
+            m_diag_pos.resize(static_cast<std::size_t>(y.size()));
+            for (Eigen::Index j = 0; j < y.size(); ++j)
+            {
+                for (Eigen::Index k = m_sparsity.col_begin(j); k < m_sparsity.col_end(j); ++k)
+                {
+                    if (m_sparsity.row(k) == j)
+                    {
+                        m_diag_pos[static_cast<std::size_t>(j)] = k;
+                    }
+                }
+            }
+            m_slu.analyzePattern(m_Ws);
+            m_sparse_init = true;
+        }
+    }
+
+    void factor_sparse(double shift)
+    {
+        if constexpr (kSparse)
+        {
+            const Eigen::Index nnz = m_Js.nonZeros();
+            const double *j = m_Js.valuePtr();
+            double *w = m_Ws.valuePtr();
+            for (Eigen::Index k = 0; k < nnz; ++k)
+            {
+                w[k] = -j[k];
+            }
+            for (const Eigen::Index k : m_diag_pos)
+            {
+                w[k] += shift;
+            }
+            m_slu.factorize(m_Ws);
+            m_slu_ok = (m_slu.info() == Eigen::Success);
+        }
+    }
+
+    void solve_sparse(const Vec<N> &b, Vec<N> &x)
+    {
+        if constexpr (kSparse)
+        {
+            if (m_slu_ok)
+            {
+                x = m_slu.solve(b);
+                return;
+            }
+        }
+        x.setConstant(std::numeric_limits<double>::quiet_NaN());
+    }
+
+    // ── Colored finite-difference Jacobian (Curtis–Powell–Reid) ─────────────
+    //
+    // All columns of one color are perturbed together; since they share no
+    // row, entry (r, j) is read off the one difference that column j moves.
+    // Cost: num_colors() RHS evaluations.
+
+    template <typename RhsEval>
+    void jac_fd_colored(double t, const Vec<N> &y, const Vec<N> &f0, RhsEval &rhs, double fd_eps, SolverStats &stats)
+    {
+        double *val = m_Js.valuePtr();
+        m_y_pert = y;
+        for (int c = 0; c < m_sparsity.num_colors(); ++c)
+        {
+            const auto [first, last] = m_sparsity.color_columns(c);
+            for (const Eigen::Index *j = first; j != last; ++j)
+            {
+                m_y_pert[*j] = y[*j] + fd_eps * std::max(std::abs(y[*j]), m_fd_floor[*j]);
+            }
+            rhs(t, m_y_pert, m_f_pert);
+            ++stats.rhs_evals;
+            for (const Eigen::Index *j = first; j != last; ++j)
+            {
+                const double inv_eps = 1.0 / (m_y_pert[*j] - y[*j]);
+                for (Eigen::Index k = m_sparsity.col_begin(*j); k < m_sparsity.col_end(*j); ++k)
+                {
+                    const Eigen::Index r = m_sparsity.row(k);
+                    val[k] = (m_f_pert[r] - f0[r]) * inv_eps;
+                }
+                m_y_pert[*j] = y[*j];
+            }
+        }
+    }
+
+    // ── Banded finite-difference Jacobian ───────────────────────────────────
+    //
+    // Columns j ≡ g (mod lower + upper + 1) touch disjoint row ranges
+    // [j − upper, j + lower], so each group is one perturbed RHS call.
+    // Cost: min(lower + upper + 1, N) RHS evaluations.
+
+    template <typename RhsEval>
+    void jac_fd_banded(double t, const Vec<N> &y, const Vec<N> &f0, RhsEval &rhs, double fd_eps, SolverStats &stats)
+    {
+        const Eigen::Index n = y.size();
+        const int kl = m_band.lower;
+        const int ku = m_band.upper;
+        const Eigen::Index width = std::min<Eigen::Index>(kl + ku + 1, n);
+        m_y_pert = y;
+        for (Eigen::Index g = 0; g < width; ++g)
+        {
+            for (Eigen::Index j = g; j < n; j += width)
+            {
+                m_y_pert[j] = y[j] + fd_eps * std::max(std::abs(y[j]), m_fd_floor[j]);
+            }
+            rhs(t, m_y_pert, m_f_pert);
+            ++stats.rhs_evals;
+            for (Eigen::Index j = g; j < n; j += width)
+            {
+                const double inv_eps = 1.0 / (m_y_pert[j] - y[j]);
+                const Eigen::Index i0 = std::max<Eigen::Index>(0, j - ku);
+                const Eigen::Index i1 = std::min<Eigen::Index>(n - 1, j + kl);
+                for (Eigen::Index i = i0; i <= i1; ++i)
+                {
+                    m_Jb(ku + i - j, j) = (m_f_pert[i] - f0[i]) * inv_eps;
+                }
+                m_y_pert[j] = y[j];
+            }
+        }
+    }
+
+    // ── Dense finite-difference Jacobian ────────────────────────────────────
+    //
+    // Forward difference column by column:
+    //   J[:,j] ≈ (f(t, y + ε eⱼ) − f(t, y)) / ε,   ε = fd_eps · max(|y[j]|, s_j)
+    // Cost: N RHS evaluations.
+
+    template <typename RhsEval>
+    void jac_fd(double t, const Vec<N> &y, const Vec<N> &f0, RhsEval &rhs, double fd_eps, SolverStats &stats)
+    {
+        m_y_pert = y;
+        for (Eigen::Index j = 0; j < y.size(); ++j)
+        {
+            const double eps_j = fd_eps * std::max(std::abs(y[j]), m_fd_floor[j]);
+            m_y_pert[j] = y[j] + eps_j;
+            rhs(t, m_y_pert, m_f_pert);
+            ++stats.rhs_evals;
+            m_J.col(j) = (m_f_pert - f0) * (1.0 / eps_j);
+            m_y_pert[j] = y[j];
+        }
+    }
+};
+
+}  // namespace DES
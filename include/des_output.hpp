@@ -0,0 +1,365 @@
+#pragma once
+
+/*  des_output.hpp  –  DES namespace
+ *
+ *  Streaming output sinks for AdaptiveDES.
+ *
+ *  With options.sink set, the points a solve() records (the same points
+ *  that would otherwise go into OutputHistory) are staged in a fixed-size
+ *  batch owned by the solver.  The sink receives the batch whenever it
+ *  fills and once more at the end of solve(), so steady-state memory is
+ *  bounded by the batch plus whatever the sink itself keeps.  OutputHistory
+ *  stays empty in that mode.
+ *
+ *  Classes:
+ *    DES::OutputBatch<N>      – view of one batch as parallel arrays
+ *    DES::OutputSink<N>       – sink interface
+ *    DES::OutputStage<N>      – fixed-capacity staging buffer
+ *    DES::VectorSink<N>       – keeps every point (unbounded)
+ *    DES::RingSink<N>         – keeps the last K points
+ *    DES::DecimatingSink<N>   – forwards every k-th point to another sink
+ *
+ *  Requires C++17.
+ */
+
+#include "DES.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace DES {
+
+// ---------------------------------------------------------------------------
+// OutputBatch<N> — read-only view of `size` consecutive recorded points
+// ---------------------------------------------------------------------------
+
+template <int N>
+struct OutputBatch {
+    const double *t = nullptr;
+    const double *h = nullptr;
+    const double *error = nullptr;
+    const Vec<N> *y = nullptr;
+    std::size_t size = 0;
+};
+
+// ---------------------------------------------------------------------------
+// OutputSink<N>
+//
+// begin() is called at the start of every solve() with the state dimension,
+// consume() once per batch in recording order, end() after the last batch.
+// The batch storage is only valid for the duration of consume().
+// ---------------------------------------------------------------------------
+
+template <int N>
+class OutputSink {
+  public:
+    virtual ~OutputSink() = default;
+
+    virtual void begin(Eigen::Index /*dim*/)
+    {}
+
+    virtual void consume(const OutputBatch<N> &batch) = 0;
+
+    virtual void end()
+    {}
+};
+
+// ---------------------------------------------------------------------------
+// OutputStage<N> — fixed-capacity batch buffer
+//
+// reset() is the only call that allocates; push() into a non-full stage
+// copies into preallocated storage (also for N = Eigen::Dynamic).
+// ---------------------------------------------------------------------------
+
+template <int N>
+class OutputStage {
+  public:
+    void reset(std::size_t capacity, Eigen::Index dim)
+    {
+        m_t.resize(capacity);
+        m_h.resize(capacity);
+        m_error.resize(capacity);
+        m_y.resize(capacity);
+        for (auto &v : m_y)
+        {
+            v.resize(dim);
+        }
+        m_size = 0;
+    }
+
+    void push(double t, double h, double err, const Vec<N> &y) noexcept
+    {
+        m_t[m_size] = t;
+        m_h[m_size] = h;
+        m_error[m_size] = err;
+        m_y[m_size] = y;
+        ++m_size;
+    }
+
+    void clear() noexcept
+    {
+        m_size = 0;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] bool full() const noexcept
+    {
+        return m_size == m_t.size();
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return m_t.size();
+    }
+
+    [[nodiscard]] std::size_t memory_bytes() const noexcept
+    {
+        std::size_t bytes = (m_t.capacity() + m_h.capacity() + m_error.capacity()) * sizeof(double) + m_y.capacity() * sizeof(Vec<N>);
+        if constexpr (N == Eigen::Dynamic)
+        {
+            for (const auto &v : m_y)
+            {
+                bytes += static_cast<std::size_t>(v.size()) * sizeof(double);
+            }
+        }
+        return bytes;
+    }
+
+    [[nodiscard]] OutputBatch<N> view() const noexcept
+    {
+        return OutputBatch<N>{m_t.data(), m_h.data(), m_error.data(), m_y.data(), m_size};
+    }
+
+  private:
+    std::vector<double> m_t{};
+    std::vector<double> m_h{};
+    std::vector<double> m_error{};
+    std::vector<Vec<N>> m_y{};
+    std::size_t m_size = 0;
+};
+
+// ---------------------------------------------------------------------------
+// VectorSink<N> — every point in growing vectors, laid out like OutputHistory
+// ---------------------------------------------------------------------------
+
+template <int N>
+class VectorSink : public OutputSink<N> {
+  public:
+    std::vector<double> t{};
+    std::vector<double> h{};
+    std::vector<double> error{};
+    std::vector<Vec<N>> y{};
+
+    void consume(const OutputBatch<N> &batch) override
+    {
+        t.insert(t.end(), batch.t, batch.t + batch.size);
+        h.insert(h.end(), batch.h, batch.h + batch.size);
+        error.insert(error.end(), batch.error, batch.error + batch.size);
+        y.insert(y.end(), batch.y, batch.y + batch.size);
+    }
+
+    void reserve(std::size_t n)
+    {
+        t.reserve(n);
+        h.reserve(n);
+        error.reserve(n);
+        y.reserve(n);
+    }
+
+    void clear() noexcept
+    {
+        t.clear();
+        h.clear();
+        error.clear();
+        y.clear();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return t.size();
+    }
+};
+
+// ---------------------------------------------------------------------------
+// RingSink<N> — the most recent `capacity` points
+//
+// Index 0 is the oldest retained point, size() − 1 the newest.  Contents
+// persist across solve() calls until clear(), so a long run split into
+// several solves keeps a continuous window.
+// ---------------------------------------------------------------------------
+
+template <int N>
+class RingSink : public OutputSink<N> {
+  public:
+    explicit RingSink(std::size_t capacity)
+        : m_t(capacity)
+        , m_h(capacity)
+        , m_error(capacity)
+        , m_y(capacity)
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument("DES: RingSink capacity must be positive");
+        }
+    }
+
+    void begin(Eigen::Index dim) override
+    {
+        if (m_size > 0 && m_y[0].size() != dim)
+        {
+            clear();
+        }
+        for (auto &v : m_y)
+        {
+            v.resize(dim);
+        }
+    }
+
+    void consume(const OutputBatch<N> &batch) override
+    {
+        const std::size_t cap = m_t.size();
+        for (std::size_t i = 0; i < batch.size; ++i)
+        {
+            const std::size_t slot = (m_head + m_size) % cap;
+            m_t[slot] = batch.t[i];
+            m_h[slot] = batch.h[i];
+            m_error[slot] = batch.error[i];
+            m_y[slot] = batch.y[i];
+            if (m_size < cap)
+            {
+                ++m_size;
+            }
+            else
+            {
+                m_head = (m_head + 1) % cap;
+            }
+        }
+        m_total += batch.size;
+    }
+
+    void clear() noexcept
+    {
+        m_head = 0;
+        m_size = 0;
+        m_total = 0;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return m_t.size();
+    }
+    // Points seen since construction or the last clear(), retained or not
+    [[nodiscard]] std::size_t total() const noexcept
+    {
+        return m_total;
+    }
+
+    [[nodiscard]] double t(std::size_t i) const
+    {
+        return m_t[slot(i)];
+    }
+    [[nodiscard]] double h(std::size_t i) const
+    {
+        return m_h[slot(i)];
+    }
+    [[nodiscard]] double error(std::size_t i) const
+    {
+        return m_error[slot(i)];
+    }
+    [[nodiscard]] const Vec<N> &y(std::size_t i) const
+    {
+        return m_y[slot(i)];
+    }
+
+  private:
+    std::vector<double> m_t;
+    std::vector<double> m_h;
+    std::vector<double> m_error;
+    std::vector<Vec<N>> m_y;
+    std::size_t m_head = 0;
+    std::size_t m_size = 0;
+    std::size_t m_total = 0;
+
+    [[nodiscard]] std::size_t slot(std::size_t i) const
+    {
+        if (i >= m_size)
+        {
+            throw std::out_of_range("DES: RingSink index out of range");
+        }
+        return (m_head + i) % m_t.size();
+    }
+};
+
+// ---------------------------------------------------------------------------
+// DecimatingSink<N> — forwards every `stride`-th point to a downstream sink
+//
+// The phase runs over the whole stream, not per batch, so the kept points
+// are evenly spaced in recording order regardless of batch boundaries.
+// ---------------------------------------------------------------------------
+
+template <int N>
+class DecimatingSink : public OutputSink<N> {
+  public:
+    DecimatingSink(OutputSink<N> &downstream, std::size_t stride)
+        : m_next(&downstream)
+        , m_stride(stride)
+    {
+        if (stride == 0)
+        {
+            throw std::invalid_argument("DES: DecimatingSink stride must be positive");
+        }
+    }
+
+    void begin(Eigen::Index dim) override
+    {
+        m_dim = dim;
+        m_phase = 0;
+        m_next->begin(dim);
+    }
+
+    void consume(const OutputBatch<N> &batch) override
+    {
+        if (m_kept.capacity() < batch.size)
+        {
+            m_kept.reset(batch.size, m_dim);
+        }
+        m_kept.clear();
+
+        for (std::size_t i = 0; i < batch.size; ++i)
+        {
+            if (m_phase == 0)
+            {
+                m_kept.push(batch.t[i], batch.h[i], batch.error[i], batch.y[i]);
+            }
+            m_phase = (m_phase + 1) % m_stride;
+        }
+
+        if (!m_kept.empty())
+        {
+            m_next->consume(m_kept.view());
+        }
+    }
+
+    void end() override
+    {
+        m_next->end();
+    }
+
+  private:
+    OutputSink<N> *m_next;
+    std::size_t m_stride;
+    std::size_t m_phase = 0;
+    Eigen::Index m_dim = (N == Eigen::Dynamic) ? 0 : N;
+    OutputStage<N> m_kept{};
+};
+
+}  // namespace DES
@@ -0,0 +1,292 @@
+#pragma once
+
+/*  des_tableau.hpp  –  DES namespace
+ *
+ *  Compile-time Butcher-tableau engine for explicit Runge–Kutta pairs.
+ *
+ *  ExplicitRK<Tableau>  — unrolled stage loop generated from a constexpr
+ *                         tableau; zero coefficients are dropped at compile
+ *                         time and every stage sum is one fused Eigen
+ *                         expression (a single pass over the state);
+ *                         step(…, norm) also reduces the scaled error norm
+ *                         in the pass that writes the error estimate
+ *  ARow / BRow / ERow / PRow — coefficient rows of a tableau, usable with
+ *                         ExplicitRK::combine() for solver-specific sums
+ *                         (dense output, extra stages)
+ *
+ *  A tableau is a struct with
+ *
+ *      static constexpr int    stages;             // s
+ *      static constexpr double c[s];               // abscissae, c[0] = 0
+ *      static constexpr double a[s][s];            // strictly lower triangular
+ *      static constexpr double b[s];               // solution weights
+ *      static constexpr double e[s];               // error weights b − b̂
+ *
+ *  and optionally `p[s][D]` for a continuous extension (see PRow).  When
+ *  the last row of A equals b and c[s−1] = 1 the pair is FSAL: the last
+ *  stage is f(t+h, y_{n+1}), evaluated at ws.next and copied to ws.fsal.
+ *  C++17.  Requires DES.hpp (Eigen).
+ */
+
+#include "DES.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace DES {
+
+// ---------------------------------------------------------------------------
+// Coefficient rows — Row::size entries, Row::at(j) is the weight of k[j]
+// ---------------------------------------------------------------------------
+
+template <typename T, int I>
+struct ARow {
+    static constexpr int size = I;  // strictly lower triangular: j < I
+    [[nodiscard]] static constexpr double at(int j)
+    {
+        return T::a[I][j];
+    }
+};
+
+template <typename T>
+struct BRow {
+    static constexpr int size = T::stages;
+    [[nodiscard]] static constexpr double at(int j)
+    {
+        return T::b[j];
+    }
+};
+
+template <typename T>
+struct ERow {
+    static constexpr int size = T::stages;
+    [[nodiscard]] static constexpr double at(int j)
+    {
+        return T::e[j];
+    }
+};
+
+// Column D of a continuous extension p[stage][degree]
+template <typename T, int D>
+struct PRow {
+    static constexpr int size = T::stages;
+    [[nodiscard]] static constexpr double at(int j)
+    {
+        return T::p[j][D];
+    }
+};
+
+// ---------------------------------------------------------------------------
+// NonZero<Row> — indices of the non-zero entries of a row, in order
+// ---------------------------------------------------------------------------
+
+template <std::size_t L>
+struct NonZeroIndices {
+    std::array<int, L> idx{};
+    int count = 0;
+};
+
+template <typename Row>
+[[nodiscard]] constexpr NonZeroIndices<static_cast<std::size_t>(Row::size)> scan_nonzero()
+{
+    NonZeroIndices<static_cast<std::size_t>(Row::size)> out{};
+    for (int j = 0; j < Row::size; ++j)
+    {
+        if (Row::at(j) != 0.0)
+        {
+            out.idx[static_cast<std::size_t>(out.count++)] = j;
+        }
+    }
+    return out;
+}
+
+template <typename Row>
+struct NonZero {
+    static constexpr auto scan = scan_nonzero<Row>();
+    static constexpr int count = scan.count;
+
+    template <std::size_t I>
+    static constexpr int index = scan.idx[I];
+
+    template <std::size_t I>
+    static constexpr double coeff = Row::at(scan.idx[I]);
+};
+
+// ---------------------------------------------------------------------------
+// ExplicitRK<Tableau>
+// ---------------------------------------------------------------------------
+
+template <typename Tableau>
+struct ExplicitRK {
+    static constexpr int stages = Tableau::stages;
+
+    // Last stage evaluated at the new solution (a[s−1][·] = b, c[s−1] = 1)
+    [[nodiscard]] static constexpr bool is_fsal()
+    {
+        if (Tableau::c[stages - 1] != 1.0 || Tableau::b[stages - 1] != 0.0)
+        {
+            return false;
+        }
+        for (int j = 0; j < stages - 1; ++j)
+        {
+            if (Tableau::a[stages - 1][j] != Tableau::b[j])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static constexpr bool fsal = is_fsal();
+
+    // out = base + scale · Σⱼ Row::at(j) · k[j] over the non-zero entries,
+    // as one expression: each entry of out is written once
+    template <typename Row, typename Out, typename Base, typename K>
+    static void combine(Out &out, const Base &base, double scale, const K &k)
+    {
+        combine_impl<Row>(out, base, scale, k, std::make_index_sequence<static_cast<std::size_t>(NonZero<Row>::count)>{});
+    }
+
+    // out = scale · Σⱼ Row::at(j) · k[j]  (Row must have a non-zero entry)
+    template <typename Row, typename Out, typename K>
+    static void combine(Out &out, double scale, const K &k)
+    {
+        static_assert(NonZero<Row>::count > 0, "ExplicitRK::combine: row without non-zero coefficients");
+        combine_impl<Row>(out, scale, k, std::make_index_sequence<static_cast<std::size_t>(NonZero<Row>::count)>{});
+    }
+
+    // One trial step.  On entry ws.k[0] = f(t, y); on exit ws.k[0..s−1]
+    // hold the stages, ws.next the solution, ws.error h·Σ eⱼkⱼ and, for an
+    // FSAL pair, ws.fsal = f(t+h, ws.next).
+    template <typename VecT, typename RhsEval, typename WorkspaceT>
+    static void step(double t, const VecT &y, double h, RhsEval &rhs, WorkspaceT &ws, SolverStats &stats)
+    {
+        static_assert(static_cast<int>(std::tuple_size<decltype(ws.k)>::value) >= stages, "ExplicitRK: workspace has fewer stage registers than the tableau");
+
+        stage_loop(t, y, h, rhs, ws, stats, std::make_index_sequence<static_cast<std::size_t>(stages - 1)>{});
+
+        if constexpr (!fsal)
+        {
+            combine<BRow<Tableau>>(ws.next, y, h, ws.k);
+        }
+        combine<ERow<Tableau>>(ws.error, h, ws.k);
+
+        if constexpr (fsal)
+        {
+            ws.fsal = ws.k[stages - 1];
+        }
+    }
+
+    // step() with the error norm folded in.  `norm` is an accumulator with
+    // add(y0, y1, err), add(offset, y0, y1, err) and result() (see
+    // AdaptiveDES::ErrorNormSum).  A large state is walked in blocks of
+    // `block` entries that stay in L1, and each block's solution (non-FSAL
+    // pairs), error and norm contribution are produced together: the stage
+    // registers are read from memory once instead of once per output.
+    // Returns the norm.
+    template <typename VecT, typename RhsEval, typename WorkspaceT, typename Norm>
+    static double step(double t, const VecT &y, double h, RhsEval &rhs, WorkspaceT &ws, SolverStats &stats, Norm &norm)
+    {
+        static_assert(static_cast<int>(std::tuple_size<decltype(ws.k)>::value) >= stages, "ExplicitRK: workspace has fewer stage registers than the tableau");
+
+        stage_loop(t, y, h, rhs, ws, stats, std::make_index_sequence<static_cast<std::size_t>(stages - 1)>{});
+
+        constexpr int n_fixed = VecT::SizeAtCompileTime;
+        if constexpr (n_fixed != Eigen::Dynamic && n_fixed <= block)
+        {
+            if constexpr (!fsal)
+            {
+                combine<BRow<Tableau>>(ws.next, y, h, ws.k);
+            }
+            combine<ERow<Tableau>>(ws.error, h, ws.k);
+            norm.add(y, ws.next, ws.error);
+        }
+        else
+        {
+            const Eigen::Index n = y.size();
+            for (Eigen::Index i = 0; i < n; i += block)
+            {
+                const Eigen::Index len = std::min<Eigen::Index>(block, n - i);
+                auto next = ws.next.segment(i, len);
+                auto error = ws.error.segment(i, len);
+                const auto y_blk = y.segment(i, len);
+                if constexpr (!fsal)
+                {
+                    combine_block<BRow<Tableau>>(next, y_blk, h, ws.k, i, len, std::make_index_sequence<static_cast<std::size_t>(NonZero<BRow<Tableau>>::count)>{});
+                }
+                combine_block<ERow<Tableau>>(error, h, ws.k, i, len, std::make_index_sequence<static_cast<std::size_t>(NonZero<ERow<Tableau>>::count)>{});
+                norm.add(i, y_blk, next, error);
+            }
+        }
+
+        if constexpr (fsal)
+        {
+            ws.fsal = ws.k[stages - 1];
+        }
+        return norm.result();
+    }
+
+  private:
+    // Entries per block of the fused tail: with DoPri87's nine non-zero
+    // weights, y, next, error and atol that is ~26 KiB of doubles
+    static constexpr int block = 256;
+
+    template <typename Row, typename Out, typename Base, typename K, std::size_t... Is>
+    static void combine_block(Out &out, const Base &base, double scale, const K &k, Eigen::Index i, Eigen::Index len, std::index_sequence<Is...>)
+    {
+        using NZ = NonZero<Row>;
+        out.noalias() = (base + ... + ((scale * NZ::template coeff<Is>)*k[NZ::template index<Is>].segment(i, len)));
+    }
+
+    template <typename Row, typename Out, typename K, std::size_t... Is>
+    static void combine_block(Out &out, double scale, const K &k, Eigen::Index i, Eigen::Index len, std::index_sequence<Is...>)
+    {
+        using NZ = NonZero<Row>;
+        out.noalias() = (... + ((scale * NZ::template coeff<Is>)*k[NZ::template index<Is>].segment(i, len)));
+    }
+
+    template <typename Row, typename Out, typename Base, typename K, std::size_t... Is>
+    static void combine_impl(Out &out, const Base &base, double scale, const K &k, std::index_sequence<Is...>)
+    {
+        using NZ = NonZero<Row>;
+        out.noalias() = (base + ... + ((scale * NZ::template coeff<Is>)*k[NZ::template index<Is>]));
+    }
+
+    template <typename Row, typename Out, typename K, std::size_t... Is>
+    static void combine_impl(Out &out, double scale, const K &k, std::index_sequence<Is...>)
+    {
+        using NZ = NonZero<Row>;
+        out.noalias() = (... + ((scale * NZ::template coeff<Is>)*k[NZ::template index<Is>]));
+    }
+
+    // Stage I+1 (I = 0 … s−2); the FSAL stage takes its argument from ws.next
+    template <std::size_t I, typename VecT, typename RhsEval, typename WorkspaceT>
+    static void stage(double t, const VecT &y, double h, RhsEval &rhs, WorkspaceT &ws, SolverStats &stats)
+    {
+        constexpr int S = static_cast<int>(I) + 1;
+
+        if constexpr (fsal && S == stages - 1)
+        {
+            combine<BRow<Tableau>>(ws.next, y, h, ws.k);
+            rhs(t + h, ws.next, ws.k[S]);
+        }
+        else
+        {
+            // Stage arguments are assembled in ws.stage so the RHS never sees
+            // a temporary (a heap allocation for Eigen::Dynamic)
+            combine<ARow<Tableau, S>>(ws.stage, y, h, ws.k);
+            rhs(t + Tableau::c[S] * h, ws.stage, ws.k[S]);
+        }
+        ++stats.rhs_evals;
+    }
+
+    template <typename VecT, typename RhsEval, typename WorkspaceT, std::size_t... Is>
+    static void stage_loop(double t, const VecT &y, double h, RhsEval &rhs, WorkspaceT &ws, SolverStats &stats, std::index_sequence<Is...>)
+    {
+        (stage<Is>(t, y, h, rhs, ws, stats), ...);
+    }
+};
+
+}  // namespace DES
@@ -0,0 +1,497 @@
+#pragma once
+
+/*  des_trajectory_io.hpp  –  DES namespace
+ *
+ *  Binary columnar trajectory files.
+ *
+ *  Classes:
+ *    DES::TrajectoryHeader      – 64-byte file header
+ *    DES::TrajectoryFileSink<N> – OutputSink writing through a growable mmap
+ *    DES::TrajectoryReader      – read-only mmap with zero-copy column views
+ *
+ *  Layout (writer's byte order, IEEE-754 doubles)
+ *  ──────────────────────────────────────────────
+ *      [0, 64)                      TrajectoryHeader
+ *      64 + 8·c·capacity            column c, `capacity` doubles
+ *
+ *  The header's byte_order field holds kByteOrderMark as the writer stored
+ *  it, so a reader on the other byte order can tell and swap.
+ *
+ *  Columns are ordered t, h, error, y0 … y(dim−1).  Only the first `count`
+ *  entries of each column are valid.  While a solve is running `capacity`
+ *  grows geometrically; end() compacts the file so that capacity == count.
+ *  Because every column is one contiguous block of doubles, the data can be
+ *  opened without parsing, e.g. in Python:
+ *
+ *      order = "<" if mark == (0x0102030405060708).to_bytes(8, "little") else ">"
+ *      hdr   = np.fromfile(path, dtype=header_dtype(order), count=1)[0]
+ *      data  = np.memmap(path, dtype=order + "f8", mode="r", offset=64,
+ *                        shape=(hdr["columns"], hdr["capacity"]))[:, :hdr["count"]]
+ *
+ *  (see examples/plot.py).  TrajectoryReader maps native-order files
+ *  without copying and byte-swaps the others into memory.  POSIX only
+ *  (open/mmap/msync).
+ *
+ *  Requires C++17.
+ */
+
+#include "des_output.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace DES {
+
+// ---------------------------------------------------------------------------
+// TrajectoryHeader
+// ---------------------------------------------------------------------------
+
+struct TrajectoryHeader {
+    static constexpr char kMagic[8] = {'D', 'E', 'S', 'T', 'R', 'A', 'J', '\0'};
+    static constexpr std::uint32_t kVersion = 2;
+    static constexpr std::uint64_t kByteOrderMark = 0x0102030405060708;
+    static constexpr std::size_t kMetaColumns = 3;  // t, h, error
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t header_bytes;
+    std::uint64_t dim;
+    std::uint64_t columns;   // kMetaColumns + dim
+    std::uint64_t count;     // valid rows
+    std::uint64_t capacity;    // rows reserved per column
+    std::uint64_t byte_order;  // kByteOrderMark in the writer's byte order
+    std::uint64_t reserved;
+};
+
+static_assert(sizeof(TrajectoryHeader) == 64, "TrajectoryHeader must stay 64 bytes");
+
+// Column views are the library-wide ColumnView (DES.hpp)
+using TrajectoryColumn = ColumnView;
+
+namespace detail {
+
+[[noreturn]] inline void throw_io_error(const std::string &what)
+{
+    throw std::system_error(errno, std::generic_category(), "DES: " + what);
+}
+
+template <typename T>
+[[nodiscard]] T byte_swapped(T v) noexcept
+{
+    unsigned char b[sizeof(T)];
+    std::memcpy(b, &v, sizeof(T));
+    std::reverse(b, b + sizeof(T));
+    std::memcpy(&v, b, sizeof(T));
+    return v;
+}
+
+}  // namespace detail
+
+// ---------------------------------------------------------------------------
+// TrajectoryFileSink<N>
+//
+// Each solve() truncates the file and writes a fresh trajectory.  Batches are
+// copied straight into the mapped columns and their pages are handed to the
+// kernel with msync(MS_ASYNC), so the solver never waits on the disk.  When
+// the mapping fills up, capacity doubles: the file is extended, remapped, and
+// the columns are moved to their new offsets in place.
+// ---------------------------------------------------------------------------
+
+template <int N>
+class TrajectoryFileSink : public OutputSink<N> {
+  public:
+    explicit TrajectoryFileSink(std::string path, std::size_t initial_capacity = 4096)
+        : m_path(std::move(path))
+        , m_initial_capacity(initial_capacity > 0 ? initial_capacity : 1)
+    {}
+
+    TrajectoryFileSink(const TrajectoryFileSink &) = delete;
+    TrajectoryFileSink &operator=(const TrajectoryFileSink &) = delete;
+
+    ~TrajectoryFileSink() override
+    {
+        if (m_fd >= 0)
+        {
+            try
+            {
+                end();
+            }
+            catch (...)
+            {
+                unmap();
+                ::close(m_fd);
+            }
+        }
+    }
+
+    void begin(Eigen::Index dim) override
+    {
+        if (m_fd >= 0)
+        {
+            end();
+        }
+
+        m_fd = ::open(m_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (m_fd < 0)
+        {
+            detail::throw_io_error("cannot open trajectory file " + m_path);
+        }
+
+        m_dim = static_cast<std::size_t>(dim);
+        m_columns = TrajectoryHeader::kMetaColumns + m_dim;
+        m_count = 0;
+        m_capacity = 0;
+        remap(m_initial_capacity);
+
+        TrajectoryHeader &hdr = header();
+        std::memcpy(hdr.magic, TrajectoryHeader::kMagic, sizeof hdr.magic);
+        hdr.version = TrajectoryHeader::kVersion;
+        hdr.header_bytes = sizeof(TrajectoryHeader);
+        hdr.dim = m_dim;
+        hdr.columns = m_columns;
+        hdr.count = 0;
+        hdr.capacity = m_capacity;
+        hdr.byte_order = TrajectoryHeader::kByteOrderMark;
+        hdr.reserved = 0;
+    }
+
+    void consume(const OutputBatch<N> &batch) override
+    {
+        if (m_fd < 0)
+        {
+            throw std::logic_error("DES: TrajectoryFileSink::consume() before begin()");
+        }
+        if (m_count + batch.size > m_capacity)
+        {
+            std::size_t cap = m_capacity;
+            while (cap < m_count + batch.size)
+            {
+                cap *= 2;
+            }
+            grow(cap);
+        }
+
+        const std::size_t row = m_count;
+        std::memcpy(column(0) + row, batch.t, batch.size * sizeof(double));
+        std::memcpy(column(1) + row, batch.h, batch.size * sizeof(double));
+        std::memcpy(column(2) + row, batch.error, batch.size * sizeof(double));
+        for (std::size_t i = 0; i < batch.size; ++i)
+        {
+            const Vec<N> &y = batch.y[i];
+            for (std::size_t j = 0; j < m_dim; ++j)
+            {
+                column(TrajectoryHeader::kMetaColumns + j)[row + i] = y[static_cast<Eigen::Index>(j)];
+            }
+        }
+
+        m_count += batch.size;
+        header().count = m_count;
+
+        for (std::size_t c = 0; c < m_columns; ++c)
+        {
+            flush_async(column(c) + row, batch.size * sizeof(double));
+        }
+        flush_async(m_map, sizeof(TrajectoryHeader));
+    }
+
+    // Compact to capacity == count, sync and close.
+    void end() override
+    {
+        if (m_fd < 0)
+        {
+            return;
+        }
+
+        // Columns only move towards the front, so ascending order never
+        // overwrites data that has not been moved yet.
+        for (std::size_t c = 1; c < m_columns; ++c)
+        {
+            std::memmove(m_map + offset(c, m_count), m_map + offset(c, m_capacity), m_count * sizeof(double));
+        }
+        header().capacity = m_count;
+
+        if (::msync(m_map, m_mapped, MS_SYNC) != 0)
+        {
+            detail::throw_io_error("msync failed for " + m_path);
+        }
+        unmap();
+
+        if (::ftruncate(m_fd, static_cast<off_t>(offset(m_columns, m_count))) != 0)
+        {
+            detail::throw_io_error("cannot truncate trajectory file " + m_path);
+        }
+        ::close(m_fd);
+        m_fd = -1;
+    }
+
+    [[nodiscard]] const std::string &path() const noexcept
+    {
+        return m_path;
+    }
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_count;
+    }
+
+  private:
+    std::string m_path;
+    std::size_t m_initial_capacity;
+    int m_fd = -1;
+    char *m_map = nullptr;
+    std::size_t m_mapped = 0;
+    std::size_t m_dim = 0;
+    std::size_t m_columns = 0;
+    std::size_t m_count = 0;
+    std::size_t m_capacity = 0;
+
+    [[nodiscard]] static std::size_t offset(std::size_t col, std::size_t capacity) noexcept
+    {
+        return sizeof(TrajectoryHeader) + col * capacity * sizeof(double);
+    }
+
+    [[nodiscard]] TrajectoryHeader &header() noexcept
+    {
+        return *reinterpret_cast<TrajectoryHeader *>(m_map);
+    }
+
+    [[nodiscard]] double *column(std::size_t c) noexcept
+    {
+        return reinterpret_cast<double *>(m_map + offset(c, m_capacity));
+    }
+
+    void unmap() noexcept
+    {
+        if (m_map)
+        {
+            ::munmap(m_map, m_mapped);
+            m_map = nullptr;
+            m_mapped = 0;
+        }
+    }
+
+    // Resize the file to hold `capacity` rows per column and map all of it.
+    void remap(std::size_t capacity)
+    {
+        unmap();
+        const std::size_t bytes = offset(m_columns, capacity);
+        if (::ftruncate(m_fd, static_cast<off_t>(bytes)) != 0)
+        {
+            detail::throw_io_error("cannot resize trajectory file " + m_path);
+        }
+        void *p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if (p == MAP_FAILED)
+        {
+            detail::throw_io_error("cannot map trajectory file " + m_path);
+        }
+        m_map = static_cast<char *>(p);
+        m_mapped = bytes;
+        m_capacity = capacity;
+    }
+
+    void grow(std::size_t capacity)
+    {
+        const std::size_t old = m_capacity;
+        remap(capacity);
+
+        // Columns only move towards the back; descending order keeps every
+        // source range intact until it has been copied.
+        for (std::size_t c = m_columns; c-- > 1;)
+        {
+            std::memmove(m_map + offset(c, capacity), m_map + offset(c, old), m_count * sizeof(double));
+        }
+        header().capacity = capacity;
+    }
+
+    void flush_async(const void *addr, std::size_t len) const
+    {
+        if (len == 0)
+        {
+            return;
+        }
+        static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const auto begin = reinterpret_cast<std::uintptr_t>(addr);
+        const std::uintptr_t aligned = begin & ~(static_cast<std::uintptr_t>(page) - 1);
+        ::msync(reinterpret_cast<void *>(aligned), begin + len - aligned, MS_ASYNC);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// TrajectoryReader
+//
+// A file in native byte order stays mapped and the columns point into the
+// mapping.  A file written on the other byte order is swapped once into an
+// owned buffer (count rows per column) and unmapped.
+// ---------------------------------------------------------------------------
+
+class TrajectoryReader {
+  public:
+    explicit TrajectoryReader(const std::string &path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            detail::throw_io_error("cannot open trajectory file " + path);
+        }
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            detail::throw_io_error("cannot stat trajectory file " + path);
+        }
+        m_mapped = static_cast<std::size_t>(st.st_size);
+        if (m_mapped < sizeof(TrajectoryHeader))
+        {
+            ::close(fd);
+            throw std::invalid_argument("DES: trajectory file too small: " + path);
+        }
+
+        void *p = ::mmap(nullptr, m_mapped, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+        {
+            detail::throw_io_error("cannot map trajectory file " + path);
+        }
+        m_map = static_cast<const char *>(p);
+
+        std::memcpy(&m_hdr, m_map, sizeof(TrajectoryHeader));
+        const bool swapped = m_hdr.byte_order == detail::byte_swapped(TrajectoryHeader::kByteOrderMark);
+        if (swapped)
+        {
+            m_hdr.version = detail::byte_swapped(m_hdr.version);
+            m_hdr.header_bytes = detail::byte_swapped(m_hdr.header_bytes);
+            m_hdr.dim = detail::byte_swapped(m_hdr.dim);
+            m_hdr.columns = detail::byte_swapped(m_hdr.columns);
+            m_hdr.count = detail::byte_swapped(m_hdr.count);
+            m_hdr.capacity = detail::byte_swapped(m_hdr.capacity);
+            m_hdr.byte_order = TrajectoryHeader::kByteOrderMark;
+        }
+
+        const bool valid = std::memcmp(m_hdr.magic, TrajectoryHeader::kMagic, sizeof m_hdr.magic) == 0 && m_hdr.version == TrajectoryHeader::kVersion && m_hdr.byte_order == TrajectoryHeader::kByteOrderMark && m_hdr.header_bytes == sizeof(TrajectoryHeader) && m_hdr.columns == TrajectoryHeader::kMetaColumns + m_hdr.dim && m_hdr.count <= m_hdr.capacity &&
+                           sizeof(TrajectoryHeader) + m_hdr.columns * m_hdr.capacity * sizeof(double) <= m_mapped;
+        if (!valid)
+        {
+            release();
+            throw std::invalid_argument("DES: not a valid trajectory file: " + path);
+        }
+
+        m_foreign = swapped;
+        if (swapped)
+        {
+            const auto *base = reinterpret_cast<const double *>(m_map + sizeof(TrajectoryHeader));
+            const std::size_t count = static_cast<std::size_t>(m_hdr.count);
+            m_swapped.resize(static_cast<std::size_t>(m_hdr.columns) * count);
+            for (std::size_t c = 0; c < m_hdr.columns; ++c)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    m_swapped[c * count + i] = detail::byte_swapped(base[c * m_hdr.capacity + i]);
+                }
+            }
+            m_hdr.capacity = m_hdr.count;
+            release();
+        }
+    }
+
+    TrajectoryReader(const TrajectoryReader &) = delete;
+    TrajectoryReader &operator=(const TrajectoryReader &) = delete;
+
+    TrajectoryReader(TrajectoryReader &&other) noexcept
+        : m_map(std::exchange(other.m_map, nullptr))
+        , m_mapped(std::exchange(other.m_mapped, 0))
+        , m_hdr(other.m_hdr)
+        , m_swapped(std::move(other.m_swapped))
+        , m_foreign(other.m_foreign)
+    {}
+
+    TrajectoryReader &operator=(TrajectoryReader &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            m_map = std::exchange(other.m_map, nullptr);
+            m_mapped = std::exchange(other.m_mapped, 0);
+            m_hdr = other.m_hdr;
+            m_swapped = std::move(other.m_swapped);
+            m_foreign = other.m_foreign;
+        }
+        return *this;
+    }
+
+    ~TrajectoryReader()
+    {
+        release();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return static_cast<std::size_t>(m_hdr.count);
+    }
+    [[nodiscard]] std::size_t dim() const noexcept
+    {
+        return static_cast<std::size_t>(m_hdr.dim);
+    }
+
+    // True if the file was written on the other byte order and swapped on load
+    [[nodiscard]] bool foreign_byte_order() const noexcept
+    {
+        return m_foreign;
+    }
+
+    [[nodiscard]] TrajectoryColumn t() const noexcept
+    {
+        return column(0);
+    }
+    [[nodiscard]] TrajectoryColumn h() const noexcept
+    {
+        return column(1);
+    }
+    [[nodiscard]] TrajectoryColumn error() const noexcept
+    {
+        return column(2);
+    }
+    [[nodiscard]] TrajectoryColumn y(std::size_t component) const
+    {
+        if (component >= dim())
+        {
+            throw std::out_of_range("DES: trajectory component out of range");
+        }
+        return column(TrajectoryHeader::kMetaColumns + component);
+    }
+
+  private:
+    const char *m_map = nullptr;
+    std::size_t m_mapped = 0;
+    TrajectoryHeader m_hdr{};
+    std::vector<double> m_swapped{};  // foreign byte order only
+    bool m_foreign = false;
+
+    [[nodiscard]] TrajectoryColumn column(std::size_t c) const noexcept
+    {
+        const double *base = m_map ? reinterpret_cast<const double *>(m_map + sizeof(TrajectoryHeader)) : m_swapped.data();
+        return TrajectoryColumn{base + c * m_hdr.capacity, static_cast<std::size_t>(m_hdr.count)};
+    }
+
+    void release() noexcept
+    {
+        if (m_map)
+        {
+            ::munmap(const_cast<char *>(m_map), m_mapped);
+            m_map = nullptr;
+        }
+    }
+};
+
+}  // namespace DES
@@ -0,0 +1,101 @@
+#pragma once
+
+/*  des_vmath.hpp  –  DES namespace
+ *
+ *  Vectorized exp / log / pow over contiguous runs of doubles, for batched
+ *  right-hand sides (Hill functions, Arrhenius rates across the lanes of a
+ *  BatchState) and the lane-wise step-size controller.
+ *
+ *  Every kernel is an Eigen array expression, so it runs on Eigen's packet
+ *  exp / log / pow at the SIMD width the translation unit is compiled for
+ *  and on the scalar std:: functions for the tail.
+ *
+ *  Functions
+ *  ─────────
+ *  vmath::exp(x, out, n)         out[i] = exp(x[i])
+ *  vmath::log(x, out, n)         out[i] = log(x[i])
+ *  vmath::pow(x, e, out, n)      out[i] = x[i]^e[i]  or  x[i]^e (scalar e)
+ *  vmath::exp(array) …           the same on an Eigen array expression,
+ *                                returned as a plain array (no heap for
+ *                                fixed sizes such as LaneArray<Lanes>)
+ *
+ *  out may equal x.  C++17.  Requires DES.hpp (Eigen).
+ */
+
+#include "DES.hpp"
+
+#include <cstddef>
+
+namespace DES {
+namespace vmath {
+
+namespace detail {
+
+using ConstMap = Eigen::Map<const Eigen::ArrayXd>;
+using Map = Eigen::Map<Eigen::ArrayXd>;
+
+}  // namespace detail
+
+// ---------------------------------------------------------------------------
+// Pointer kernels
+// ---------------------------------------------------------------------------
+
+inline void exp(const double *x, double *out, std::size_t n)
+{
+    detail::Map(out, static_cast<Eigen::Index>(n)) = detail::ConstMap(x, static_cast<Eigen::Index>(n)).exp();
+}
+
+inline void log(const double *x, double *out, std::size_t n)
+{
+    detail::Map(out, static_cast<Eigen::Index>(n)) = detail::ConstMap(x, static_cast<Eigen::Index>(n)).log();
+}
+
+inline void pow(const double *x, const double *e, double *out, std::size_t n)
+{
+    detail::Map(out, static_cast<Eigen::Index>(n)) = detail::ConstMap(x, static_cast<Eigen::Index>(n)).pow(detail::ConstMap(e, static_cast<Eigen::Index>(n)));
+}
+
+inline void pow(const double *x, double e, double *out, std::size_t n)
+{
+    detail::Map(out, static_cast<Eigen::Index>(n)) = detail::ConstMap(x, static_cast<Eigen::Index>(n)).pow(e);
+}
+
+// ---------------------------------------------------------------------------
+// Eigen array overloads — evaluate x, then transform it in place
+// ---------------------------------------------------------------------------
+
+template <typename Derived>
+[[nodiscard]] typename Derived::PlainObject exp(const Eigen::ArrayBase<Derived> &x)
+{
+    typename Derived::PlainObject r = x;
+    exp(r.data(), r.data(), static_cast<std::size_t>(r.size()));
+    return r;
+}
+
+template <typename Derived>
+[[nodiscard]] typename Derived::PlainObject log(const Eigen::ArrayBase<Derived> &x)
+{
+    typename Derived::PlainObject r = x;
+    log(r.data(), r.data(), static_cast<std::size_t>(r.size()));
+    return r;
+}
+
+template <typename Derived>
+[[nodiscard]] typename Derived::PlainObject pow(const Eigen::ArrayBase<Derived> &x, double e)
+{
+    typename Derived::PlainObject r = x;
+    pow(r.data(), e, r.data(), static_cast<std::size_t>(r.size()));
+    return r;
+}
+
+template <typename Derived, typename ExpDerived>
+[[nodiscard]] typename Derived::PlainObject pow(const Eigen::ArrayBase<Derived> &x, const Eigen::ArrayBase<ExpDerived> &e)
+{
+    typename Derived::PlainObject r = x;
+    const typename Derived::PlainObject ev = e;
+    pow(r.data(), ev.data(), r.data(), static_cast<std::size_t>(r.size()));
+    return r;
+}
+
+}  // namespace vmath
+}  // namespace DES
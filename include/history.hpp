@@ -93,6 +93,11 @@ class RingBuffer {
         extend();
         m_data[m_head] = entry;
     }
+
+    [[nodiscard]] std::size_t memory_bytes() const noexcept
+    {
+        return m_data.capacity() * sizeof(T);
+    }
 };
 
 template <class V, class T = double>
@@ -129,12 +134,22 @@ class CompoundRingBuffer {
     void update(T t, T h_new, const std::vector<V> &vals)
     {
         assert(vals.size() >= m_vars.size());
-        const T oldest_t = timestamp[timestamp.size() - 1];
+        update_with(t, h_new, [&vals](std::size_t k) -> const V & { return vals[k]; });
+    }
+
+    // Same as update(), but the new head entry of variable k is produced by
+    // value_of(k), so callers need not stage the values in a temporary.
+    template <class Fn>
+    void update_with(T t, T h_new, Fn &&value_of)
+    {
         bool any_ext = false;
 
         for (std::size_t k = 0; k < m_vars.size(); ++k)
         {
-            if (oldest_t < t - m_max_delays[k])
+            // The oldest entry is the left end of the interval holding
+            // t − max_delay until the next-oldest one falls out of the window
+            const std::size_t sz = m_vars[k].size();
+            if (sz > 1 && timestamp[sz - 2] <= t - m_max_delays[k])
             {
                 m_vars[k].advance();
             }
@@ -143,7 +158,7 @@ class CompoundRingBuffer {
                 m_vars[k].extend();
                 any_ext = true;
             }
-            m_vars[k][0] = vals[k];
+            m_vars[k][0] = value_of(k);
         }
 
         if (any_ext)
@@ -201,6 +216,17 @@ class CompoundRingBuffer {
         return m_max_delays;
     }
 
+    [[nodiscard]] std::size_t memory_bytes() const noexcept
+    {
+        std::size_t bytes = timestamp.memory_bytes() + h.memory_bytes();
+        bytes += m_vars.capacity() * sizeof(RingBuffer<V>) + m_max_delays.capacity() * sizeof(T);
+        for (const auto &v : m_vars)
+        {
+            bytes += v.memory_bytes();
+        }
+        return bytes;
+    }
+
     [[nodiscard]] T max_delay(std::size_t vi) const
     {
         return m_max_delays.at(vi);
@@ -251,17 +277,24 @@ class History {
     void save(T time, const std::vector<V> &y1, const std::vector<V> &k1)
     {
         assert(y1.size() >= m_n && k1.size() >= m_n);
-        std::vector<std::array<V, 2>> entries(m_n);
-        for (std::size_t i = 0; i < m_n; ++i)
-        {
-            entries[i] = {y1[i], k1[i]};
-        }
-        _history.update(time, T{}, entries);
+        save(time, y1.data(), k1.data());
+    }
+
+    // y1 and k1 point to at least size() contiguous values.  Does not
+    // allocate once the ring buffers have grown to cover the delay window.
+    void save(T time, const V *y1, const V *k1)
+    {
+        _history.update_with(time, T{}, [y1, k1](std::size_t i) { return std::array<V, 2>{y1[i], k1[i]}; });
     }
 
     void set_initial_derivatives(const std::vector<V> &dydt0)
     {
         assert(dydt0.size() >= m_n);
+        set_initial_derivatives(dydt0.data());
+    }
+
+    void set_initial_derivatives(const V *dydt0)
+    {
         for (std::size_t i = 0; i < m_n; ++i)
         {
             for (std::size_t j = 0; j < _history[i].size(); ++j)
@@ -291,6 +324,13 @@ class History {
         return _history.max_delays();
     }
 
+    // Ring buffers, prehistory callables and lookup cache (not the state
+    // captured inside the prehistory callables)
+    [[nodiscard]] std::size_t memory_bytes() const noexcept
+    {
+        return _history.memory_bytes() + m_prehistory.capacity() * sizeof(std::function<V(T)>) + m_cache.capacity() * sizeof(std::size_t);
+    }
+
     [[nodiscard]] V at_time(T t, std::size_t var) const
     {
         if (t < m_t0)